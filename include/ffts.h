@@ -75,6 +75,75 @@ typedef struct _ffts_plan_t ffts_plan_t;
 FFTS_API ffts_plan_t*
 ffts_init_1d(size_t N, int sign);
 
+/* Planner flags, may be combined with bitwise or */
+
+/* Return from init without waiting for the code generator. The plan
+   executes the portable static transform until the generated code is
+   ready and then switches to it, results are the same either way. */
+#define FFTS_FLAG_BACKGROUND_JIT 0x00000001u
+
+/* Select the engine, either the run-time code generator or the portable
+   static transform. Without these the FFTS_ENGINE environment variable
+   ("jit" or "static") decides, defaulting to the code generator. Plans
+   fall back to the static engine when executable memory is refused.
+   Complex transforms of 32 to 512 points run precompiled straight-line
+   code unless one of these is given. */
+#define FFTS_FLAG_ENGINE_JIT     0x00000002u
+#define FFTS_FLAG_ENGINE_STATIC  0x00000004u
+
+/* Time the available configurations of each power of two size on this
+   machine and plan with the fastest. An engine flag given with it is
+   kept and only the other choices are timed. The choice is remembered
+   for the process, see ffts_export_wisdom. */
+#define FFTS_FLAG_MEASURE        0x00000008u
+
+/* Software prefetch of the strided leaf inputs, the distance is given in
+   64 byte cache lines (1-255). By default large transforms prefetch with
+   the distance chosen at build time (FFTS_PREFETCH_DISTANCE). */
+#define FFTS_FLAG_NO_PREFETCH    0x00000010u
+#define FFTS_FLAG_PREFETCH(lines) ((((unsigned int) (lines)) & 0xffu) << 8)
+
+/* Write the output of the last pass with non-temporal stores, bypassing
+   the cache. By default this is done when the output is much larger than
+   the last level cache. Plans split by the six-step algorithm stream
+   their final transpose, never their cache sized sub-transforms. */
+#define FFTS_FLAG_STREAM         0x00000020u
+#define FFTS_FLAG_NO_STREAM      0x00000040u
+
+/* Compute the twiddle factors of the largest passes from two tables of
+   about sqrt(N) entries instead of reading them from a table the size of
+   the transform, saving memory and bandwidth. Such plans use the static
+   engine. By default this is done when the table would not fit in the
+   last level cache, which only happens in plans that are not split by
+   the six-step algorithm: plans for both directions (sign 0) and those
+   FFTS_FLAG_MEASURE keeps whole. Split plans have small tables anyway. */
+#define FFTS_FLAG_TWIDDLES_COMPUTED 0x00000080u
+#define FFTS_FLAG_TWIDDLES_TABLE    0x00010000u
+
+/* Build the tables of large plans on one thread per processor. The
+   tables are the same as those built on a single thread. */
+#define FFTS_FLAG_PARALLEL_PLAN     0x00020000u
+
+/* Execute large transforms on one thread per processor, from a pool of
+   threads shared by all plans. Plans split by the six-step algorithm
+   share the blocks of each of its passes among the threads, the others
+   use the static engine. The results are the same as on a single thread.
+   A plan executed by several threads at once runs on the calling threads
+   only. */
+#define FFTS_FLAG_PARALLEL_EXECUTE  0x00040000u
+
+/* Let a forward plan write the spectrum in an order of its own choosing,
+   and an inverse plan read it in that order, for convolution and
+   correlation where the spectra are only multiplied pointwise. The order
+   is the same for the forward and inverse plans of one size created with
+   this flag, and natural where it costs nothing, as in plans that fit in
+   the cache and plans for both directions (sign 0). Large plans save a
+   transpose of the data per transform. */
+#define FFTS_FLAG_SCRAMBLED         0x00080000u
+
+FFTS_API ffts_plan_t*
+ffts_init_1d_flags(size_t N, int sign, unsigned int flags);
+
 FFTS_API ffts_plan_t*
 ffts_init_2d(size_t N1, size_t N2, int sign);
 
@@ -100,9 +169,141 @@ ffts_init_nd_real(int rank, size_t *Ns, int sign);
 FFTS_API void
 ffts_execute(ffts_plan_t *p, const void *input, void *output);
 
+/* Plans of power of two sizes created by ffts_init_1d or ffts_init_1d_flags
+   with sign 0 can run in both directions from one set of tables and code.
+   Executes such a plan in the direction of sign (FFTS_FORWARD or
+   FFTS_BACKWARD), ffts_execute runs it forward. Returns -1 without
+   executing for other plans. */
+FFTS_API int
+ffts_execute_dir(ffts_plan_t *p, const void *input, void *output, int sign);
+
+/* The power of two sizes up to FFTS_SMALL_MAX_N have straight-line code
+   needing no tables. ffts_execute_small runs it without a plan, in the
+   direction of sign, on buffers aligned like those of ffts_execute.
+   Returns -1 without executing for other sizes. */
+#define FFTS_SMALL_MAX_N 512
+
+FFTS_API int
+ffts_execute_small(size_t N, int sign, const void *input, void *output);
+
+/* The straight-line code of each size and direction, for callers that know
+   the size when compiling and can skip the switch of ffts_execute_small.
+   p must be NULL. */
+FFTS_API void
+ffts_small_2_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_forward4_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_backward4_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_forward8_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_backward8_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_forward16_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_backward16_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_forward32_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_backward32_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_forward64_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_backward64_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_forward128_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_backward128_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_forward256_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_backward256_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_forward512_32f(ffts_plan_t *p, const void *input, void *output);
+
+FFTS_API void
+ffts_small_backward512_32f(ffts_plan_t *p, const void *input, void *output);
+
+/* Callbacks fusing the preparation of the input and the use of the output
+   into the first and last passes of a transform, saving a pass over
+   memory each.
+
+   The load callback writes the input elements index to index + count - 1
+   to dst as interleaved complex floats, reading them from the input given
+   to ffts_execute in any format (int16 samples, or with a window or gain
+   applied). The store callback is given the output elements index to
+   index + count - 1 once they are final and still in cache, and may modify
+   them in place (scaling, conjugation) or read them into another buffer
+   (magnitudes). Both are called for blocks of a few cache lines, in no
+   particular order, and from several threads at once for plans created
+   with FFTS_FLAG_PARALLEL_EXECUTE. */
+typedef void (*ffts_load_func_t)(float *dst, const void *input, size_t index,
+                                 size_t count, void *userdata);
+
+typedef void (*ffts_store_func_t)(float *data, size_t index, size_t count,
+                                  void *userdata);
+
+/* Sets the callbacks of a plan of a power of two size created by
+   ffts_init_1d or ffts_init_1d_flags, either may be NULL. Plans using the
+   code generator switch to the static engine, whose transform takes up
+   to about a quarter longer at some sizes. With callbacks as light as a
+   scale such plans can be faster with separate passes over the input and
+   output. Plans split by the six-step algorithm call them from their
+   transposes. Returns -1 for other kinds of plans. */
+FFTS_API int
+ffts_set_callbacks(ffts_plan_t *p, ffts_load_func_t load, ffts_store_func_t store,
+                   void *userdata);
+
+/* Multiplies the output of the transforms of a plan by scale, for example
+   1/N to normalize an inverse transform or 1/sqrt(N) for a unitary one,
+   instead of a separate pass over the output. The factor is folded into
+   the tables of real, multi-dimensional and large plans, and into the
+   last pass of the others, the straight-line code of 32 to 512 points
+   included. Plans using the code generator switch to the static engine
+   for it, at the cost given for ffts_set_callbacks. Transforms of fewer
+   than 32 points scale their output in a loop of its own while in cache.
+   Plans created with sign 0 are scaled in both directions. A later call
+   replaces the factor, 1 removes it. Returns -1 if the plan is left
+   unscaled. */
+FFTS_API int
+ffts_set_scale(ffts_plan_t *p, float scale);
+
 FFTS_API void
 ffts_free(ffts_plan_t *p);
 
+/* The measurements of FFTS_FLAG_MEASURE can be saved as a string and
+   restored in a later run on the same machine.
+
+   ffts_export_wisdom writes the lines that fit in size bytes (including
+   the terminating null) into buffer and returns the length of the
+   complete string, so a return of size or more means it was cut short.
+   ffts_import_wisdom returns zero if the whole string was accepted.
+*/
+FFTS_API size_t
+ffts_export_wisdom(char *buffer, size_t size);
+
+FFTS_API int
+ffts_import_wisdom(const char *wisdom);
+
+FFTS_API void
+ffts_forget_wisdom(void);
+
 #ifdef __cplusplus
 }
 #endif
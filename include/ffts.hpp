@@ -0,0 +1,239 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/* C++ interface of the transforms whose size is known at compile time.
+
+   ffts::plan<N, Direction, Precision> runs the straight-line code of the
+   power of two sizes up to FFTS_SMALL_MAX_N with a direct call of its
+   ffts_small_* entry point and no plan. Other sizes share one plan per
+   instantiation and thread, created on first use. A plan of the C
+   interface is read-only during ffts_execute except for its scratch
+   buffers (those of the six-step and chirp-z transforms), so one
+   plan shared by all threads would need a lock around each transform.
+
+   ffts::unique_plan owns a plan of the C interface and frees it, it can
+   be moved but not copied. */
+
+#ifndef FFTS_HPP
+#define FFTS_HPP
+
+#if defined (_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#if __cplusplus < 201703L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#error "ffts.hpp needs C++17"
+#endif
+
+#include "ffts.h"
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+namespace ffts {
+
+enum class direction : int {
+    forward = FFTS_FORWARD,
+    backward = FFTS_BACKWARD
+};
+
+class unique_plan {
+public:
+    unique_plan() noexcept = default;
+
+    explicit unique_plan(ffts_plan_t *p) noexcept : p_(p) {}
+
+    unique_plan(unique_plan &&other) noexcept : p_(other.release()) {}
+
+    unique_plan &operator=(unique_plan &&other) noexcept
+    {
+        reset(other.release());
+        return *this;
+    }
+
+    unique_plan(const unique_plan&) = delete;
+    unique_plan &operator=(const unique_plan&) = delete;
+
+    ~unique_plan()
+    {
+        ffts_free(p_);
+    }
+
+    ffts_plan_t *get() const noexcept
+    {
+        return p_;
+    }
+
+    ffts_plan_t *release() noexcept
+    {
+        return std::exchange(p_, nullptr);
+    }
+
+    void reset(ffts_plan_t *p = nullptr) noexcept
+    {
+        ffts_free(std::exchange(p_, p));
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return p_ != nullptr;
+    }
+
+    void execute(const void *input, void *output) const noexcept
+    {
+        ffts_execute(p_, input, output);
+    }
+
+private:
+    ffts_plan_t *p_ = nullptr;
+};
+
+template<std::size_t N,
+         direction Direction = direction::forward,
+         typename Precision = float>
+class plan {
+    static_assert(std::is_same<Precision, float>::value,
+        "only single precision transforms are implemented");
+    static_assert(N >= 2, "transforms need at least two points");
+
+public:
+    using value_type = std::complex<Precision>;
+
+    static constexpr std::size_t size = N;
+
+    /* the power of two sizes run straight-line code without a plan */
+    static constexpr bool is_small = !(N & (N - 1)) && N <= FFTS_SMALL_MAX_N;
+
+    /* builds the plan of the calling thread, throws std::bad_alloc if
+       it can't be created */
+    plan()
+    {
+        if constexpr (!is_small) {
+            shared();
+        }
+    }
+
+    /* the buffers are aligned to 16 bytes, as for ffts_execute */
+    void execute(const value_type *input, value_type *output) const noexcept(is_small)
+    {
+        if constexpr (is_small) {
+            constexpr auto transform = small_transform();
+
+            transform(nullptr, input, output);
+        } else {
+            shared().execute(input, output);
+        }
+    }
+
+    void execute(const std::array<value_type, N> &input,
+                 std::array<value_type, N> &output) const noexcept(is_small)
+    {
+        execute(input.data(), output.data());
+    }
+
+#ifdef __cpp_lib_span
+    void execute(std::span<const value_type, N> input,
+                 std::span<value_type, N> output) const noexcept(is_small)
+    {
+        execute(input.data(), output.data());
+    }
+#endif
+
+    void operator()(const value_type *input, value_type *output) const noexcept(is_small)
+    {
+        execute(input, output);
+    }
+
+private:
+    using small_transform_t = void (*)(ffts_plan_t*, const void*, void*);
+
+    /* the straight-line code of this size and direction, chosen here
+       rather than by the switch of ffts_execute_small */
+    static constexpr small_transform_t small_transform()
+    {
+        constexpr bool forward = Direction == direction::forward;
+
+        if constexpr (N == 2) {
+            return ffts_small_2_32f;
+        } else if constexpr (N == 4) {
+            return forward ? ffts_small_forward4_32f : ffts_small_backward4_32f;
+        } else if constexpr (N == 8) {
+            return forward ? ffts_small_forward8_32f : ffts_small_backward8_32f;
+        } else if constexpr (N == 16) {
+            return forward ? ffts_small_forward16_32f : ffts_small_backward16_32f;
+        } else if constexpr (N == 32) {
+            return forward ? ffts_small_forward32_32f : ffts_small_backward32_32f;
+        } else if constexpr (N == 64) {
+            return forward ? ffts_small_forward64_32f : ffts_small_backward64_32f;
+        } else if constexpr (N == 128) {
+            return forward ? ffts_small_forward128_32f : ffts_small_backward128_32f;
+        } else if constexpr (N == 256) {
+            return forward ? ffts_small_forward256_32f : ffts_small_backward256_32f;
+        } else {
+            static_assert(N == 512 && FFTS_SMALL_MAX_N == 512,
+                "a straight-line size without its entry point");
+            return forward ? ffts_small_forward512_32f : ffts_small_backward512_32f;
+        }
+    }
+
+    /* per thread, as the plans of some sizes keep scratch buffers that
+       concurrent calls of ffts_execute would share */
+    static const unique_plan &shared()
+    {
+        thread_local const unique_plan p = create();
+        return p;
+    }
+
+    static unique_plan create()
+    {
+        unique_plan p(ffts_init_1d(N, static_cast<int>(Direction)));
+
+        if (!p) {
+            throw std::bad_alloc();
+        }
+
+        return p;
+    }
+};
+
+} // namespace ffts
+
+#endif /* FFTS_HPP */
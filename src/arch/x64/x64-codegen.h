@@ -1173,6 +1173,10 @@ typedef union {
 
 #define x64_sse_movsldup_reg_reg(inst,dreg,reg) emit_sse_reg_reg((inst), (dreg), (reg), 0xf3, 0x0f, 0x12)
 
+#define x64_sse_movshdup_reg_membase(inst,dreg,basereg,disp) emit_sse_reg_membase((inst), (dreg), (basereg), (disp), 0xf3, 0x0f, 0x16)
+
+#define x64_sse_movsldup_reg_membase(inst,dreg,basereg,disp) emit_sse_reg_membase((inst), (dreg), (basereg), (disp), 0xf3, 0x0f, 0x12)
+
 
 #define x64_sse_pshufhw_reg_reg_imm(inst,dreg,reg,imm) emit_sse_reg_reg_imm((inst), (dreg), (reg), 0xf3, 0x0f, 0x70, (imm))
 
@@ -1491,6 +1495,18 @@ typedef union {
 #define x64_sse_prefetch_reg_membase(inst, arg, basereg, disp) \
 	emit_sse_reg_membase_op2((inst), (arg), (basereg), (disp), 0x0f, 0x18)
 
+#define x64_sse_prefetch_reg_memindex(inst, arg, basereg, disp, indexreg, shift) \
+	emit_sse_reg_memindex_op2((inst), (arg), (basereg), (disp), (indexreg), (shift), 0x0f, 0x18)
+
+#define x64_sse_sfence(inst) \
+	do { \
+		x64_codegen_pre(inst); \
+		*(inst)++ = (unsigned char)0x0f; \
+		*(inst)++ = (unsigned char)0xae; \
+		*(inst)++ = (unsigned char)0xf8; \
+		x64_codegen_post(inst); \
+	} while (0)
+
 #define x64_sse_movdqa_membase_reg(inst, basereg, disp, reg) \
 	emit_sse_membase_reg((inst), (basereg), (disp), (reg), 0x66, 0x0f, 0x7f)
 
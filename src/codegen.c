@@ -32,6 +32,7 @@
 */
 
 #include "codegen.h"
+#include "ffts_vmem.h"
 #include "macros.h"
 
 #ifdef __arm__
@@ -67,6 +68,58 @@ typedef uint8_t insns_t;
 #include <unistd.h>
 #endif
 
+#ifndef __arm__
+/* The X4 and X8 butterfly kernels do not depend on the size of the
+   transform and take the sign from XMM3, so they are generated once
+   per process into a read-only page called from every plan */
+#define FFTS_KERNEL_PAGE_SIZE 4096
+
+struct ffts_kernels {
+    insns_t *x4_addr;
+    insns_t *x8_addr;
+    insns_t *x8_stream_addr;
+};
+
+static const struct ffts_kernels*
+ffts_get_kernels(void)
+{
+    static void *volatile kernels;
+    struct ffts_kernels *k;
+    insns_t *code, *fp;
+    ptrdiff_t exec_offset;
+
+    if (kernels) {
+        return (const struct ffts_kernels*) kernels;
+    }
+
+    code = (insns_t*) ffts_vmem_code_alloc(FFTS_KERNEL_PAGE_SIZE);
+    if (!code) {
+        return NULL;
+    }
+
+    /* the header is written through the writable view as well */
+    k = (struct ffts_kernels*) ffts_vmem_code_writable(code);
+    exec_offset = code - (insns_t*) k;
+
+    fp = (insns_t*) &k[1];
+    k->x4_addr = generate_size4_base_case(&fp, FFTS_FORWARD) + exec_offset;
+    k->x8_addr = generate_size8_base_case(&fp, FFTS_FORWARD) + exec_offset;
+    k->x8_stream_addr = generate_size8_stream_case(&fp) + exec_offset;
+
+    if (ffts_vmem_code_commit(code, FFTS_KERNEL_PAGE_SIZE)) {
+        ffts_vmem_code_free(code, FFTS_KERNEL_PAGE_SIZE);
+        return NULL;
+    }
+
+    /* keep the page of the thread that got there first */
+    if (!ffts_atomic_cas_ptr(&kernels, NULL, code)) {
+        ffts_vmem_code_free(code, FFTS_KERNEL_PAGE_SIZE);
+    }
+
+    return (const struct ffts_kernels*) kernels;
+}
+#endif
+
 static int ffts_tree_count(int N, int leaf_N, int offset)
 {
     int count;
@@ -102,6 +155,85 @@ static void ffts_elaborate_tree(size_t **p, int N, int leaf_N, int offset)
     (*p) += 2;
 }
 
+#ifdef HAVE_SSE
+const void*
+ffts_get_constants(int sign)
+{
+    return (sign < 0) ? (const void*) sse_constants : (const void*) sse_constants_inv;
+}
+#endif
+
+#ifndef __arm__
+/* Upper bounds of the code in bytes, each at least twice the largest
+   possible one. The head (prologue, leaves and the setup of the passes)
+   and the tail (fence, real split step and epilogue) are at most 1743
+   and 350 bytes in any plan. A pass call is at most 27 bytes: two moves
+   of an immediate, the move of the kernel address and a call through
+   RAX. A call of a subroutine is 5 bytes, and moving the output before a
+   call adds at most 7 bytes, or 10 with the shift of the size. So a
+   subtransform call or a symbol of a rule is at most 37 bytes. A
+   subroutine aligns by up to 15 bytes, makes six calls and returns, at
+   most 238 bytes, and a rule adds 23 bytes to its symbols. */
+#define FFTS_CODE_HEAD_SIZE       3584
+#define FFTS_CODE_TAIL_SIZE       768
+#define FFTS_CODE_SUBROUTINE_SIZE 512
+#define FFTS_CODE_CALL_SIZE       64
+
+/* size bytes of code fit at fp, leaving reserve bytes for the code that
+   follows. Checked before each part is written to the block, which may
+   be shared with other plans */
+static int
+ffts_code_fits(const ffts_plan_t *p, const insns_t *base, const insns_t *fp,
+               size_t size, size_t reserve)
+{
+    return (size_t) (fp - base) + size + reserve <= p->transform_size;
+}
+
+/* bound of the rules of a grammar and of the sequence calling them, a
+   rule costing one call more than its symbols */
+static size_t
+ffts_grammar_code_size(const seq_grammar_t *grammar)
+{
+    const seq_rule_t *rule;
+    const sym_t *s;
+    size_t calls = 0;
+
+    for (s = grammar->G.ss; s; s = s->pNext) {
+        calls++;
+    }
+
+    for (rule = grammar->G.pNext; rule; rule = rule->pNext) {
+        for (s = rule->ss; s; s = s->pNext) {
+            calls++;
+        }
+
+        calls++;
+    }
+
+    return FFTS_CODE_CALL_SIZE * calls;
+}
+#endif
+
+size_t ffts_generate_func_code_size(const ffts_plan_t *p, size_t N, size_t leaf_N)
+{
+#ifdef __arm__
+    (void) p;
+    (void) leaf_N;
+    return (N < 8192) ? 8192 : N;
+#else
+    if (N > FFTS_STRAIGHT_LINE_MAX_N || (p->flags & FFTS_INTERNAL_COMPACT)) {
+        /* one subroutine per size, each calling the smaller ones */
+        return FFTS_CODE_HEAD_SIZE + FFTS_CODE_TAIL_SIZE +
+            FFTS_CODE_SUBROUTINE_SIZE * ffts_ctzl(N);
+    }
+
+    /* one call per subtransform, the rules of the grammar only shorten
+       them */
+    return FFTS_CODE_HEAD_SIZE + FFTS_CODE_TAIL_SIZE +
+        FFTS_CODE_CALL_SIZE * ffts_tree_count((int) N, (int) leaf_N, 0);
+#endif
+}
+
 transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N, int sign)
 {
     uint32_t offsets[8] = {0, 4*N, 2*N, 6*N, N, 5*N, 7*N, 3*N};
@@ -112,7 +244,9 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
     int32_t pLUT = 0;
 
     insns_t  *fp;
+    insns_t  *base;
     insns_t  *start;
+    ptrdiff_t exec_offset;
     insns_t  *x_4_addr;
     insns_t  *x_8_addr;
     uint32_t  loop_count;
@@ -123,14 +257,35 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
     size_t   *ps;
     size_t   *pps;
 
+    transform_func_t result = NULL;
+
+#ifndef __arm__
+    const struct ffts_kernels *kernels;
+    insns_t  *x_8_last_addr;
+    insns_t  *subs[8 * sizeof(size_t)];
+    seq_grammar_t grammar;
+    seq_rule_t *rule;
+    int       compact;
+    int       use_grammar = 0;
+    size_t    reserve;
+
+    /* large transforms call their subtransforms through one subroutine
+       per size, keeping the code size O(log N) */
+    compact = (N > FFTS_STRAIGHT_LINE_MAX_N) ||
+        (p->flags & FFTS_INTERNAL_COMPACT);
+    count = compact ? 1 : ffts_tree_count(N, leaf_N, 0) + 1;
+#else
     count = ffts_tree_count(N, leaf_N, 0) + 1;
+#endif
 
     ps = pps = malloc(2 * count * sizeof(*ps));
     if (!ps) {
         return NULL;
     }
 
-    ffts_elaborate_tree(&pps, N, leaf_N, 0);
+    if (count > 1) {
+        ffts_elaborate_tree(&pps, N, leaf_N, 0);
+    }
 
     pps[0] = 0;
     pps[1] = 0;
@@ -138,18 +293,83 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
     pps = ps;
 
 #ifdef HAVE_SSE
-    if (sign < 0) {
-        p->constants = (const void*) sse_constants;
-    } else {
-        p->constants = (const void*) sse_constants_inv;
-    }
+    p->constants = ffts_get_constants(sign);
 #endif
 
-    fp = (insns_t*) p->transform_base;
+    /* code is written through the writable view of the block */
+    fp = base = (insns_t*) ffts_vmem_code_writable(p->transform_base);
+    exec_offset = (insns_t*) p->transform_base - fp;
 
+#ifdef __arm__
     /* generate base cases */
     x_4_addr = generate_size4_base_case(&fp, sign);
     x_8_addr = generate_size8_base_case(&fp, sign);
+#else
+    kernels = ffts_get_kernels();
+    if (!kernels) {
+        free(ps);
+        return NULL;
+    }
+
+    x_4_addr = kernels->x4_addr;
+    x_8_addr = kernels->x8_addr;
+
+    /* the last pass writes the output of a transform much larger than the
+       cache, don't let it evict the data still to be read */
+    x_8_last_addr = (p->flags & FFTS_INTERNAL_STREAM) ?
+        kernels->x8_stream_addr : x_8_addr;
+#endif
+
+#ifndef __arm__
+    /* what ffts_generate_func_code_size counted beyond the calls */
+    reserve = FFTS_CODE_HEAD_SIZE + FFTS_CODE_TAIL_SIZE;
+
+    if (compact) {
+        size_t m;
+
+        /* the body is one more subroutine */
+        reserve += FFTS_CODE_SUBROUTINE_SIZE;
+
+        for (m = 8 * leaf_N; m <= N/4; m <<= 1) {
+            if (!ffts_code_fits(p, base, fp, FFTS_CODE_SUBROUTINE_SIZE, reserve)) {
+                goto cleanup;
+            }
+
+            subs[ffts_ctzl(m)] = generate_subtransform(
+                &fp, p, m, leaf_N, x_4_addr, x_8_addr, subs);
+        }
+    } else if (count > 1) {
+        /* the calls repeat at other offsets, those found by the grammar
+           become subroutines */
+        seq_grammar_init(&grammar);
+
+        for (pps = ps; pps[0]; pps += 2) {
+            if (seq_append(&grammar, (int) pps[0], (int) pps[1])) {
+                break;
+            }
+        }
+
+        pps = ps;
+
+        if (!grammar.error) {
+            seq_enforce_uniqueness(&grammar);
+            seq_merge_small_rules(&grammar, FFTS_SEQ_MERGE_SYMBOLS);
+        }
+
+        /* without repeats the plain calls are shorter, and they always
+           fit. Rules are only written if they fit as a whole */
+        if (!grammar.error && grammar.G.pNext && ffts_code_fits(p, base, fp,
+                ffts_grammar_code_size(&grammar), reserve)) {
+            for (rule = grammar.G.pNext; rule; rule = rule->pNext) {
+                generate_rule(&fp, p, rule, leaf_N, x_4_addr, x_8_addr);
+            }
+
+            use_grammar = 1;
+        } else {
+            seq_grammar_free(&grammar);
+        }
+    }
+#endif
 
 #ifdef __arm__
     start = generate_prologue(&fp, p);
@@ -193,30 +413,36 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
 #endif
 #else
     /* generate functions */
+    reserve -= FFTS_CODE_HEAD_SIZE;
+    if (!ffts_code_fits(p, base, fp, FFTS_CODE_HEAD_SIZE, reserve)) {
+        goto cleanup;
+    }
+
     start = generate_prologue(&fp, p);
 
     loop_count = 4 * p->i0;
     generate_leaf_init(&fp, loop_count);
 
     if (ffts_ctzl(N) & 1) {
-        generate_leaf_ee(&fp, offsets, p->i1 ? 6 : 0);
+        generate_leaf_ee(&fp, offsets, p->i1 ? 6 : 0, p->prefetch_distance);
 
         if (p->i1) {
             loop_count += 4 * p->i1;
-            generate_leaf_oo(&fp, loop_count, offsets_o, 7);
+            generate_leaf_oo(&fp, loop_count, offsets_o, 7, p->prefetch_distance);
         }
 
         loop_count += 4;
         generate_leaf_oe(&fp, offsets_o);
     } else {
-        generate_leaf_ee(&fp, offsets, N >= 256 ? 2 : 8);
+        generate_leaf_ee(&fp, offsets, N >= 256 ? 2 : 8, p->prefetch_distance);
 
         loop_count += 4;
         generate_leaf_eo(&fp, offsets);
 
         if (p->i1) {
             loop_count += 4 * p->i1;
-            generate_leaf_oo(&fp, loop_count, offsets_o, N >= 256 ? 4 : 7);
+            generate_leaf_oo(&fp, loop_count, offsets_o, N >= 256 ? 4 : 7,
+                p->prefetch_distance);
         }
     }
 
@@ -233,16 +459,36 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
         ffts_align_mem16(&fp, 9);
 #endif
 
-        generate_leaf_ee(&fp, offsets_oe, 0);
+        generate_leaf_ee(&fp, offsets_oe, 0, p->prefetch_distance);
     }
 
     generate_transform_init(&fp);
 
+    if (compact) {
+        reserve -= FFTS_CODE_SUBROUTINE_SIZE;
+        if (!ffts_code_fits(p, base, fp, FFTS_CODE_SUBROUTINE_SIZE, reserve)) {
+            goto cleanup;
+        }
+
+        generate_subtransform_body(&fp, p, N, leaf_N,
+            x_4_addr, x_8_addr, x_8_last_addr, subs);
+    }
+
+    /* its calls were counted with the rules */
+    if (use_grammar) {
+        pAddr = generate_rule_body(&fp, p, grammar.G.ss, leaf_N,
+            x_4_addr, x_8_addr, x_8_last_addr);
+    }
+
     /* generate subtransform calls */
     count = 2;
-    while (pps[0]) {
+    while (!use_grammar && pps[0]) {
         size_t ws_is;
 
+        if (!ffts_code_fits(p, base, fp, FFTS_CODE_CALL_SIZE, reserve)) {
+            goto cleanup;
+        }
+
         if (!pN) {
 #ifdef _M_X64
             x86_mov_reg_imm(fp, X86_EBX, pps[0]);
@@ -290,9 +536,11 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
         }
 
         if (pps[0] == 2 * leaf_N) {
-            x64_call_code(fp, x_4_addr);
+            generate_call(&fp, x_4_addr);
+        } else if (!pps[2]) {
+            generate_call(&fp, x_8_last_addr);
         } else {
-            x64_call_code(fp, x_8_addr);
+            generate_call(&fp, x_8_addr);
         }
 
         pAddr = 4 * pps[1];
@@ -305,6 +553,21 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
         count += 4;
         pps += 2;
     }
+
+    if (!ffts_code_fits(p, base, fp, FFTS_CODE_TAIL_SIZE, 0)) {
+        goto cleanup;
+    }
+
+    /* order the non-temporal stores before returning */
+    if (p->flags & FFTS_INTERNAL_STREAM) {
+        x64_sse_sfence(fp);
+    }
+
+#ifdef HAVE_SSE3
+    if (p->flags & FFTS_INTERNAL_REAL_SPLIT) {
+        generate_real_split(&fp, p, N, pAddr);
+    }
+#endif
 #endif
 
 #ifdef __arm__
@@ -596,8 +859,6 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
 
     //fprintf(stderr, "size of transform %u = %d\n", N, (fp - x_8_addr) * sizeof(*fp));
 
-    free(ps);
-
 #if defined(_MSC_VER)
 #pragma warning(push)
 
@@ -605,9 +866,23 @@ transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N
 #pragma warning(disable : 4055)
 #endif
 
-    return (transform_func_t) start;
+    result = (transform_func_t) (start + exec_offset);
 
 #if defined(_MSC_VER)
 #pragma warning(pop)
 #endif
+
+#ifndef __arm__
+cleanup:
+    if (use_grammar) {
+        seq_grammar_free(&grammar);
+    }
+
+    if (!result) {
+        LOG("ffts_generate_func_code: code would exceed its buffer\n");
+    }
+#endif
+
+    free(ps);
+    return result;
 }
\ No newline at end of file
@@ -41,6 +41,25 @@
 #include "ffts.h"
 #include "ffts_internal.h"
 
+/* largest size generated as straight-line subtransform calls */
+#define FFTS_STRAIGHT_LINE_MAX_N 2048
+
+/* rules of the straight-line calls with at most this many symbols are
+   expanded in place instead of being called */
+#ifndef FFTS_SEQ_MERGE_SYMBOLS
+#define FFTS_SEQ_MERGE_SYMBOLS 0
+#endif
+
+/* bytes of code generated for a plan at most, ffts_generate_func_code
+   fails rather than exceed them */
+size_t ffts_generate_func_code_size(const ffts_plan_t *p, size_t N, size_t leaf_N);
+
 transform_func_t ffts_generate_func_code(ffts_plan_t *p, size_t N, size_t leaf_N, int sign);
 
+#ifdef HAVE_SSE
+/* the only part of the generated code depending on the sign, read through
+   the plan on each execution */
+const void *ffts_get_constants(int sign);
+#endif
+
 #endif /* FFTS_CODEGEN_H */
@@ -36,6 +36,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define TARGET_AMD64
 #include "arch/x64/x64-codegen.h"
+#include "sequitur.h"
 
 #include <assert.h>
 
@@ -253,6 +254,40 @@ generate_transform_init(insns_t **fp)
 #endif
 }
 
+/* The twiddle factors are stored as pairs of complex values [re0, im0,
+   re1, im1] without the sign of the transform, these load the duplicated
+   real parts and the duplicated imaginary parts with the sign from XMM3 */
+static FFTS_INLINE void
+generate_lut_load_re(insns_t **fp, int reg, int basereg, int disp)
+{
+    insns_t *ins = *fp;
+
+#ifdef HAVE_SSE3
+    x64_sse_movsldup_reg_membase(ins, reg, basereg, disp);
+#else
+    x64_sse_movaps_reg_membase(ins, reg, basereg, disp);
+    x64_sse_shufps_reg_reg_imm(ins, reg, reg, 0xA0);
+#endif
+
+    *fp = ins;
+}
+
+static FFTS_INLINE void
+generate_lut_load_im(insns_t **fp, int reg, int basereg, int disp)
+{
+    insns_t *ins = *fp;
+
+#ifdef HAVE_SSE3
+    x64_sse_movshdup_reg_membase(ins, reg, basereg, disp);
+#else
+    x64_sse_movaps_reg_membase(ins, reg, basereg, disp);
+    x64_sse_shufps_reg_reg_imm(ins, reg, reg, 0xF5);
+#endif
+    x64_sse_xorps_reg_reg(ins, reg, X64_XMM3);
+
+    *fp = ins;
+}
+
 static FFTS_INLINE insns_t*
 generate_size4_base_case(insns_t **fp, int sign)
 {
@@ -274,10 +309,10 @@ generate_size4_base_case(insns_t **fp, int sign)
     x64_sse_movaps_reg_membase(ins, X64_XMM0, X64_R8, 64);
     x64_sse_movaps_reg_membase(ins, X64_XMM1, X64_R8, 96);
     x64_sse_movaps_reg_membase(ins, X64_XMM7, X64_R8,  0);
-    x64_sse_movaps_reg_membase(ins, X64_XMM4, X64_R9,  0);
+    generate_lut_load_re(&ins, X64_XMM4, X64_R9, 0);
     x64_sse_movaps_reg_reg(ins, X64_XMM9, X64_XMM7);
     x64_sse_movaps_reg_reg(ins, X64_XMM6, X64_XMM4);
-    x64_sse_movaps_reg_membase(ins, X64_XMM2, X64_R9, 16);
+    generate_lut_load_im(&ins, X64_XMM2, X64_R9, 0);
     x64_sse_mulps_reg_reg(ins, X64_XMM6, X64_XMM0);
     x64_sse_mulps_reg_reg(ins, X64_XMM4, X64_XMM1);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM0, X64_XMM0, 0xB1);
@@ -307,10 +342,10 @@ generate_size4_base_case(insns_t **fp, int sign)
     x64_sse_movaps_membase_reg(ins, X64_R8, 64, X64_XMM9);
     x64_sse_movaps_membase_reg(ins, X64_R8, 96, X64_XMM10);
 
-    x64_sse_movaps_reg_membase(ins, X64_XMM14, X64_R9, 32);
+    generate_lut_load_re(&ins, X64_XMM14, X64_R9, 16);
     x64_sse_movaps_reg_membase(ins, X64_XMM11, X64_R8, 80);
     x64_sse_movaps_reg_reg(ins, X64_XMM0, X64_XMM14);
-    x64_sse_movaps_reg_membase(ins, X64_XMM13, X64_R9, 48);
+    generate_lut_load_im(&ins, X64_XMM13, X64_R9, 16);
     x64_sse_mulps_reg_reg(ins, X64_XMM0, X64_XMM11);
     x64_sse_mulps_reg_reg(ins, X64_XMM14, X64_XMM12);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM11, X64_XMM11, 0xB1);
@@ -347,10 +382,10 @@ generate_size4_base_case(insns_t **fp, int sign)
     x64_sse_movaps_reg_membase(ins, X64_XMM0, X64_RDX, 64);
     x64_sse_movaps_reg_membase(ins, X64_XMM1, X64_RDX, 96);
     x64_sse_movaps_reg_membase(ins, X64_XMM7, X64_RDX,  0);
-    x64_sse_movaps_reg_membase(ins, X64_XMM4, X64_R8,   0);
+    generate_lut_load_re(&ins, X64_XMM4, X64_R8, 0);
     x64_sse_movaps_reg_reg(ins, X64_XMM9, X64_XMM7);
     x64_sse_movaps_reg_reg(ins, X64_XMM6, X64_XMM4);
-    x64_sse_movaps_reg_membase(ins, X64_XMM2, X64_R8, 16);
+    generate_lut_load_im(&ins, X64_XMM2, X64_R8, 0);
     x64_sse_mulps_reg_reg(ins, X64_XMM6, X64_XMM0);
     x64_sse_mulps_reg_reg(ins, X64_XMM4, X64_XMM1);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM0, X64_XMM0, 0xB1);
@@ -380,10 +415,10 @@ generate_size4_base_case(insns_t **fp, int sign)
     x64_sse_movaps_membase_reg(ins, X64_RDX, 64, X64_XMM9);
     x64_sse_movaps_membase_reg(ins, X64_RDX, 96, X64_XMM10);
 
-    x64_sse_movaps_reg_membase(ins, X64_XMM14, X64_R8, 32);
+    generate_lut_load_re(&ins, X64_XMM14, X64_R8, 16);
     x64_sse_movaps_reg_membase(ins, X64_XMM11, X64_RDX, 80);
     x64_sse_movaps_reg_reg(ins, X64_XMM0, X64_XMM14);
-    x64_sse_movaps_reg_membase(ins, X64_XMM13, X64_R8, 48);
+    generate_lut_load_im(&ins, X64_XMM13, X64_R8, 16);
     x64_sse_mulps_reg_reg(ins, X64_XMM0, X64_XMM11);
     x64_sse_mulps_reg_reg(ins, X64_XMM14, X64_XMM12);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM11, X64_XMM11, 0xB1);
@@ -470,8 +505,38 @@ generate_leaf_init(insns_t **fp, uint32_t loop_count)
     *fp = ins;
 }
 
+/* prefetch the eight leaf input streams, the displacements are at least
+   128 bytes so each prefetch is 8 bytes long and the loop alignment holds */
+static FFTS_INLINE void
+generate_leaf_prefetch(insns_t **fp, uint32_t *offsets, size_t distance)
+{
+    /* to avoid deferring */
+    insns_t *ins = *fp;
+    int i;
+
+    if (!distance) {
+        return;
+    }
+
+    if (distance < 128) {
+        distance = 128;
+    }
+
+    for (i = 0; i < 8; i++) {
+#ifdef _M_X64
+        x64_sse_prefetch_reg_memindex(ins, 1, X64_RDX,
+            offsets[i] + (int32_t) distance, X64_RAX, 2);
+#else
+        x64_sse_prefetch_reg_memindex(ins, 1, X64_RSI,
+            offsets[i] + (int32_t) distance, X64_RAX, 2);
+#endif
+    }
+
+    *fp = ins;
+}
+
 static FFTS_INLINE void
-generate_leaf_ee(insns_t **fp, uint32_t *offsets, int extend)
+generate_leaf_ee(insns_t **fp, uint32_t *offsets, int extend, size_t prefetch)
 {
     insns_t *leaf_ee_loop;
 
@@ -485,6 +550,8 @@ generate_leaf_ee(insns_t **fp, uint32_t *offsets, int extend)
     leaf_ee_loop = ins;
     assert(!(((uintptr_t) leaf_ee_loop) & 0xF));
 
+    generate_leaf_prefetch(&ins, offsets, prefetch);
+
     x64_sse_movaps_reg_memindex(ins, X64_XMM7,  X64_RDX, offsets[0], X64_RAX, 2);
     x64_sse_movaps_reg_memindex(ins, X64_XMM12, X64_RDX, offsets[2], X64_RAX, 2);
 
@@ -517,7 +584,7 @@ generate_leaf_ee(insns_t **fp, uint32_t *offsets, int extend)
     x64_sse_movaps_reg_reg_size(ins, X64_XMM4, X64_XMM7, extend > 0 ? 8 : 0);
     extend--;
 
-    x64_movsxd_reg_memindex(ins, X64_R10, X64_R9, 0, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R10, X64_R9, 0, X64_RAX, 1);
     x64_sse_subps_reg_reg(ins, X64_XMM10, X64_XMM13);
     x64_sse_subps_reg_reg(ins, X64_XMM8, X64_XMM14);
     x64_sse_addps_reg_reg(ins, X64_XMM5, X64_XMM11);
@@ -575,7 +642,7 @@ generate_leaf_ee(insns_t **fp, uint32_t *offsets, int extend)
     x64_sse_movaps_reg_reg(ins, X64_XMM8, X64_XMM2);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM12, X64_XMM12, 0xB1);
     x64_sse_movaps_reg_reg(ins, X64_XMM9, X64_XMM6);
-    x64_movsxd_reg_memindex(ins, X64_R11, X64_R9, 8, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R11, X64_R9, 4, X64_RAX, 1);
     x64_sse_movlhps_reg_reg(ins, X64_XMM8, X64_XMM4);
     x64_alu_reg_imm_size(ins, X86_ADD, X64_RAX, 4, 8);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM2, X64_XMM4, 0xEE);
@@ -617,6 +684,8 @@ generate_leaf_ee(insns_t **fp, uint32_t *offsets, int extend)
     leaf_ee_loop = ins;
     assert(!(((uintptr_t) leaf_ee_loop) & 0xF));
 
+    generate_leaf_prefetch(&ins, offsets, prefetch);
+
     x64_sse_movaps_reg_memindex(ins, X64_XMM7,  X64_RSI, offsets[0], X64_RAX, 2);
     x64_sse_movaps_reg_memindex(ins, X64_XMM12, X64_RSI, offsets[2], X64_RAX, 2);
 
@@ -650,7 +719,7 @@ generate_leaf_ee(insns_t **fp, uint32_t *offsets, int extend)
 	x64_sse_movaps_reg_reg_size(ins, X64_XMM4, X64_XMM7, extend > 0 ? 8 : 0);
     extend--;
 
-    x64_movsxd_reg_memindex(ins, X64_R11, X64_R8, 0, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R11, X64_R8, 0, X64_RAX, 1);
     x64_sse_subps_reg_reg(ins, X64_XMM10, X64_XMM13);
     x64_sse_subps_reg_reg(ins, X64_XMM3, X64_XMM14);
     x64_sse_addps_reg_reg(ins, X64_XMM5, X64_XMM11);
@@ -708,7 +777,7 @@ generate_leaf_ee(insns_t **fp, uint32_t *offsets, int extend)
     x64_sse_movaps_reg_reg(ins, X64_XMM3, X64_XMM2);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM12, X64_XMM12, 0xB1);
     x64_sse_movaps_reg_reg(ins, X64_XMM9, X64_XMM6);
-    x64_movsxd_reg_memindex(ins, X64_R12, X64_R8, 8, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R12, X64_R8, 4, X64_RAX, 1);
     x64_sse_movlhps_reg_reg(ins, X64_XMM3, X64_XMM4);
     x64_alu_reg_imm_size(ins, X86_ADD, X64_RAX, 4, 8);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM2, X64_XMM4, 0xEE);
@@ -773,9 +842,9 @@ generate_leaf_eo(insns_t **fp, uint32_t *offsets)
     x64_sse_subps_reg_reg(ins, X64_XMM11, X64_XMM6);
     x64_sse_subps_reg_reg(ins, X64_XMM8, X64_XMM7);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM7);
-    x64_movsxd_reg_memindex(ins, X64_R11, X64_R9, 8, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R11, X64_R9, 4, X64_RAX, 1);
     x64_sse_movaps_reg_reg(ins, X64_XMM2, X64_XMM10);
-    x64_movsxd_reg_memindex(ins, X64_R10, X64_R9, 0, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R10, X64_R9, 0, X64_RAX, 1);
     x64_sse_movaps_reg_reg(ins, X64_XMM1, X64_XMM11);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM10, X64_XMM8, 0xEE);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM11, X64_XMM9, 0xEE);
@@ -865,9 +934,9 @@ generate_leaf_eo(insns_t **fp, uint32_t *offsets)
     x64_sse_subps_reg_reg(ins, X64_XMM11, X64_XMM6);
     x64_sse_subps_reg_reg(ins, X64_XMM8, X64_XMM7);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM7);
-    x64_movsxd_reg_memindex(ins, X64_R12, X64_R8, 8, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R12, X64_R8, 4, X64_RAX, 1);
     x64_sse_movaps_reg_reg(ins, X64_XMM2, X64_XMM10);
-    x64_movsxd_reg_memindex(ins, X64_R11, X64_R8, 0, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R11, X64_R8, 0, X64_RAX, 1);
     x64_sse_movaps_reg_reg(ins, X64_XMM1, X64_XMM11);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM10, X64_XMM8, 0xEE);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM11, X64_XMM9, 0xEE);
@@ -955,7 +1024,7 @@ generate_leaf_oe(insns_t **fp, uint32_t *offsets)
     x64_sse_movaps_reg_memindex(ins, X64_XMM12, X64_RDX, offsets[0], X64_RAX, 2);
     x64_sse_movaps_reg_memindex(ins, X64_XMM7, X64_RDX, offsets[1], X64_RAX, 2);
     x64_sse_movaps_reg_reg(ins, X64_XMM14, X64_XMM12);
-    x64_movsxd_reg_memindex(ins, X64_R10, X64_R9, 0, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R10, X64_R9, 0, X64_RAX, 1);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM8);
     x64_sse_subps_reg_reg(ins, X64_XMM10, X64_XMM8);
     x64_sse_addps_reg_reg(ins, X64_XMM14, X64_XMM7);
@@ -975,7 +1044,7 @@ generate_leaf_oe(insns_t **fp, uint32_t *offsets)
     x64_sse_subps_reg_reg(ins, X64_XMM14, X64_XMM9);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM5, X64_XMM12, 0xEE);
     x64_sse_addps_reg_reg(ins, X64_XMM12, X64_XMM10);
-    x64_movsxd_reg_memindex(ins, X64_R11, X64_R9, 8, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R11, X64_R9, 4, X64_RAX, 1);
     x64_sse_movlhps_reg_reg(ins, X64_XMM13, X64_XMM11);
     x64_sse_movaps_memindex_reg(ins, X64_R8, 0, X64_R10, 2, X64_XMM13);
     x64_sse_movaps_reg_membase(ins, X64_XMM13, X64_RSI, 48);
@@ -1050,7 +1119,7 @@ generate_leaf_oe(insns_t **fp, uint32_t *offsets)
     x64_sse_movaps_reg_memindex(ins, X64_XMM12, X64_RSI, offsets[0], X64_RAX, 2);
     x64_sse_movaps_reg_memindex(ins, X64_XMM7, X64_RSI, offsets[1], X64_RAX, 2);
     x64_sse_movaps_reg_reg(ins, X64_XMM14, X64_XMM12);
-    x64_movsxd_reg_memindex(ins, X64_R11, X64_R8, 0, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R11, X64_R8, 0, X64_RAX, 1);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM8);
     x64_sse_subps_reg_reg(ins, X64_XMM10, X64_XMM8);
     x64_sse_addps_reg_reg(ins, X64_XMM14, X64_XMM7);
@@ -1070,7 +1139,7 @@ generate_leaf_oe(insns_t **fp, uint32_t *offsets)
     x64_sse_subps_reg_reg(ins, X64_XMM14, X64_XMM9);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM5, X64_XMM12, 0xEE);
     x64_sse_addps_reg_reg(ins, X64_XMM12, X64_XMM10);
-    x64_movsxd_reg_memindex(ins, X64_R12, X64_R8, 8, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R12, X64_R8, 4, X64_RAX, 1);
     x64_sse_movlhps_reg_reg(ins, X64_XMM13, X64_XMM11);
     x64_sse_movaps_memindex_reg(ins, X64_RDX, 0, X64_R11, 2, X64_XMM13);
     x64_sse_movaps_reg_membase(ins, X64_XMM13, X64_R9, 48);
@@ -1140,7 +1209,8 @@ generate_leaf_oe(insns_t **fp, uint32_t *offsets)
 }
 
 static FFTS_INLINE void
-generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int extend)
+generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int extend,
+                 size_t prefetch)
 {
     insns_t *leaf_oo_loop;
 
@@ -1155,6 +1225,8 @@ generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int exten
     leaf_oo_loop = ins;
     assert(!(((uintptr_t) leaf_oo_loop) & 0xF));
 
+    generate_leaf_prefetch(&ins, offsets, prefetch);
+
     x64_sse_movaps_reg_memindex(ins, X64_XMM4, X64_RDX, offsets[0], X64_RAX, 2);
 
 	x64_sse_movaps_reg_reg_size(ins, X64_XMM6, X64_XMM4, extend > 0 ? 8 : 0);
@@ -1185,7 +1257,7 @@ generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int exten
     x64_sse_movaps_reg_reg(ins, X64_XMM15, X64_XMM4);
     x64_sse_movaps_reg_memindex(ins, X64_XMM12, X64_RDX, offsets[7], X64_RAX, 2);
     x64_sse_movaps_reg_reg(ins, X64_XMM13, X64_XMM14);
-    x64_movsxd_reg_memindex(ins, X64_R10, X64_R9, 0, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R10, X64_R9, 0, X64_RAX, 1);
     x64_sse_subps_reg_reg(ins, X64_XMM10, X64_XMM8);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM8);
     x64_sse_addps_reg_reg(ins, X64_XMM2, X64_XMM11);
@@ -1209,7 +1281,7 @@ generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int exten
 	x64_sse_movaps_reg_reg_size(ins, X64_XMM7, X64_XMM6, extend > 0 ? 8 : 0);
     extend--;
 
-    x64_movsxd_reg_memindex(ins, X64_R11, X64_R9, 8, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R11, X64_R9, 4, X64_RAX, 1);
     x64_alu_reg_imm_size(ins, X86_ADD, X64_RAX, 4, 8);
     x64_sse_addps_reg_reg(ins, X64_XMM4, X64_XMM10);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM13);
@@ -1255,6 +1327,8 @@ generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int exten
     leaf_oo_loop = ins;
     assert(!(((uintptr_t) leaf_oo_loop) & 0xF));
 
+    generate_leaf_prefetch(&ins, offsets, prefetch);
+
     x64_sse_movaps_reg_memindex(ins, X64_XMM4, X64_RSI, offsets[0], X64_RAX, 2);
 
 	x64_sse_movaps_reg_reg_size(ins, X64_XMM6, X64_XMM4, extend > 0 ? 8 : 0);
@@ -1285,7 +1359,7 @@ generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int exten
     x64_sse_movaps_reg_reg(ins, X64_XMM15, X64_XMM4);
     x64_sse_movaps_reg_memindex(ins, X64_XMM12, X64_RSI, offsets[7], X64_RAX, 2);
     x64_sse_movaps_reg_reg(ins, X64_XMM13, X64_XMM14);
-    x64_movsxd_reg_memindex(ins, X64_R11, X64_R8, 0, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R11, X64_R8, 0, X64_RAX, 1);
     x64_sse_subps_reg_reg(ins, X64_XMM10, X64_XMM8);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM8);
     x64_sse_addps_reg_reg(ins, X64_XMM2, X64_XMM11);
@@ -1309,7 +1383,7 @@ generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int exten
 	x64_sse_movaps_reg_reg_size(ins, X64_XMM7, X64_XMM6, extend > 0 ? 8 : 0);
     extend--;
 
-    x64_movsxd_reg_memindex(ins, X64_R12, X64_R8, 8, X64_RAX, 2);
+    x64_movsxd_reg_memindex(ins, X64_R12, X64_R8, 4, X64_RAX, 1);
     x64_alu_reg_imm_size(ins, X86_ADD, X64_RAX, 4, 8);
     x64_sse_addps_reg_reg(ins, X64_XMM4, X64_XMM10);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM13);
@@ -1349,16 +1423,30 @@ generate_leaf_oo(insns_t **fp, uint32_t loop_count, uint32_t *offsets, int exten
     *fp = ins;
 }
 
+/* store of a result of the X8 butterfly, non-temporal stores bypass the
+   cache for the last pass of transforms much larger than it */
+static FFTS_INLINE void
+generate_x8_store(insns_t **fp, int basereg, int disp, int indexreg,
+                  int shift, int reg, int stream)
+{
+    insns_t *ins = *fp;
+
+    if (stream) {
+        x64_sse_movntps_memindex_reg(ins, basereg, disp, indexreg, shift, reg);
+    } else {
+        x64_sse_movaps_memindex_reg(ins, basereg, disp, indexreg, shift, reg);
+    }
+
+    *fp = ins;
+}
+
 static FFTS_INLINE insns_t*
-generate_size8_base_case(insns_t **fp, int sign)
+generate_size8_kernel(insns_t **fp, int stream)
 {
     insns_t *ins;
     insns_t *x8_addr;
     insns_t *x8_soft_loop;
 
-    /* unreferenced parameter */
-    (void) sign;
-
     /* to avoid deferring */
     ins = *fp;
 
@@ -1398,8 +1486,8 @@ generate_size8_base_case(insns_t **fp, int sign)
     x8_soft_loop = ins;
     assert(!(((uintptr_t) x8_soft_loop) & 0xF));
 
-    /* load [input + 0 * input_stride] */
-    x64_sse_movaps_reg_membase(ins, X64_XMM9, X64_RAX, 0);
+    /* load real parts of twiddle factors 0 */
+    generate_lut_load_re(&ins, X64_XMM9, X64_RAX, 0);
 
     /* load [output + 2 * output_stride] */
     x64_sse_movaps_reg_memindex(ins, X64_XMM6, X64_RCX, 0, X64_RBX, 1);
@@ -1409,8 +1497,8 @@ generate_size8_base_case(insns_t **fp, int sign)
     /* load [output + 3 * output_stride] */
     x64_sse_movaps_reg_memindex(ins, X64_XMM7, X64_RCX, 0, X64_RSI, 0);
 
-    /* load [input + 1 * input_stride] */
-    x64_sse_movaps_reg_membase(ins, X64_XMM8, X64_RAX, 16);
+    /* load imaginary parts of twiddle factors 0 */
+    generate_lut_load_im(&ins, X64_XMM8, X64_RAX, 0);
 
     x64_sse_mulps_reg_reg(ins, X64_XMM11, X64_XMM6);
     x64_sse_mulps_reg_reg(ins, X64_XMM9, X64_XMM7);
@@ -1422,8 +1510,8 @@ generate_size8_base_case(insns_t **fp, int sign)
     x64_sse_movaps_reg_reg(ins, X64_XMM10, X64_XMM11);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM8);
 
-    /* load [input + 2 * input_stride] */
-    x64_sse_movaps_reg_membase(ins, X64_XMM15, X64_RAX, 32);
+    /* load real parts of twiddle factors 1 */
+    generate_lut_load_re(&ins, X64_XMM15, X64_RAX, 16);
 
     x64_sse_addps_reg_reg(ins, X64_XMM10, X64_XMM9);
     x64_sse_subps_reg_reg(ins, X64_XMM11, X64_XMM9);
@@ -1444,16 +1532,16 @@ generate_size8_base_case(insns_t **fp, int sign)
     /* change sign */
     x64_sse_xorps_reg_reg(ins, X64_XMM11, X64_XMM3);
 
-    /* load [input + 3 * input_stride] */
-    x64_sse_movaps_reg_membase(ins, X64_XMM14, X64_RAX, 48);
+    /* load imaginary parts of twiddle factors 1 */
+    generate_lut_load_im(&ins, X64_XMM14, X64_RAX, 16);
 
     x64_sse_subps_reg_reg(ins, X64_XMM2, X64_XMM10);
     x64_sse_mulps_reg_reg(ins, X64_XMM6, X64_XMM12);
     x64_sse_addps_reg_reg(ins, X64_XMM5, X64_XMM10);
     x64_sse_mulps_reg_reg(ins, X64_XMM15, X64_XMM13);
 
-    /* load [input + 4 * input_stride] */
-    x64_sse_movaps_reg_membase(ins, X64_XMM10, X64_RAX, 64);
+    /* load real parts of twiddle factors 2 */
+    generate_lut_load_re(&ins, X64_XMM10, X64_RAX, 32);
 
     x64_sse_movaps_reg_reg(ins, X64_XMM0, X64_XMM5);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM12, X64_XMM12, 0xB1);
@@ -1473,11 +1561,11 @@ generate_size8_base_case(insns_t **fp, int sign)
 
     x64_sse_movaps_reg_reg(ins, X64_XMM12, X64_XMM6);
 
-    /* load [input + 5 * input_stride] */
-    x64_sse_movaps_reg_membase(ins, X64_XMM9, X64_RAX, 80);
+    /* load imaginary parts of twiddle factors 2 */
+    generate_lut_load_im(&ins, X64_XMM9, X64_RAX, 32);
 
-    /* move input by 6 * input_stride */
-    x64_alu_reg_imm_size(ins, X86_ADD, X64_RAX, 0x60, 8);
+    /* move input to the next twiddle factors */
+    x64_alu_reg_imm_size(ins, X86_ADD, X64_RAX, 0x30, 8);
 
     x64_sse_mulps_reg_reg(ins, X64_XMM13, X64_XMM7);
     x64_sse_subps_reg_reg(ins, X64_XMM6, X64_XMM15);
@@ -1521,31 +1609,35 @@ generate_size8_base_case(insns_t **fp, int sign)
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM13, X64_XMM13, 0xB1);
 
     /* store [output + 0 * output_stride] */
-    x64_sse_movaps_membase_reg(ins, X64_RCX, 0, X64_XMM5);
+    if (stream) {
+        x64_sse_movntps_membase_reg(ins, X64_RCX, 0, X64_XMM5);
+    } else {
+        x64_sse_movaps_membase_reg(ins, X64_RCX, 0, X64_XMM5);
+    }
 
     /* store [output + 1 * output_stride] */
-    x64_sse_movaps_memindex_reg(ins, X64_RCX, 0, X64_RBX, 0, X64_XMM4);
+    generate_x8_store(&ins, X64_RCX, 0, X64_RBX, 0, X64_XMM4, stream);
 
     /* store [output + 2 * output_stride] */
-    x64_sse_movaps_memindex_reg(ins, X64_RCX, 0, X64_RBX, 1, X64_XMM2);
+    generate_x8_store(&ins, X64_RCX, 0, X64_RBX, 1, X64_XMM2, stream);
 
     x64_sse_subps_reg_reg(ins, X64_XMM1, X64_XMM13);
     x64_sse_addps_reg_reg(ins, X64_XMM6, X64_XMM13);
 
     /* store [output + 3 * output_stride] */
-    x64_sse_movaps_memindex_reg(ins, X64_RCX, 0, X64_RSI, 0, X64_XMM1);
+    generate_x8_store(&ins, X64_RCX, 0, X64_RSI, 0, X64_XMM1, stream);
 
     /* store [output + 4 * output_stride] */
-    x64_sse_movaps_memindex_reg(ins, X64_RCX, 0, X64_RBX, 2, X64_XMM0);
+    generate_x8_store(&ins, X64_RCX, 0, X64_RBX, 2, X64_XMM0, stream);
 
     /* store [output + 5 * output_stride] */
-    x64_sse_movaps_memindex_reg(ins, X64_RCX, 0, X64_R10, 0, X64_XMM14);
+    generate_x8_store(&ins, X64_RCX, 0, X64_R10, 0, X64_XMM14, stream);
 
     /* store [output + 6 * output_stride] */
-    x64_sse_movaps_memindex_reg(ins, X64_RCX, 0, X64_RSI, 1, X64_XMM12);
+    generate_x8_store(&ins, X64_RCX, 0, X64_RSI, 1, X64_XMM12, stream);
 
     /* store [output + 7 * output_stride] */
-    x64_sse_movaps_memindex_reg(ins, X64_RCX, 0, X64_R11, 0, X64_XMM6);
+    generate_x8_store(&ins, X64_RCX, 0, X64_R11, 0, X64_XMM6, stream);
 
     /* move output by 16 */
     x64_alu_reg_imm_size(ins, X86_ADD, X64_RCX, 16, 8);
@@ -1573,11 +1665,11 @@ generate_size8_base_case(insns_t **fp, int sign)
     x8_soft_loop = ins;
     assert(!(((uintptr_t) x8_soft_loop) & 0xF));
 
-    x64_sse_movaps_reg_membase(ins, X64_XMM9, X64_RSI, 0);
+    generate_lut_load_re(&ins, X64_XMM9, X64_RSI, 0);
     x64_sse_movaps_reg_memindex(ins, X64_XMM6, X64_R10, 0, X64_RAX, 2);
     x64_sse_movaps_reg_reg(ins, X64_XMM11, X64_XMM9);
     x64_sse_movaps_reg_memindex(ins, X64_XMM7, X64_R11, 0, X64_RAX, 2);
-    x64_sse_movaps_reg_membase(ins, X64_XMM8, X64_RSI, 16);
+    generate_lut_load_im(&ins, X64_XMM8, X64_RSI, 0);
     x64_sse_mulps_reg_reg(ins, X64_XMM11, X64_XMM6);
     x64_sse_mulps_reg_reg(ins, X64_XMM9, X64_XMM7);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM6, X64_XMM6, 0xB1);
@@ -1587,7 +1679,7 @@ generate_size8_base_case(insns_t **fp, int sign)
     x64_sse_mulps_reg_reg(ins, X64_XMM8, X64_XMM7);
     x64_sse_movaps_reg_reg(ins, X64_XMM10, X64_XMM11);
     x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM8);
-    x64_sse_movaps_reg_membase(ins, X64_XMM15, X64_RSI, 32);
+    generate_lut_load_re(&ins, X64_XMM15, X64_RSI, 16);
     x64_sse_addps_reg_reg(ins, X64_XMM10, X64_XMM9);
     x64_sse_subps_reg_reg(ins, X64_XMM11, X64_XMM9);
     x64_sse_movaps_reg_memindex(ins, X64_XMM5, X64_RBX, 0, X64_RAX, 2);
@@ -1599,12 +1691,12 @@ generate_size8_base_case(insns_t **fp, int sign)
     /* change sign */
     x64_sse_xorps_reg_reg(ins, X64_XMM11, X64_XMM3);
 
-    x64_sse_movaps_reg_membase(ins, X64_XMM14, X64_RSI, 48);
+    generate_lut_load_im(&ins, X64_XMM14, X64_RSI, 16);
     x64_sse_subps_reg_reg(ins, X64_XMM2, X64_XMM10);
     x64_sse_mulps_reg_reg(ins, X64_XMM6, X64_XMM12);
     x64_sse_addps_reg_reg(ins, X64_XMM5, X64_XMM10);
     x64_sse_mulps_reg_reg(ins, X64_XMM15, X64_XMM13);
-    x64_sse_movaps_reg_membase(ins, X64_XMM10, X64_RSI, 64);
+    generate_lut_load_re(&ins, X64_XMM10, X64_RSI, 32);
     x64_sse_movaps_reg_reg(ins, X64_XMM0, X64_XMM5);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM12, X64_XMM12, 0xB1);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM13, X64_XMM13, 0xB1);
@@ -1616,8 +1708,8 @@ generate_size8_base_case(insns_t **fp, int sign)
     x64_sse_movaps_reg_reg(ins, X64_XMM13, X64_XMM10);
     x64_sse_movaps_reg_memindex(ins, X64_XMM8, X64_R15, 0, X64_RAX, 2);
     x64_sse_movaps_reg_reg(ins, X64_XMM12, X64_XMM6);
-    x64_sse_movaps_reg_membase(ins, X64_XMM9, X64_RSI, 80);
-    x64_alu_reg_imm_size(ins, X86_ADD, X64_RSI, 0x60, 8);
+    generate_lut_load_im(&ins, X64_XMM9, X64_RSI, 32);
+    x64_alu_reg_imm_size(ins, X86_ADD, X64_RSI, 0x30, 8);
     x64_sse_mulps_reg_reg(ins, X64_XMM13, X64_XMM7);
     x64_sse_subps_reg_reg(ins, X64_XMM6, X64_XMM15);
     x64_sse_addps_reg_reg(ins, X64_XMM12, X64_XMM15);
@@ -1655,16 +1747,16 @@ generate_size8_base_case(insns_t **fp, int sign)
     x64_sse_addps_reg_reg(ins, X64_XMM4, X64_XMM11);
     x64_sse_subps_reg_reg(ins, X64_XMM14, X64_XMM11);
     x64_sse_shufps_reg_reg_imm(ins, X64_XMM13, X64_XMM13, 0xB1);
-    x64_sse_movaps_memindex_reg(ins, X64_RBX, 0, X64_RAX, 2, X64_XMM5);
-    x64_sse_movaps_memindex_reg(ins, X64_R9, 0, X64_RAX, 2, X64_XMM4);
-    x64_sse_movaps_memindex_reg(ins, X64_R10, 0, X64_RAX, 2, X64_XMM2);
+    generate_x8_store(&ins, X64_RBX, 0, X64_RAX, 2, X64_XMM5, stream);
+    generate_x8_store(&ins, X64_R9, 0, X64_RAX, 2, X64_XMM4, stream);
+    generate_x8_store(&ins, X64_R10, 0, X64_RAX, 2, X64_XMM2, stream);
     x64_sse_subps_reg_reg(ins, X64_XMM1, X64_XMM13);
     x64_sse_addps_reg_reg(ins, X64_XMM6, X64_XMM13);
-    x64_sse_movaps_memindex_reg(ins, X64_R11, 0, X64_RAX, 2, X64_XMM1);
-    x64_sse_movaps_memindex_reg(ins, X64_R12, 0, X64_RAX, 2, X64_XMM0);
-    x64_sse_movaps_memindex_reg(ins, X64_R13, 0, X64_RAX, 2, X64_XMM14);
-    x64_sse_movaps_memindex_reg(ins, X64_R14, 0, X64_RAX, 2, X64_XMM12);
-    x64_sse_movaps_memindex_reg(ins, X64_R15, 0, X64_RAX, 2, X64_XMM6);
+    generate_x8_store(&ins, X64_R11, 0, X64_RAX, 2, X64_XMM1, stream);
+    generate_x8_store(&ins, X64_R12, 0, X64_RAX, 2, X64_XMM0, stream);
+    generate_x8_store(&ins, X64_R13, 0, X64_RAX, 2, X64_XMM14, stream);
+    generate_x8_store(&ins, X64_R14, 0, X64_RAX, 2, X64_XMM12, stream);
+    generate_x8_store(&ins, X64_R15, 0, X64_RAX, 2, X64_XMM6, stream);
     x64_alu_reg_imm_size(ins, X86_ADD, X64_RAX, 4, 8);
 
     /* loop condition */
@@ -1677,4 +1769,327 @@ generate_size8_base_case(insns_t **fp, int sign)
     return x8_addr;
 }
 
+static FFTS_INLINE insns_t*
+generate_size8_base_case(insns_t **fp, int sign)
+{
+    /* unreferenced parameter */
+    (void) sign;
+
+    return generate_size8_kernel(fp, 0);
+}
+
+/* X8 kernel writing with non-temporal stores, the caller issues the
+   store fence before the output is handed back */
+static FFTS_INLINE insns_t*
+generate_size8_stream_case(insns_t **fp)
+{
+    return generate_size8_kernel(fp, 1);
+}
+
+/* call target by its absolute address, the shared kernels may be far
+   away and the code is not written at the address it executes from */
+static FFTS_INLINE void
+generate_call(insns_t **fp, insns_t *target)
+{
+    insns_t *ins = *fp;
+
+    x64_mov_reg_imm_size(ins, X64_RAX, (uintptr_t) target, 8);
+    x64_call_reg(ins, X64_RAX);
+
+    *fp = ins;
+}
+
+/* call the size N butterfly pass at the current output position */
+static FFTS_INLINE void
+generate_pass_call(insns_t **fp, ffts_plan_t *p, size_t N, size_t leaf_N,
+                   insns_t *x4_addr, insns_t *x8_addr)
+{
+    const ffts_cpx_32f *lut = (const ffts_cpx_32f*) p->ws +
+        p->ws_is[ffts_ctzl(N / leaf_N) - 1];
+    insns_t *ins = *fp;
+
+#ifdef _M_X64
+    x86_mov_reg_imm(ins, X86_EBX, N);
+    x64_mov_reg_imm_size(ins, X64_R9, (uintptr_t) lut, 8);
+#else
+    x86_mov_reg_imm(ins, X86_ECX, N / 4);
+    x64_mov_reg_imm_size(ins, X64_R8, (uintptr_t) lut, 8);
+#endif
+
+    if (N == 2 * leaf_N) {
+        generate_call(&ins, x4_addr);
+    } else {
+        generate_call(&ins, x8_addr);
+    }
+
+    *fp = ins;
+}
+
+/* Emit the subtransforms of a size N transform followed by its own pass,
+   relative to the current output position which is left unchanged.
+   Subtransforms larger than 4 * leaf_N are called from subs[ctz(size)],
+   the own pass of size N calls pass_addr instead of x8_addr. */
+static FFTS_INLINE void
+generate_subtransform_body(insns_t **fp, ffts_plan_t *p, size_t N, size_t leaf_N,
+                           insns_t *x4_addr, insns_t *x8_addr, insns_t *pass_addr,
+                           insns_t **subs)
+{
+    const size_t sizes[5] = {N/4, N/8, N/8, N/4, N/4};
+    insns_t *ins = *fp;
+    int32_t advanced = 0;
+    int32_t offset = 0;
+    int i;
+#ifdef _M_X64
+    const int output = X64_R8;
+#else
+    const int output = X64_RDX;
+#endif
+
+    for (i = 0; i < 5; i++) {
+        if (sizes[i] > leaf_N) {
+            if (offset) {
+                x64_alu_reg_imm_size(ins, X86_ADD, output, offset, 8);
+                advanced += offset;
+                offset = 0;
+            }
+
+            if (sizes[i] > 4 * leaf_N) {
+                x64_call_code(ins, subs[ffts_ctzl(sizes[i])]);
+            } else {
+                generate_pass_call(&ins, p, sizes[i], leaf_N, x4_addr, x8_addr);
+            }
+        }
+
+        offset += (int32_t) (8 * sizes[i]);
+    }
+
+    /* rewind to the beginning of this subtransform */
+    if (advanced) {
+        x64_alu_reg_imm_size(ins, X86_SUB, output, advanced, 8);
+    }
+
+    generate_pass_call(&ins, p, N, leaf_N, x4_addr, pass_addr);
+
+    *fp = ins;
+}
+
+/* size N subtransform as a subroutine, see generate_subtransform_body */
+static FFTS_INLINE insns_t*
+generate_subtransform(insns_t **fp, ffts_plan_t *p, size_t N, size_t leaf_N,
+                      insns_t *x4_addr, insns_t *x8_addr, insns_t **subs)
+{
+    insns_t *ins;
+    insns_t *sub_addr;
+
+    /* to avoid deferring */
+    ins = *fp;
+
+    /* align call destination */
+    ffts_align_mem16(&ins, 0);
+    sub_addr = ins;
+
+    generate_subtransform_body(&ins, p, N, leaf_N,
+        x4_addr, x8_addr, x8_addr, subs);
+    x64_ret(ins);
+
+    *fp = ins;
+    return sub_addr;
+}
+
+/* Emit the symbols of a rule of the grammar of the subtransform calls,
+   see sequitur.h, relative to the current output position. Terminals are
+   passes of size c, nonterminals call the subroutine of their rule kept
+   in its data. The last symbol calls last_addr when it is a size 8 pass.
+   Returns how far the output position was moved, in bytes. */
+static FFTS_INLINE int32_t
+generate_rule_body(insns_t **fp, ffts_plan_t *p, const sym_t *s, size_t leaf_N,
+                   insns_t *x4_addr, insns_t *x8_addr, insns_t *last_addr)
+{
+    insns_t *ins = *fp;
+    int32_t advanced = 0;
+#ifdef _M_X64
+    const int output = X64_R8;
+#else
+    const int output = X64_RDX;
+#endif
+
+    for (; s; s = s->pNext) {
+        /* offsets are in floats */
+        int32_t offset = 4 * s->offset - advanced;
+
+        if (offset) {
+            x64_alu_reg_imm_size(ins, X86_ADD, output, offset, 8);
+            advanced += offset;
+        }
+
+        if (s->r) {
+            x64_call_code(ins, (insns_t*) s->r->data);
+        } else {
+            generate_pass_call(&ins, p, (size_t) s->c, leaf_N,
+                x4_addr, s->pNext ? x8_addr : last_addr);
+        }
+    }
+
+    *fp = ins;
+    return advanced;
+}
+
+/* rule as a subroutine leaving the output position unchanged, the rules
+   it uses are generated before it */
+static insns_t*
+generate_rule(insns_t **fp, ffts_plan_t *p, seq_rule_t *R, size_t leaf_N,
+              insns_t *x4_addr, insns_t *x8_addr)
+{
+    insns_t *ins;
+    int32_t advanced;
+    sym_t *s;
+#ifdef _M_X64
+    const int output = X64_R8;
+#else
+    const int output = X64_RDX;
+#endif
+
+    if (R->data) {
+        return (insns_t*) R->data;
+    }
+
+    for (s = R->ss; s; s = s->pNext) {
+        if (s->r) {
+            generate_rule(fp, p, s->r, leaf_N, x4_addr, x8_addr);
+        }
+    }
+
+    /* to avoid deferring */
+    ins = *fp;
+
+    /* align call destination */
+    ffts_align_mem16(&ins, 0);
+    R->data = ins;
+
+    advanced = generate_rule_body(&ins, p, R->ss, leaf_N,
+        x4_addr, x8_addr, x8_addr);
+
+    if (advanced) {
+        x64_alu_reg_imm_size(ins, X86_SUB, output, advanced, 8);
+    }
+
+    x64_ret(ins);
+
+    *fp = ins;
+    return (insns_t*) R->data;
+}
+
+#ifdef HAVE_SSE3
+/* res = a * (complex pair loaded from [base + disp]) */
+static FFTS_INLINE void
+generate_complex_mul(insns_t **fp, int res, int t0, int t1, int a, int base, int disp)
+{
+    insns_t *ins = *fp;
+
+    x64_sse_movaps_reg_membase(ins, res, base, disp);
+    x64_sse_movshdup_reg_reg(ins, t1, res);
+    x64_sse_movsldup_reg_reg(ins, res, res);
+    x64_sse_mulps_reg_reg(ins, res, a);
+    x64_sse_movaps_reg_reg(ins, t0, a);
+    x64_sse_shufps_reg_reg_imm(ins, t0, t0, 0xB1);
+    x64_sse_mulps_reg_reg(ins, t0, t1);
+    x64_sse_addsubps_reg_reg(ins, res, t0);
+
+    *fp = ins;
+}
+
+/* Split step of a real forward transform, run in-place on the output
+   of the complex transform of size N:
+
+       X[k] = Z[k] * A[k] + conj(Z[N - k]) * B[k],  0 <= k <= N, Z[N] = Z[0]
+
+   Each iteration handles k, k + 1 and the mirrored N - k, N - k - 1, so
+   every element is loaded before its slot is stored to. The table at p->A
+   holds (A[k], A[k+1]), (B[k], B[k+1]), (A[N-k], A[N-k-1]), (B[N-k], B[N-k-1])
+   per iteration, followed by A[N/2] and B[N/2] for the middle element. */
+static FFTS_INLINE void
+generate_real_split(insns_t **fp, ffts_plan_t *p, size_t N, int32_t output_offset)
+{
+    insns_t *ins;
+    insns_t *split_loop;
+#ifdef _M_X64
+    const int output = X64_R8;
+#else
+    const int output = X64_RDX;
+#endif
+
+    /* to avoid deferring */
+    ins = *fp;
+
+    /* rewind output to the beginning */
+    if (output_offset) {
+        x64_alu_reg_imm_size(ins, X86_SUB, output, output_offset, 8);
+    }
+
+    /* RAX = p->A */
+    x64_mov_reg_imm_size(ins, X64_RAX, (uintptr_t) &p->A, 8);
+    x64_mov_reg_membase(ins, X64_RAX, X64_RAX, 0, 8);
+
+    /* XMM3 = sign mask for conjugate */
+    x64_mov_reg_imm_size(ins, X64_RCX, (uintptr_t) sse_constants, 8);
+    x64_sse_movaps_reg_membase(ins, X64_XMM3, X64_RCX, 0);
+
+    /* Z[N] = Z[0] */
+    x64_sse_movsd_reg_membase(ins, X64_XMM0, output, 0);
+    x64_sse_movsd_membase_reg(ins, output, (int32_t) (8 * N), X64_XMM0);
+
+    /* R10 = &Z[k], R11 = &Z[N - k - 1], RCX = &Z[N/2] */
+    x64_mov_reg_reg(ins, X64_R10, output, 8);
+    x64_lea_membase(ins, X64_R11, output, (int32_t) (8 * (N - 1)));
+    x64_lea_membase(ins, X64_RCX, output, (int32_t) (4 * N));
+
+    /* align loop/jump destination */
+    ffts_align_mem16(&ins, 0);
+    split_loop = ins;
+
+    x64_sse_movaps_reg_membase(ins, X64_XMM0, X64_R10, 0);
+    x64_sse_movups_reg_membase(ins, X64_XMM1, X64_R11, 0);
+    x64_sse_shufps_reg_reg_imm(ins, X64_XMM1, X64_XMM1, 0x4E);
+
+    x64_sse_movaps_reg_reg(ins, X64_XMM2, X64_XMM0);
+    x64_sse_xorps_reg_reg(ins, X64_XMM2, X64_XMM3);
+    x64_sse_movaps_reg_reg(ins, X64_XMM8, X64_XMM1);
+    x64_sse_xorps_reg_reg(ins, X64_XMM8, X64_XMM3);
+
+    /* front */
+    generate_complex_mul(&ins, X64_XMM4, X64_XMM5, X64_XMM6, X64_XMM0, X64_RAX,  0);
+    generate_complex_mul(&ins, X64_XMM7, X64_XMM5, X64_XMM6, X64_XMM8, X64_RAX, 16);
+    x64_sse_addps_reg_reg(ins, X64_XMM4, X64_XMM7);
+
+    /* back */
+    generate_complex_mul(&ins, X64_XMM9, X64_XMM5, X64_XMM6, X64_XMM1, X64_RAX, 32);
+    generate_complex_mul(&ins, X64_XMM7, X64_XMM5, X64_XMM6, X64_XMM2, X64_RAX, 48);
+    x64_sse_addps_reg_reg(ins, X64_XMM9, X64_XMM7);
+    x64_sse_shufps_reg_reg_imm(ins, X64_XMM9, X64_XMM9, 0x4E);
+
+    x64_sse_movaps_membase_reg(ins, X64_R10, 0, X64_XMM4);
+    x64_sse_movups_membase_reg(ins, X64_R11, 0, X64_XMM9);
+
+    x64_alu_reg_imm_size(ins, X86_ADD, X64_R10, 16, 8);
+    x64_alu_reg_imm_size(ins, X86_SUB, X64_R11, 16, 8);
+    x64_alu_reg_imm_size(ins, X86_ADD, X64_RAX, 64, 8);
+
+    /* loop condition */
+    x64_alu_reg_reg_size(ins, X86_CMP, X64_RCX, X64_R10, 8);
+    x64_branch_size(ins, X86_CC_NE, split_loop, 0, 4);
+
+    /* middle element, X[N/2] = Z[N/2] * A[N/2] + conj(Z[N/2]) * B[N/2] */
+    x64_sse_movsd_reg_membase(ins, X64_XMM0, X64_R10, 0);
+    x64_sse_movaps_reg_reg(ins, X64_XMM2, X64_XMM0);
+    x64_sse_xorps_reg_reg(ins, X64_XMM2, X64_XMM3);
+
+    generate_complex_mul(&ins, X64_XMM4, X64_XMM5, X64_XMM6, X64_XMM0, X64_RAX,  0);
+    generate_complex_mul(&ins, X64_XMM7, X64_XMM5, X64_XMM6, X64_XMM2, X64_RAX, 16);
+    x64_sse_addps_reg_reg(ins, X64_XMM4, X64_XMM7);
+    x64_sse_movsd_membase_reg(ins, X64_R10, 0, X64_XMM4);
+
+    *fp = ins;
+}
+#endif
+
 #endif /* FFTS_CODEGEN_SSE_H */
\ No newline at end of file
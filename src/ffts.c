@@ -35,25 +35,39 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ffts_internal.h"
 #include "ffts_chirp_z.h"
+#include "ffts_measure.h"
+#include "ffts_six_step.h"
 #include "ffts_static.h"
+#include "ffts_thread.h"
 #include "ffts_trig.h"
+#include "ffts_twiddle.h"
 #include "macros.h"
 #include "patterns.h"
 
-#ifndef DYNAMIC_DISABLED
-#include "codegen.h"
-#endif
+#include <string.h>
 
-#if _WIN32
+#if defined(_WIN32) || defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
 #include <windows.h>
-#else
-#if __APPLE__
-#include <libkern/OSCacheControl.h>
+#elif defined(HAVE_UNISTD_H)
+#include <unistd.h>
 #endif
 
-#if HAVE_SYS_MMAN_H
-#include <sys/mman.h>
+#ifndef DYNAMIC_DISABLED
+#include "codegen.h"
+#include "ffts_vmem.h"
 #endif
+
+/* the static transform runs on plans built for the x86 code generator */
+#if !defined(DYNAMIC_DISABLED) && !defined(__arm__) && defined(FFTS_HAVE_THREADS)
+#define FFTS_BACKGROUND_JIT
+
+struct _ffts_jit_job_t {
+    ffts_thread_t thread;
+    ffts_plan_t *p;
+    size_t leaf_N;
+    int sign;
+};
 #endif
 
 #if defined(HAVE_NEON)
@@ -77,84 +91,6 @@ static const FFTS_ALIGN(64) float w_data[16] = {
 };
 #endif
 
-static FFTS_INLINE int
-ffts_allow_execute(void *start, size_t len)
-{
-    int result;
-
-#ifdef _WIN32
-    DWORD old_protect;
-    result = !VirtualProtect(start, len, PAGE_EXECUTE_READ, &old_protect);
-#else
-    result = mprotect(start, len, PROT_READ | PROT_EXEC);
-#endif
-
-    return result;
-}
-
-static FFTS_INLINE int
-ffts_deny_execute(void *start, size_t len)
-{
-    int result;
-
-#ifdef _WIN32
-    DWORD old_protect;
-    result = (int) VirtualProtect(start, len, PAGE_READWRITE, &old_protect);
-#else
-    result = mprotect(start, len, PROT_READ | PROT_WRITE);
-#endif
-
-    return result;
-}
-
-static FFTS_INLINE int
-ffts_flush_instruction_cache(void *start, size_t length)
-{
-#ifdef _WIN32
-    return !FlushInstructionCache(GetCurrentProcess(), start, length);
-#else
-#ifdef __APPLE__
-    sys_icache_invalidate(start, length);
-#elif __ANDROID__
-    cacheflush((long) start, (long) start + length, 0);
-#elif __linux__
-#if GCC_VERSION_AT_LEAST(4,3)
-    __builtin___clear_cache(start, (char*) start + length);
-#elif __GNUC__
-    __clear_cache((long) start, (long) start + length);
-#endif
-#endif
-    return 0;
-#endif
-}
-
-static FFTS_INLINE void*
-ffts_vmem_alloc(size_t length)
-{
-#if __APPLE__
-    return mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED, -1, 0);
-#elif _WIN32
-    return VirtualAlloc(NULL, length, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-#else
-#ifndef MAP_ANONYMOUS
-#define MAP_ANONYMOUS 0x20
-#endif
-
-    return mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_SHARED, -1, 0);
-#endif
-}
-
-static FFTS_INLINE void
-ffts_vmem_free(void *addr, size_t length)
-{
-#ifdef _WIN32
-    (void) length;
-    VirtualFree(addr, 0, MEM_RELEASE);
-#else
-    munmap(addr, length);
-#endif
-}
-
 FFTS_API void
 ffts_execute(ffts_plan_t *p, const void *in, void *out)
 {
@@ -169,7 +105,97 @@ ffts_execute(ffts_plan_t *p, const void *in, void *out)
     }
 #endif
 
+#ifdef FFTS_BACKGROUND_JIT
+    /* the code generator thread may replace the transform at any time,
+       acquire it so the generated code is visible as well */
+    ((transform_func_t) ffts_atomic_load_ptr((void *volatile*) &p->transform))(
+        p, (const float*) in, (float*) out);
+#else
     p->transform(p, (const float*) in, (float*) out);
+#endif
+}
+
+FFTS_API int
+ffts_execute_dir(ffts_plan_t *p, const void *in, void *out, int sign)
+{
+    if (!p->inverse) {
+        LOG("ffts_execute_dir: plan was not created with sign 0\n");
+        return -1;
+    }
+
+    ffts_execute((sign < 0) ? p : p->inverse, in, out);
+    return 0;
+}
+
+FFTS_API int
+ffts_execute_small(size_t N, int sign, const void *input, void *output)
+{
+    switch (N) {
+    case 2:
+        ffts_small_2_32f(NULL, input, output);
+        break;
+    case 4:
+        if (sign < 0) {
+            ffts_small_forward4_32f(NULL, input, output);
+        } else {
+            ffts_small_backward4_32f(NULL, input, output);
+        }
+        break;
+    case 8:
+        if (sign < 0) {
+            ffts_small_forward8_32f(NULL, input, output);
+        } else {
+            ffts_small_backward8_32f(NULL, input, output);
+        }
+        break;
+    case 16:
+        if (sign < 0) {
+            ffts_small_forward16_32f(NULL, input, output);
+        } else {
+            ffts_small_backward16_32f(NULL, input, output);
+        }
+        break;
+    case 32:
+        if (sign < 0) {
+            ffts_small_forward32_32f(NULL, input, output);
+        } else {
+            ffts_small_backward32_32f(NULL, input, output);
+        }
+        break;
+    case 64:
+        if (sign < 0) {
+            ffts_small_forward64_32f(NULL, input, output);
+        } else {
+            ffts_small_backward64_32f(NULL, input, output);
+        }
+        break;
+    case 128:
+        if (sign < 0) {
+            ffts_small_forward128_32f(NULL, input, output);
+        } else {
+            ffts_small_backward128_32f(NULL, input, output);
+        }
+        break;
+    case 256:
+        if (sign < 0) {
+            ffts_small_forward256_32f(NULL, input, output);
+        } else {
+            ffts_small_backward256_32f(NULL, input, output);
+        }
+        break;
+    case 512:
+        if (sign < 0) {
+            ffts_small_forward512_32f(NULL, input, output);
+        } else {
+            ffts_small_backward512_32f(NULL, input, output);
+        }
+        break;
+    default:
+        LOG("ffts_execute_small: no straight-line transform of this size\n");
+        return -1;
+    }
+
+    return 0;
 }
 
 FFTS_API void
@@ -183,10 +209,17 @@ ffts_free(ffts_plan_t *p)
 static void
 ffts_free_1d(ffts_plan_t *p)
 {
+#ifdef FFTS_BACKGROUND_JIT
+    /* the code generator may still be writing the plan */
+    if (p->jit) {
+        ffts_thread_join(p->jit->thread);
+        free(p->jit);
+    }
+#endif
+
 #if !defined(DYNAMIC_DISABLED)
     if (p->transform_base) {
-        ffts_deny_execute(p->transform_base, p->transform_size);
-        ffts_vmem_free(p->transform_base, p->transform_size);
+        ffts_vmem_code_free(p->transform_base, p->transform_size);
     }
 #endif
 
@@ -195,7 +228,15 @@ ffts_free_1d(ffts_plan_t *p)
     }
 
     if (p->ws) {
+#ifdef __arm__
         ffts_aligned_free(p->ws);
+#else
+        ffts_twiddle_release((ffts_cpx_32f*) p->ws);
+#endif
+    }
+
+    if (p->tw_coarse) {
+        ffts_aligned_free(p->tw_coarse);
     }
 
     if (p->is) {
@@ -206,24 +247,69 @@ ffts_free_1d(ffts_plan_t *p)
         free(p->offsets);
     }
 
+#ifdef FFTS_STATIC_TASKS
+    if (p->tasks) {
+        ffts_static_tasks_free(p->tasks);
+    }
+#endif
+
+    if (p->inverse) {
+        free(p->inverse);
+    }
+
     free(p);
 }
 
+/* twiddle factors of the passes above FFTS_TWIDDLE_TABLE_MAX_N, the
+   static engine multiplies an entry of each table in double precision */
+static int
+ffts_generate_twiddles_64f(ffts_plan_t *p, size_t N)
+{
+    size_t fine_log2, fine_size, coarse_size, i;
+    ffts_cpx_64f *table;
+
+    /* the passes use exp(-2 * pi * i * k / N) for k < N/4 */
+    fine_log2 = (ffts_ctzl(N / 4) + 1) / 2;
+    fine_size = (size_t) 1 << fine_log2;
+    coarse_size = (N / 4) >> fine_log2;
+
+    table = (ffts_cpx_64f*) ffts_aligned_malloc(
+        (coarse_size + fine_size) * sizeof(*table));
+    if (!table) {
+        return -1;
+    }
+
+    p->tw_coarse = table;
+    p->tw_fine = table + coarse_size;
+    p->tw_fine_log2 = fine_log2;
+
+    for (i = 0; i < coarse_size; i++) {
+        ffts_cexp_64f(i << fine_log2, N, p->tw_coarse[i]);
+    }
+
+    for (i = 0; i < fine_size; i++) {
+        ffts_cexp_64f(i, N, p->tw_fine[i]);
+    }
+
+    for (i = 0; i < coarse_size + fine_size; i++) {
+        table[i][1] = -table[i][1];
+    }
+
+    return 0;
+}
+
 static int
-ffts_generate_luts(ffts_plan_t *p, size_t N, size_t leaf_N, int sign)
+ffts_generate_luts(ffts_plan_t *p, size_t N, size_t leaf_N, int sign, size_t n_threads)
 {
-    V4SF MULI_SIGN;
     size_t n_luts;
+#ifdef __arm__
     ffts_cpx_32f *w;
     ffts_cpx_32f *tmp;
-    size_t i, j, m, n;
+    size_t i, j, k, m, n;
     int stride;
-
-    if (sign < 0) {
-        MULI_SIGN = V4SF_LIT4(-0.0f, 0.0f, -0.0f, 0.0f);
-    } else {
-        MULI_SIGN = V4SF_LIT4(0.0f, -0.0f, 0.0f, -0.0f);
-    }
+#else
+    size_t i;
+#endif
 
     /* LUTS */
     n_luts = ffts_ctzl(N / leaf_N);
@@ -231,10 +317,45 @@ ffts_generate_luts(ffts_plan_t *p, size_t N, size_t leaf_N, int sign)
         n_luts = 0;
     }
 
+    /* the table holds only the passes up to FFTS_TWIDDLE_TABLE_MAX_N, which
+       don't depend on the transform size */
+    if ((p->flags & FFTS_INTERNAL_COMPUTED_TWIDDLES) && N > FFTS_TWIDDLE_TABLE_MAX_N) {
+        if (ffts_generate_twiddles_64f(p, N)) {
+            goto cleanup;
+        }
+
+        n_luts = ffts_ctzl(FFTS_TWIDDLE_TABLE_MAX_N / leaf_N);
+    }
+
+#ifndef __arm__
+    /* the kernels apply the sign of the transform, so all plans read their
+       tables from the shared store */
+    (void) sign;
+
+    if (n_luts) {
+        p->ws = ffts_twiddle_acquire(leaf_N, n_luts, n_threads);
+        if (!p->ws) {
+            goto cleanup;
+        }
+
+        p->ws_is = (size_t*) malloc(n_luts * sizeof(*p->ws_is));
+        if (!p->ws_is) {
+            goto cleanup;
+        }
+
+        for (i = 0; i < n_luts; i++) {
+            p->ws_is[i] = ffts_twiddle_offset(leaf_N, i);
+        }
+    }
+
+    p->lastlut = (ffts_cpx_32f*) p->ws + ffts_twiddle_offset(leaf_N, n_luts);
+#else
+    (void) n_threads;
+
     if (n_luts) {
         size_t lut_size;
 
-#if defined(__arm__) && !defined(HAVE_NEON)
+#ifndef HAVE_NEON
         lut_size = leaf_N * (((1 << n_luts) - 2) * 3 + 1) * sizeof(ffts_cpx_32f) / 2;
 #else
         lut_size = leaf_N * (((1 << n_luts) - 2) * 3 + 1) * sizeof(ffts_cpx_32f);
@@ -261,135 +382,83 @@ ffts_generate_luts(ffts_plan_t *p, size_t N, size_t leaf_N, int sign)
     /* calculate factors */
     m = leaf_N << (n_luts - 2);
     tmp = ffts_aligned_malloc(m * sizeof(ffts_cpx_32f));
+    if (!tmp) {
+        goto cleanup;
+    }
 
     ffts_generate_cosine_sine_pow2_32f(tmp, m);
 
-    /* generate lookup tables */
+    /* generate lookup tables, sampling the factors of the largest pass */
     stride = 1 << (n_luts - 1);
     for (i = 0; i < n_luts; i++) {
+        float *fw = (float*) w;
+
         p->ws_is[i] = w - (ffts_cpx_32f*) p->ws;
 
         if (!i) {
-            ffts_cpx_32f *w0 = ffts_aligned_malloc(n/4 * sizeof(ffts_cpx_32f));
-            float *fw0 = (float*) w0;
-            float *fw = (float*) w;
-
-            for (j = 0; j < n/4; j++) {
-                w0[j][0] = tmp[j * stride][0];
-                w0[j][1] = tmp[j * stride][1];
-            }
-
-#if defined(__arm__)
 #ifdef HAVE_NEON
             for (j = 0; j < n/4; j += 4) {
-                V4SF2 temp0 = V4SF2_LD(fw0 + j*2);
+                float FFTS_ALIGN(16) t0[8];
+                V4SF2 temp0;
+
+                for (k = 0; k < 4; k++) {
+                    t0[2*k + 0] = tmp[(j + k) * stride][0];
+                    t0[2*k + 1] = tmp[(j + k) * stride][1];
+                }
+
+                temp0 = V4SF2_LD(t0);
                 temp0.val[1] = V4SF_XOR(temp0.val[1], neg);
                 V4SF2_STORE_SPR(fw + j*2, temp0);
             }
 #else
             for (j = 0; j < n/4; j++) {
-                fw[j*2+0] = fw0[j*2+0];
-                fw[j*2+1] = (sign < 0) ? fw0[j*2+1] : -fw0[j*2+1];
+                fw[j*2+0] = tmp[j * stride][0];
+                fw[j*2+1] = (sign < 0) ? tmp[j * stride][1] : -tmp[j * stride][1];
             }
 #endif
             w += n/4;
-#else
-            for (j = 0; j < n/4; j += 2) {
-                V4SF re, im, temp0;
-                temp0 = V4SF_LD(fw0 + j*2);
-                re = V4SF_DUPLICATE_RE(temp0);
-                im = V4SF_DUPLICATE_IM(temp0);
-                im = V4SF_XOR(im, MULI_SIGN);
-                V4SF_ST(fw + j*4 + 0, re);
-                V4SF_ST(fw + j*4 + 4, im);
-            }
-
-            w += n/4 * 2;
-#endif
-
-            ffts_aligned_free(w0);
         } else {
-            ffts_cpx_32f *w0 = (ffts_cpx_32f*) ffts_aligned_malloc(n/8 * sizeof(ffts_cpx_32f));
-            ffts_cpx_32f *w1 = (ffts_cpx_32f*) ffts_aligned_malloc(n/8 * sizeof(ffts_cpx_32f));
-            ffts_cpx_32f *w2 = (ffts_cpx_32f*) ffts_aligned_malloc(n/8 * sizeof(ffts_cpx_32f));
-
-            float *fw0 = (float*) w0;
-            float *fw1 = (float*) w1;
-            float *fw2 = (float*) w2;
-
-            float *fw = (float *)w;
-
-            for (j = 0; j < n/8; j++) {
-                w0[j][0] = tmp[2 * j * stride][0];
-                w0[j][1] = tmp[2 * j * stride][1];
-
-                w1[j][0] = tmp[j * stride][0];
-                w1[j][1] = tmp[j * stride][1];
-
-                w2[j][0] = tmp[(j + (n/8)) * stride][0];
-                w2[j][1] = tmp[(j + (n/8)) * stride][1];
-            }
-
-#if defined(__arm__)
 #ifdef HAVE_NEON
             for (j = 0; j < n/8; j += 4) {
+                float FFTS_ALIGN(16) t0[8], t1[8], t2[8];
                 V4SF2 temp0, temp1, temp2;
 
-                temp0 = V4SF2_LD(fw0 + j*2);
+                for (k = 0; k < 4; k++) {
+                    t0[2*k + 0] = tmp[2 * (j + k) * stride][0];
+                    t0[2*k + 1] = tmp[2 * (j + k) * stride][1];
+                    t1[2*k + 0] = tmp[(j + k) * stride][0];
+                    t1[2*k + 1] = tmp[(j + k) * stride][1];
+                    t2[2*k + 0] = tmp[(j + k + n/8) * stride][0];
+                    t2[2*k + 1] = tmp[(j + k + n/8) * stride][1];
+                }
+
+                temp0 = V4SF2_LD(t0);
                 temp0.val[1] = V4SF_XOR(temp0.val[1], neg);
                 V4SF2_STORE_SPR(fw + j*2*3, temp0);
-                
-                temp1 = V4SF2_LD(fw1 + j*2);
+
+                temp1 = V4SF2_LD(t1);
                 temp1.val[1] = V4SF_XOR(temp1.val[1], neg);
                 V4SF2_STORE_SPR(fw + j*2*3 + 8,  temp1);
-                
-                temp2 = V4SF2_LD(fw2 + j*2);
+
+                temp2 = V4SF2_LD(t2);
                 temp2.val[1] = V4SF_XOR(temp2.val[1], neg);
                 V4SF2_STORE_SPR(fw + j*2*3 + 16, temp2);
             }
 #else
             for (j = 0; j < n/8; j++) {
-                fw[j*6+0] = fw0[j*2+0];
-                fw[j*6+1] = (sign < 0) ? fw0[j*2+1] : -fw0[j*2+1];
-                fw[j*6+2] = fw1[j*2+0];
-                fw[j*6+3] = (sign < 0) ? fw1[j*2+1] : -fw1[j*2+1];
-                fw[j*6+4] = fw2[j*2+0];
-                fw[j*6+5] = (sign < 0) ? fw2[j*2+1] : -fw2[j*2+1];
+                const float *w0 = tmp[2 * j * stride];
+                const float *w1 = tmp[j * stride];
+                const float *w2 = tmp[(j + n/8) * stride];
+
+                fw[j*6+0] = w0[0];
+                fw[j*6+1] = (sign < 0) ? w0[1] : -w0[1];
+                fw[j*6+2] = w1[0];
+                fw[j*6+3] = (sign < 0) ? w1[1] : -w1[1];
+                fw[j*6+4] = w2[0];
+                fw[j*6+5] = (sign < 0) ? w2[1] : -w2[1];
             }
 #endif
             w += n/8 * 3;
-#else
-            for (j = 0; j < n/8; j += 2) {
-                V4SF temp0, temp1, temp2, re, im;
-
-                temp0 = V4SF_LD(fw0 + j*2);
-                re = V4SF_DUPLICATE_RE(temp0);
-                im = V4SF_DUPLICATE_IM(temp0);
-                im = V4SF_XOR(im, MULI_SIGN);
-                V4SF_ST(fw + j*2*6+0, re);
-                V4SF_ST(fw + j*2*6+4, im);
-
-                temp1 = V4SF_LD(fw1 + j*2);
-                re = V4SF_DUPLICATE_RE(temp1);
-                im = V4SF_DUPLICATE_IM(temp1);
-                im = V4SF_XOR(im, MULI_SIGN);
-                V4SF_ST(fw + j*2*6+8 , re);
-                V4SF_ST(fw + j*2*6+12, im);
-
-                temp2 = V4SF_LD(fw2 + j*2);
-                re = V4SF_DUPLICATE_RE(temp2);
-                im = V4SF_DUPLICATE_IM(temp2);
-                im = V4SF_XOR(im, MULI_SIGN);
-                V4SF_ST(fw + j*2*6+16, re);
-                V4SF_ST(fw + j*2*6+20, im);
-            }
-
-            w += n/8 * 3 * 2;
-#endif
-
-            ffts_aligned_free(w0);
-            ffts_aligned_free(w1);
-            ffts_aligned_free(w2);
         }
 
         n *= 2;
@@ -411,6 +480,8 @@ ffts_generate_luts(ffts_plan_t *p, size_t N, size_t leaf_N, int sign)
     ffts_aligned_free(tmp);
 
     p->lastlut = w;
+#endif
+
     p->n_luts = n_luts;
     return 0;
 
@@ -418,20 +489,507 @@ cleanup:
     return -1;
 }
 
+#if defined(DYNAMIC_DISABLED) || !defined(__arm__)
+static void
+ffts_set_static_transform(ffts_plan_t *p, int sign)
+{
+    if (sign < 0) {
+        p->transform = ffts_static_transform_f_32f;
+    } else {
+        p->transform = ffts_static_transform_i_32f;
+    }
+}
+#endif
+
+#ifdef FFTS_BACKGROUND_JIT
+static FFTS_THREAD_FUNC(ffts_generate_func_code_async, arg)
+{
+    struct _ffts_jit_job_t *job = (struct _ffts_jit_job_t*) arg;
+    ffts_plan_t *p = job->p;
+    transform_func_t static_transform = p->transform;
+    transform_func_t transform;
+
+    transform = ffts_generate_func_code(p, p->N, job->leaf_N, job->sign);
+    if (!transform || ffts_vmem_code_commit(p->transform_base, p->transform_size)) {
+        /* keep using the static transform */
+        FFTS_THREAD_RETURN;
+    }
+
+    /* callers pick up the new transform on their next execution, the
+       compare and swap releases the code written and committed above */
+    ffts_atomic_cas_ptr((void *volatile*) &p->transform,
+        (void*) static_transform, (void*) transform);
+    FFTS_THREAD_RETURN;
+}
+
+static int
+ffts_generate_func_code_background(ffts_plan_t *p, size_t leaf_N, int sign)
+{
+    struct _ffts_jit_job_t *job;
+
+    job = (struct _ffts_jit_job_t*) malloc(sizeof(*job));
+    if (!job) {
+        return -1;
+    }
+
+    job->p = p;
+    job->leaf_N = leaf_N;
+    job->sign = sign;
+
+    /* run the static transform until the generated code is ready */
+    ffts_set_static_transform(p, sign);
+
+    if (ffts_thread_create(&job->thread, ffts_generate_func_code_async, job)) {
+        p->transform = NULL;
+        free(job);
+        return -1;
+    }
+
+    p->jit = job;
+    return 0;
+}
+#endif
+
+#ifndef DYNAMIC_DISABLED
+#ifndef __arm__
+/* FFTS_ENGINE=static in the environment selects the static engine for
+   plans that do not choose one with FFTS_FLAG_ENGINE_* */
+static int
+ffts_use_code_generator(unsigned int flags)
+{
+    /* zero until the environment is read, then one more than the choice.
+       Plans may be created on several threads, which all agree on it */
+    static volatile long use_code_generator;
+    long value;
+
+    if (flags & FFTS_FLAG_ENGINE_STATIC) {
+        return 0;
+    }
+
+    if (flags & FFTS_FLAG_ENGINE_JIT) {
+        return 1;
+    }
+
+    value = ffts_atomic_add(&use_code_generator, 0);
+    if (!value) {
+        const char *engine = getenv("FFTS_ENGINE");
+
+        value = 1 + !(engine && !strcmp(engine, "static"));
+        ffts_atomic_cas_long(&use_code_generator, 0, value);
+    }
+
+    return (int) (value - 1);
+}
+#endif
+
+/* returns non-zero if no code could be generated for the plan */
+static int
+ffts_generate_transform(ffts_plan_t *p, size_t leaf_N, int sign, unsigned int flags)
+{
+    size_t N = p->N;
+
+#if defined(HAVE_SSE3) && !defined(__arm__)
+    if (sign < 0 && (flags & FFTS_INTERNAL_REAL_SPLIT)) {
+        p->flags |= FFTS_INTERNAL_REAL_SPLIT;
+    }
+#endif
+
+#ifndef __arm__
+    p->flags |= (flags & FFTS_INTERNAL_COMPACT);
+#endif
+
+    /* allocate code/function buffer, large sizes are generated as
+       subroutines so it grows with log N */
+    p->transform_size = ffts_generate_func_code_size(p, N, leaf_N);
+    p->transform_base = ffts_vmem_code_alloc(p->transform_size);
+    if (!p->transform_base) {
+        LOG("ffts_init_1d: failed to allocate memory for generated code\n");
+        p->flags &= ~(FFTS_INTERNAL_REAL_SPLIT | FFTS_INTERNAL_COMPACT);
+        return -1;
+    }
+
+#ifdef FFTS_BACKGROUND_JIT
+    /* the static transform has no real split step */
+    if ((flags & FFTS_FLAG_BACKGROUND_JIT) &&
+            !(p->flags & FFTS_INTERNAL_REAL_SPLIT) &&
+            !ffts_generate_func_code_background(p, leaf_N, sign)) {
+        return 0;
+    }
+#endif
+
+    /* generate code */
+    p->transform = ffts_generate_func_code(p, N, leaf_N, sign);
+    if (!p->transform) {
+        goto cleanup;
+    }
+
+    /* make the generated code executable */
+    if (ffts_vmem_code_commit(p->transform_base, p->transform_size)) {
+        LOG("ffts_init_1d: failed to make generated code executable\n");
+        goto cleanup;
+    }
+
+    return 0;
+
+cleanup:
+    ffts_vmem_code_free(p->transform_base, p->transform_size);
+    p->transform_base = NULL;
+    p->transform = NULL;
+    p->flags &= ~(FFTS_INTERNAL_REAL_SPLIT | FFTS_INTERNAL_COMPACT);
+    return -1;
+}
+#endif
+
+/* used when the cache size cannot be queried */
+#define FFTS_DEFAULT_CACHE_SIZE (8 * 1024 * 1024)
+
+/* size of the last level cache in bytes */
+size_t
+ffts_cache_size(void)
+{
+    /* zero until queried. Plans may be created on several threads, which
+       all get the same size */
+    static volatile long cache_size;
+    long value;
+
+    if (FFTS_CACHE_SIZE) {
+        return FFTS_CACHE_SIZE;
+    }
+
+    value = ffts_atomic_add(&cache_size, 0);
+    if (!value) {
+        size_t size = 0;
+
+#if defined(_WIN32) || defined(WIN32)
+        SYSTEM_LOGICAL_PROCESSOR_INFORMATION *info;
+        DWORD i, length = 0;
+
+        GetLogicalProcessorInformation(NULL, &length);
+        info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION*) malloc(length);
+        if (info && GetLogicalProcessorInformation(info, &length)) {
+            for (i = 0; i < length / sizeof(*info); i++) {
+                if (info[i].Relationship == RelationCache &&
+                        info[i].Cache.Size > size) {
+                    size = info[i].Cache.Size;
+                }
+            }
+        }
+        free(info);
+#elif defined(_SC_LEVEL3_CACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+        long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+
+        if (l3 > 0) {
+            size = (size_t) l3;
+        } else if (l2 > 0) {
+            size = (size_t) l2;
+        }
+#endif
+
+        value = size ? (long) size : FFTS_DEFAULT_CACHE_SIZE;
+        ffts_atomic_cas_long(&cache_size, 0, value);
+    }
+
+    return (size_t) value;
+}
+
+/* number of processors online, at least one */
+static size_t
+ffts_cpu_count(void)
+{
+    /* zero until queried, like the cache size */
+    static volatile long n_cpus;
+    long value;
+
+    value = ffts_atomic_add(&n_cpus, 0);
+    if (!value) {
+        size_t count = 0;
+
+#if defined(_WIN32) || defined(WIN32)
+        SYSTEM_INFO info;
+
+        GetSystemInfo(&info);
+        count = (size_t) info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+        if (online > 0) {
+            count = (size_t) online;
+        }
+#endif
+
+        value = count ? (long) count : 1;
+        ffts_atomic_cas_long(&n_cpus, 0, value);
+    }
+
+    return (size_t) value;
+}
+
+/* number of threads building the tables of a plan */
+size_t
+ffts_plan_threads(size_t N, unsigned int flags)
+{
+    if (!(flags & FFTS_FLAG_PARALLEL_PLAN) || N < FFTS_PARALLEL_PLAN_MIN_N) {
+        return 1;
+    }
+
+    if (FFTS_PLAN_THREADS) {
+        return FFTS_PLAN_THREADS;
+    }
+
+    return ffts_cpu_count();
+}
+
+/* number of threads executing a direct or six-step transform */
+size_t
+ffts_execute_threads(size_t N, unsigned int flags)
+{
+#ifdef FFTS_STATIC_TASKS
+    if (!(flags & FFTS_FLAG_PARALLEL_EXECUTE) || N < FFTS_PARALLEL_EXECUTE_MIN_N) {
+        return 1;
+    }
+
+    if (FFTS_EXECUTE_THREADS) {
+        return FFTS_EXECUTE_THREADS;
+    }
+
+    return ffts_cpu_count();
+#else
+    (void) N;
+    (void) flags;
+    return 1;
+#endif
+}
+
+static size_t
+ffts_prefetch_distance(size_t N, unsigned int flags)
+{
+    size_t lines = (flags >> 8) & 0xff;
+
+    if (flags & FFTS_FLAG_NO_PREFETCH) {
+        return 0;
+    }
+
+    if (lines) {
+        return 64 * lines;
+    }
+
+    return (N >= FFTS_PREFETCH_MIN_N) ? FFTS_PREFETCH_DISTANCE : 0;
+}
+
+/* whether the last pass writes the output with non-temporal stores */
+int
+ffts_stream_output(size_t N, unsigned int flags)
+{
+    if (flags & FFTS_FLAG_NO_STREAM) {
+        return 0;
+    }
+
+    if (flags & FFTS_FLAG_STREAM) {
+        return 1;
+    }
+
+    return N * sizeof(ffts_cpx_32f) >= FFTS_STREAM_CACHE_RATIO * ffts_cache_size();
+}
+
+static int
+ffts_computed_twiddles(size_t N, unsigned int flags)
+{
+#ifdef __arm__
+    /* the assembly kernels read every pass from the table */
+    (void) N;
+    (void) flags;
+    return 0;
+#else
+    if (N <= FFTS_TWIDDLE_TABLE_MAX_N || (flags & FFTS_FLAG_TWIDDLES_TABLE)) {
+        return 0;
+    }
+
+    if (flags & FFTS_FLAG_TWIDDLES_COMPUTED) {
+        return 1;
+    }
+
+    /* the lookup table of ~3/4 N entries no longer fits in the cache.
+       Plans of one direction are split by the six-step algorithm long
+       before, this is for those kept whole: plans for both directions,
+       and plans the measurement or the wisdom runs direct */
+    return 3 * N / 4 * sizeof(ffts_cpx_32f) > ffts_cache_size();
+#endif
+}
+
+/* the generated straight-line transform of size N, NULL if there is none */
+static transform_func_t
+ffts_small_transform(size_t N, int sign)
+{
+    switch (N) {
+    case 32:
+        return (sign < 0) ? ffts_small_forward32_32f : ffts_small_backward32_32f;
+    case 64:
+        return (sign < 0) ? ffts_small_forward64_32f : ffts_small_backward64_32f;
+    case 128:
+        return (sign < 0) ? ffts_small_forward128_32f : ffts_small_backward128_32f;
+    case 256:
+        return (sign < 0) ? ffts_small_forward256_32f : ffts_small_backward256_32f;
+    case 512:
+        return (sign < 0) ? ffts_small_forward512_32f : ffts_small_backward512_32f;
+    default:
+        return NULL;
+    }
+}
+
+/* the default for its sizes, an engine asked for by name or the real
+   transform fusing its split step into the generated code still build
+   the tables */
+static int
+ffts_use_small_transform(size_t N, unsigned int flags)
+{
+    if (N < FFTS_SMALL_MIN_N || N > FFTS_SMALL_MAX_N) {
+        return 0;
+    }
+
+    if (flags & FFTS_INTERNAL_SMALL) {
+        return 1;
+    }
+
+    return !(flags & (FFTS_FLAG_ENGINE_JIT | FFTS_FLAG_ENGINE_STATIC |
+        FFTS_INTERNAL_COMPACT | FFTS_INTERNAL_REAL_SPLIT));
+}
+
 FFTS_API ffts_plan_t*
 ffts_init_1d(size_t N, int sign)
+{
+    return ffts_init_1d_32f(N, sign, 0);
+}
+
+FFTS_API ffts_plan_t*
+ffts_init_1d_flags(size_t N, int sign, unsigned int flags)
+{
+    return ffts_init_1d_32f(N, sign, flags & ~FFTS_INTERNAL_FLAGS);
+}
+
+#ifndef __arm__
+/* the inverse of a plan created with sign 0 is a copy of the forward plan
+   sharing all of its tables and code, only the sign constants of the
+   generated code or the static transform differ */
+static int
+ffts_init_inverse(ffts_plan_t *p)
+{
+    ffts_plan_t *q;
+
+    q = (ffts_plan_t*) malloc(sizeof(*q));
+    if (!q) {
+        return -1;
+    }
+
+    *q = *p;
+    q->destroy = NULL;
+
+    switch (p->N) {
+    case 2:
+        break;
+    case 4:
+        q->transform = &ffts_small_backward4_32f;
+        break;
+    case 8:
+        q->transform = &ffts_small_backward8_32f;
+        break;
+    case 16:
+        q->transform = &ffts_small_backward16_32f;
+        break;
+    default:
+        if (p->transform == ffts_small_transform(p->N, FFTS_FORWARD)) {
+            q->transform = ffts_small_transform(p->N, FFTS_BACKWARD);
+        } else if (p->transform == ffts_static_transform_f_32f) {
+            q->transform = ffts_static_transform_i_32f;
+        }
+#if !defined(DYNAMIC_DISABLED) && defined(HAVE_SSE)
+        else {
+            q->constants = ffts_get_constants(FFTS_BACKWARD);
+        }
+#endif
+        break;
+    }
+
+    p->inverse = q;
+    return 0;
+}
+#endif
+
+static int
+ffts_set_scale_1d(ffts_plan_t *p, float scale);
+
+static int
+ffts_set_callbacks_1d(ffts_plan_t *p,
+                      ffts_load_func_t load,
+                      ffts_store_func_t store,
+                      void *userdata);
+
+ffts_plan_t*
+ffts_init_1d_32f(size_t N, int sign, unsigned int flags)
 {
     const size_t leaf_N = 8;
     ffts_plan_t *p;
+    size_t n_threads;
+    int both = !sign;
 
     if (N < 2) {
         LOG("FFT size must be greater than 1");
         return NULL;
     }
 
-    /* check if size is not a power of two */
+    /* plans for both directions are built as forward plans */
+    if (both) {
+#ifdef __arm__
+        LOG("ffts_init_1d: sign 0 is not supported on ARM\n");
+        return NULL;
+#else
+        if (N & (N - 1)) {
+            LOG("ffts_init_1d: sign 0 needs a power of two size\n");
+            return NULL;
+        }
+
+        /* the inverse is created once the code is ready */
+        flags &= ~FFTS_FLAG_BACKGROUND_JIT;
+        sign = FFTS_FORWARD;
+#endif
+    }
+
+    if (flags & FFTS_FLAG_MEASURE) {
+        flags = ffts_measure_1d(N, sign, flags);
+    }
+
+    /* check if size is not a power of two, its output is in natural
+       order and so are the spectra of its sub-plan. The internal flags
+       describe this plan (the split step of a real transform, the choices
+       of a measurement), not the sub-plan, which makes its own choices */
     if (N & (N - 1)) {
-        return ffts_chirp_z_init(N, sign);
+        return ffts_chirp_z_init(N, sign,
+            flags & ~(FFTS_FLAG_SCRAMBLED | FFTS_INTERNAL_FLAGS));
+    }
+
+    /* the order of a scrambled spectrum depends on the choice of six-step,
+       which the forward and inverse plans must make alike */
+    if (flags & FFTS_FLAG_SCRAMBLED) {
+        flags &= ~(FFTS_INTERNAL_SIX_STEP | FFTS_INTERNAL_DIRECT);
+
+        if (!both && ffts_six_step_preferred(N)) {
+            return ffts_six_step_init(N, sign, flags);
+        }
+    }
+
+    /* transforms larger than the cache are split into cache sized ones */
+    if (!both && !(flags & FFTS_INTERNAL_DIRECT) &&
+            ((flags & FFTS_INTERNAL_SIX_STEP) || ffts_six_step_preferred(N))) {
+        p = ffts_six_step_init(N, sign, flags);
+        if (p) {
+            return p;
+        }
+    }
+
+    /* the leaf index tables are 32-bit */
+    if (N > INT32_MAX / 2) {
+        LOG("FFT size too large for a direct transform");
+        return NULL;
     }
 
     p = (ffts_plan_t*) calloc(1, sizeof(*p));
@@ -440,11 +998,22 @@ ffts_init_1d(size_t N, int sign)
     }
 
     p->destroy = ffts_free_1d;
+    p->set_scale = ffts_set_scale_1d;
+    p->set_callbacks = ffts_set_callbacks_1d;
     p->N = N;
 
-    if (N >= 32) {
+    if (ffts_use_small_transform(N, flags)) {
+        /* the offsets and twiddle factors are compiled in */
+        p->transform = ffts_small_transform(N, sign);
+    } else if (N >= 32) {
+        if (ffts_computed_twiddles(N, flags)) {
+            p->flags |= FFTS_INTERNAL_COMPUTED_TWIDDLES;
+        }
+
+        n_threads = ffts_plan_threads(N, flags);
+
         /* generate lookup tables */
-        if (ffts_generate_luts(p, N, leaf_N, sign)) {
+        if (ffts_generate_luts(p, N, leaf_N, sign, n_threads)) {
             goto cleanup;
         }
 
@@ -453,11 +1022,17 @@ ffts_init_1d(size_t N, int sign)
             goto cleanup;
         }
 
-        p->is = ffts_init_is(N, leaf_N, 1);
+        p->is = ffts_init_is(N, leaf_N, 1, n_threads);
         if (!p->is) {
             goto cleanup;
         }
 
+        p->prefetch_distance = ffts_prefetch_distance(N, flags);
+
+        if (ffts_stream_output(N, flags)) {
+            p->flags |= FFTS_INTERNAL_STREAM;
+        }
+
         p->i0 = N/leaf_N/3 + 1;
         p->i1 = p->i2 = N/leaf_N/3;
         if ((N/leaf_N) % 3 > 1) {
@@ -470,47 +1045,36 @@ ffts_init_1d(size_t N, int sign)
 #endif
 
 #ifdef DYNAMIC_DISABLED
-        if (sign < 0) {
-            p->transform = ffts_static_transform_f_32f;
-        } else {
-            p->transform = ffts_static_transform_i_32f;
-        }
-#else
-        /* determinate transform size */
-#if defined(__arm__)
-        if (N < 8192) {
-            p->transform_size = 8192;
-        } else {
-            p->transform_size = N;
-        }
-#else
-        if (N < 2048) {
-            p->transform_size = 16384;
-        } else {
-            p->transform_size = 16384 + 2*N/8 * ffts_ctzl(N);
-        }
-#endif
+        /* only the code generator can fuse the real split step */
+        (void) flags;
 
-        /* allocate code/function buffer */
-        p->transform_base = ffts_vmem_alloc(p->transform_size);
-        if (!p->transform_base) {
+        ffts_set_static_transform(p, sign);
+#elif defined(__arm__)
+        if (ffts_generate_transform(p, leaf_N, sign, flags)) {
             goto cleanup;
         }
-
-        /* generate code */
-        p->transform = ffts_generate_func_code(p, N, leaf_N, sign);
-        if (!p->transform) {
-            goto cleanup;
+#else
+        /* the static engine runs the same plan when no code is generated,
+           either on request or because executable memory is unavailable,
+           and is the only one computing twiddle factors or executing on
+           several threads */
+        if ((p->flags & FFTS_INTERNAL_COMPUTED_TWIDDLES) ||
+                ffts_execute_threads(N, flags) > 1 ||
+                !ffts_use_code_generator(flags) ||
+                ffts_generate_transform(p, leaf_N, sign, flags)) {
+            ffts_set_static_transform(p, sign);
         }
+#endif
 
-        /* enable execution with read access for the block */
-        if (ffts_allow_execute(p->transform_base, p->transform_size)) {
-            goto cleanup;
-        }
+#ifdef FFTS_STATIC_TASKS
+        n_threads = ffts_execute_threads(N, flags);
 
-        /* flush from the instruction cache */
-        if (ffts_flush_instruction_cache(p->transform_base, p->transform_size)) {
-            goto cleanup;
+        if (n_threads > 1 && (p->transform == ffts_static_transform_f_32f ||
+                p->transform == ffts_static_transform_i_32f)) {
+            p->tasks = ffts_static_tasks_init(p, n_threads);
+            if (!p->tasks) {
+                goto cleanup;
+            }
         }
 #endif
     } else {
@@ -543,9 +1107,164 @@ ffts_init_1d(size_t N, int sign)
         }
     }
 
+#ifndef __arm__
+    if (both && ffts_init_inverse(p)) {
+        goto cleanup;
+    }
+#endif
+
     return p;
 
 cleanup:
     ffts_free_1d(p);
     return NULL;
-}
\ No newline at end of file
+}
+
+/* the straight-line transforms have no first or last pass of their own,
+   the callbacks run over the whole input and output while in cache. Those
+   from FFTS_SMALL_MIN_N points scale in their last pass, the smaller ones
+   here */
+static void
+ffts_small_callbacks_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    float FFTS_ALIGN(16) stage[2 * FFTS_SMALL_MAX_N];
+    float *dout = (float*) out;
+    size_t i;
+
+    if (p->load) {
+        p->load(stage, in, 0, p->N, p->userdata);
+        in = stage;
+    }
+
+    p->base_transform(p, in, out);
+
+    if ((p->flags & FFTS_INTERNAL_SCALED) && p->N < FFTS_SMALL_MIN_N) {
+        for (i = 0; i < 2 * p->N; i++) {
+            dout[i] *= p->scale;
+        }
+    }
+
+    if (p->store) {
+        p->store(dout, 0, p->N, p->userdata);
+    }
+}
+
+/* lets a plan call out from its first and last passes and scale its
+   output, a plan without tables wraps its straight-line transform if it
+   cannot do so itself and a plan with tables switches to the static
+   engine */
+static int
+ffts_hook_1d(ffts_plan_t *p, int callbacks, int scaled)
+{
+    if (!p->offsets) {
+        int hooked = callbacks || (scaled && p->N < FFTS_SMALL_MIN_N);
+
+        if (p->transform != ffts_small_callbacks_32f) {
+            p->base_transform = p->transform;
+        }
+
+        p->transform = hooked ? ffts_small_callbacks_32f : p->base_transform;
+        return 0;
+    }
+
+    if (!callbacks && !scaled) {
+        return 0;
+    }
+
+    /* only the static engine of the vector macros calls out from its
+       passes, the code generator would switch the plan to its code.
+       Switching costs up to about a quarter of the transform, see
+       ffts_set_callbacks */
+#ifndef FFTS_STATIC_CALLBACKS
+    return -1;
+#else
+#ifdef FFTS_BACKGROUND_JIT
+    if (p->jit) {
+        ffts_thread_join(p->jit->thread);
+        free(p->jit);
+        p->jit = NULL;
+    }
+#endif
+
+    if (p->transform != ffts_static_transform_f_32f &&
+            p->transform != ffts_static_transform_i_32f) {
+#if !defined(DYNAMIC_DISABLED) && defined(HAVE_SSE) && !defined(__arm__)
+        ffts_set_static_transform(p,
+            (p->constants == ffts_get_constants(FFTS_BACKWARD)) ?
+            FFTS_BACKWARD : FFTS_FORWARD);
+#else
+        return -1;
+#endif
+    }
+
+    return 0;
+#endif
+}
+
+static int
+ffts_set_callbacks_1d(ffts_plan_t *p,
+                      ffts_load_func_t load,
+                      ffts_store_func_t store,
+                      void *userdata)
+{
+    if (ffts_hook_1d(p, load || store, (p->flags & FFTS_INTERNAL_SCALED) != 0)) {
+        return -1;
+    }
+
+    p->load = load;
+    p->store = store;
+    p->userdata = userdata;
+
+    if (p->inverse) {
+        return ffts_set_callbacks_1d(p->inverse, load, store, userdata);
+    }
+
+    return 0;
+}
+
+FFTS_API int
+ffts_set_callbacks(ffts_plan_t *p,
+                   ffts_load_func_t load,
+                   ffts_store_func_t store,
+                   void *userdata)
+{
+    if (!p || !p->set_callbacks) {
+        return -1;
+    }
+
+    return p->set_callbacks(p, load, store, userdata);
+}
+
+/* the last pass of the static engine and of the straight-line transforms
+   scales the output, the smallest transforms scale theirs while in cache */
+static int
+ffts_set_scale_1d(ffts_plan_t *p, float scale)
+{
+    if (ffts_hook_1d(p, p->load || p->store, scale != 1.0f)) {
+        return -1;
+    }
+
+    if (scale != 1.0f) {
+        p->flags |= FFTS_INTERNAL_SCALED;
+    } else {
+        p->flags &= ~FFTS_INTERNAL_SCALED;
+    }
+
+    p->scale = scale;
+
+    if (p->inverse) {
+        return ffts_set_scale_1d(p->inverse, scale);
+    }
+
+    return 0;
+}
+
+FFTS_API int
+ffts_set_scale(ffts_plan_t *p, float scale)
+{
+    if (!p || !p->set_scale) {
+        return -1;
+    }
+
+    return p->set_scale(p, scale);
+}
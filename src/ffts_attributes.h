@@ -108,4 +108,13 @@
 #define FFTS_UNLIKELY(cond) cond
 #endif
 
+#if defined(__GNUC__)
+#define FFTS_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#define FFTS_PREFETCH(addr) _mm_prefetch((const char*) (addr), _MM_HINT_T0)
+#else
+#define FFTS_PREFETCH(addr)
+#endif
+
 #endif /* FFTS_ATTRIBUTES_H */
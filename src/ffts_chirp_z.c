@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ffts_chirp_z.h"
 
 #include "ffts_internal.h"
+#include "ffts_thread.h"
 #include "ffts_trig.h"
 
 /*
@@ -74,12 +75,70 @@ ffts_chirp_z_free(ffts_plan_t *p)
     free(p);
 }
 
+typedef struct _ffts_chirp_z_fill_t {
+    const float *A;
+    float *tmp;
+    float reciprocal_M;
+    size_t N;
+    size_t M;
+} ffts_chirp_z_fill_t;
+
+/* elements begin to end of the scaled sequence, mirrored and zero padded */
+static void
+ffts_chirp_z_fill(void *arg, size_t begin, size_t end)
+{
+    const ffts_chirp_z_fill_t *fill = (const ffts_chirp_z_fill_t*) arg;
+    const float *A = fill->A;
+    float *tmp = fill->tmp;
+    float reciprocal_M = fill->reciprocal_M;
+    size_t i, N = fill->N, M = fill->M;
+
+    for (i = begin; i < end; ++i) {
+        if (i < N) {
+            tmp[2 * i + 0] = A[2 * i + 0] * reciprocal_M;
+            tmp[2 * i + 1] = A[2 * i + 1] * reciprocal_M;
+        } else if (i > M - N) {
+            tmp[2 * i + 0] = A[2 * (M - i) + 0] * reciprocal_M;
+            tmp[2 * i + 1] = A[2 * (M - i) + 1] * reciprocal_M;
+        } else {
+            tmp[2 * i] = tmp[2 * i + 1] = 0.0f;
+        }
+    }
+}
+
+/* the transform of the chirp sequence that the input is convolved with,
+   carrying the reciprocal of the convolution length and the factor of
+   ffts_set_scale */
+static void
+ffts_chirp_z_generate_filter(ffts_plan_t *p, float scale, size_t n_threads)
+{
+    ffts_chirp_z_fill_t fill;
+    size_t M = p->plans[0]->N;
+
+    /* scale with reciprocal of length, mirror and zero pad */
+    fill.A = p->A;
+    fill.tmp = (float*) p->buf;
+    fill.reciprocal_M = scale / M;
+    fill.N = p->N;
+    fill.M = M;
+    ffts_parallel_for(M, n_threads, ffts_chirp_z_fill, &fill);
+
+    /* FFT */
+    p->plans[0]->transform(p->plans[0], p->buf, p->B);
+}
+
+static int
+ffts_chirp_z_set_scale(ffts_plan_t *p, float scale)
+{
+    ffts_chirp_z_generate_filter(p, scale, 1);
+    return 0;
+}
+
 ffts_plan_t*
-ffts_chirp_z_init(size_t N, int sign)
+ffts_chirp_z_init(size_t N, int sign, unsigned int flags)
 {
-    float *A, *B, reciprocal_M, *tmp;
     ffts_plan_t *p;
-    size_t i, M;
+    size_t M;
 
     FFTS_ASSUME(N > 2);
 
@@ -88,6 +147,7 @@ ffts_chirp_z_init(size_t N, int sign)
         return NULL;
 
     p->destroy = ffts_chirp_z_free;
+    p->set_scale = ffts_chirp_z_set_scale;
     p->N = N;
     p->rank = 1;
     p->plans = (ffts_plan_t**) &p[1];
@@ -99,37 +159,27 @@ ffts_chirp_z_init(size_t N, int sign)
 
     /* determinate next power of two such that M >= 2*N-1 */
     M = ffts_next_power_of_2(2*N-1);
-    p->plans[0] = ffts_init_1d(M, FFTS_FORWARD);
+
+    /* its transform is called directly, which only ffts_execute does
+       while code is generated */
+    p->plans[0] = ffts_init_1d_32f(M, FFTS_FORWARD, flags & ~FFTS_FLAG_BACKGROUND_JIT);
     if (!p->plans[0])
         goto cleanup;
 
-    p->A = A = (float*) ffts_aligned_malloc(2 * N * sizeof(float));
+    p->A = (float*) ffts_aligned_malloc(2 * N * sizeof(float));
     if (!p->A)
         goto cleanup;
 
-    p->B = B = (float*) ffts_aligned_malloc(2 * M * sizeof(float));
+    p->B = (float*) ffts_aligned_malloc(2 * M * sizeof(float));
     if (!p->B)
         goto cleanup;
 
-    p->buf = tmp = (float*) ffts_aligned_malloc(2 * 2 * M * sizeof(float));
-
-    ffts_generate_chirp_32f((ffts_cpx_32f*) A, N);
-
-    /* scale with reciprocal of length */
-    reciprocal_M = 1.0f / M;
-    tmp[0] = A[0] * reciprocal_M;
-    tmp[1] = A[1] * reciprocal_M;
-    for (i = 1; i < N; ++i) {
-        tmp[2 * i + 0] = tmp[2 * (M - i) + 0] = A[2 * i + 0] * reciprocal_M;
-        tmp[2 * i + 1] = tmp[2 * (M - i) + 1] = A[2 * i + 1] * reciprocal_M;
-    }
-
-    /* zero pad */
-    for (; i <= M - N; ++i)
-        tmp[2 * i] = tmp[2 * i + 1] = 0.0f;
+    p->buf = ffts_aligned_malloc(2 * 2 * M * sizeof(float));
+    if (!p->buf)
+        goto cleanup;
 
-    /* FFT */
-    p->plans[0]->transform(p->plans[0], tmp, B);
+    ffts_generate_chirp_32f((ffts_cpx_32f*) p->A, N);
+    ffts_chirp_z_generate_filter(p, 1.0f, ffts_plan_threads(M, flags));
     return p;
 
 cleanup:
@@ -40,6 +40,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ffts.h"
 
 ffts_plan_t*
-ffts_chirp_z_init(size_t N, int sign);
+ffts_chirp_z_init(size_t N, int sign, unsigned int flags);
 
 #endif /* FFTS_CHIRP_Z_H */
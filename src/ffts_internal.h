@@ -39,6 +39,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "config.h"
 #endif
 
+#include "ffts.h"
 #include "ffts_attributes.h"
 #include "types.h"
 
@@ -112,9 +113,9 @@ typedef void (*transform_func_t)(struct _ffts_plan_t *p, const void *in, void *o
 struct _ffts_plan_t {
 
     /**
-     *
+     * Output offsets of the leaves, 32-bit to halve the index bandwidth
      */
-    ptrdiff_t *offsets;
+    int32_t *offsets;
 #ifdef DYNAMIC_DISABLED
     /**
      * Twiddle factors
@@ -135,7 +136,7 @@ struct _ffts_plan_t {
     /**
      * Pointer into an array of precomputed indexes for the input data array
      */
-    ptrdiff_t *is;
+    int32_t *is;
 
     /**
      * Twiddle Factor Indexes
@@ -200,8 +201,175 @@ struct _ffts_plan_t {
     float *A, *B;
 
     size_t i2;
+
+    /**
+     * Plan flags (FFTS_INTERNAL_*)
+     */
+    unsigned int flags;
+
+    /**
+     * Pending background code generation, NULL once joined
+     */
+    struct _ffts_jit_job_t *jit;
+
+    /**
+     * Bytes ahead of the leaf loads to prefetch, zero if disabled
+     */
+    size_t prefetch_distance;
+
+    /**
+     * Coarse and fine twiddle tables of the passes above
+     * FFTS_TWIDDLE_TABLE_MAX_N, W(a * 2^tw_fine_log2 + b) = coarse[a] * fine[b]
+     */
+    ffts_cpx_64f *tw_coarse, *tw_fine;
+    size_t tw_fine_log2;
+
+    /**
+     * Inverse of a plan created with sign 0, sharing its tables and code
+     */
+    struct _ffts_plan_t *inverse;
+
+    /**
+     * Tasks of a static transform executed on several threads, NULL if
+     * executed on the calling thread only
+     */
+    struct _ffts_static_tasks_t *tasks;
+
+    /**
+     * Threads sharing the passes of a six-step transform, each with its
+     * own part of transpose_buf
+     */
+    size_t n_threads;
+
+    /**
+     * Callbacks of ffts_set_callbacks, and the straight-line transform
+     * they wrap in plans without tables
+     */
+    ffts_load_func_t load;
+    ffts_store_func_t store;
+    void *userdata;
+    transform_func_t base_transform;
+
+    /**
+     * Factor of ffts_set_scale, multiplied into the output by plans with
+     * FFTS_INTERNAL_SCALED set and folded into the tables of the others
+     */
+    float scale;
+
+    /**
+     * Direction the plan was created with, kept by the plans rebuilding
+     * their tables or sub-plans when scaled
+     */
+    int sign;
+
+    /**
+     * Applies the factor of ffts_set_scale, NULL if not supported
+     */
+    int (*set_scale)(struct _ffts_plan_t *, float);
+
+    /**
+     * Sets the callbacks of ffts_set_callbacks, NULL if not supported
+     */
+    int (*set_callbacks)(struct _ffts_plan_t *, ffts_load_func_t,
+        ffts_store_func_t, void *);
 };
 
+/* the split step of a real forward transform is emitted at the end of
+   the generated code of its complex sub-plan, reading the table from A */
+#define FFTS_INTERNAL_REAL_SPLIT 0x80000000u
+
+/* generate one subroutine per size also for small transforms */
+#define FFTS_INTERNAL_COMPACT 0x40000000u
+
+/* force or forbid the six-step schedule instead of the cache size heuristic */
+#define FFTS_INTERNAL_SIX_STEP 0x20000000u
+#define FFTS_INTERNAL_DIRECT 0x10000000u
+
+/* the last pass writes the output with non-temporal stores */
+#define FFTS_INTERNAL_STREAM 0x08000000u
+
+/* the largest passes compute their twiddle factors from two small tables */
+#define FFTS_INTERNAL_COMPUTED_TWIDDLES 0x04000000u
+
+/* run the generated straight-line transform of the size */
+#define FFTS_INTERNAL_SMALL 0x02000000u
+
+/* the output is multiplied by scale in the last pass */
+#define FFTS_INTERNAL_SCALED 0x01000000u
+
+/* default software prefetch distance (bytes) and the smallest size using it */
+#ifndef FFTS_PREFETCH_DISTANCE
+#define FFTS_PREFETCH_DISTANCE 512
+#endif
+
+#ifndef FFTS_PREFETCH_MIN_N
+#define FFTS_PREFETCH_MIN_N 65536
+#endif
+
+/* size of the last level cache in bytes, zero queries the machine */
+#ifndef FFTS_CACHE_SIZE
+#define FFTS_CACHE_SIZE 0
+#endif
+
+/* stream the output once it is this many times the last level cache */
+#ifndef FFTS_STREAM_CACHE_RATIO
+#define FFTS_STREAM_CACHE_RATIO 2
+#endif
+
+/* largest pass reading its twiddle factors from the lookup table when
+   the larger ones compute them */
+#ifndef FFTS_TWIDDLE_TABLE_MAX_N
+#define FFTS_TWIDDLE_TABLE_MAX_N 65536
+#endif
+
+/* smallest size building its tables on several threads when asked to */
+#ifndef FFTS_PARALLEL_PLAN_MIN_N
+#define FFTS_PARALLEL_PLAN_MIN_N 1048576
+#endif
+
+/* threads building a plan, zero uses one per processor */
+#ifndef FFTS_PLAN_THREADS
+#define FFTS_PLAN_THREADS 0
+#endif
+
+/* smallest size executed on several threads when asked to */
+#ifndef FFTS_PARALLEL_EXECUTE_MIN_N
+#define FFTS_PARALLEL_EXECUTE_MIN_N 65536
+#endif
+
+/* threads executing a transform, zero uses one per processor */
+#ifndef FFTS_EXECUTE_THREADS
+#define FFTS_EXECUTE_THREADS 0
+#endif
+
+/* sub-transforms up to this size run as a single task */
+#ifndef FFTS_PARALLEL_GRAIN_N
+#define FFTS_PARALLEL_GRAIN_N 16384
+#endif
+
+/* leaves or butterflies of a pass in one task */
+#ifndef FFTS_PARALLEL_CHUNK
+#define FFTS_PARALLEL_CHUNK 1024
+#endif
+
+/* bits not accepted from the public API */
+#define FFTS_INTERNAL_FLAGS 0xff000000u
+
+struct _ffts_plan_t*
+ffts_init_1d_32f(size_t N, int sign, unsigned int flags);
+
+size_t
+ffts_cache_size(void);
+
+size_t
+ffts_plan_threads(size_t N, unsigned int flags);
+
+size_t
+ffts_execute_threads(size_t N, unsigned int flags);
+
+int
+ffts_stream_output(size_t N, unsigned int flags);
+
 static FFTS_INLINE void*
 ffts_aligned_malloc(size_t size)
 {
@@ -299,4 +467,73 @@ ffts_next_power_of_2(size_t N)
 #endif /* _WIN64 */
 #endif /* _MSC_VER */
 
+/* atomically replace *ptr with desired if it equals expected,
+   returns non-zero on success */
+#if GCC_VERSION_AT_LEAST(4,1)
+#define FFTS_HAVE_ATOMIC_CAS
+
+static FFTS_INLINE int
+ffts_atomic_cas_ptr(void *volatile *ptr, void *expected, void *desired)
+{
+    return __sync_bool_compare_and_swap(ptr, expected, desired);
+}
+
+static FFTS_INLINE int
+ffts_atomic_cas_long(volatile long *ptr, long expected, long desired)
+{
+    return __sync_bool_compare_and_swap(ptr, expected, desired);
+}
+
+/* atomically add value to *ptr, returns the new value */
+static FFTS_INLINE long
+ffts_atomic_add(volatile long *ptr, long value)
+{
+    return __sync_add_and_fetch(ptr, value);
+}
+
+/* read *ptr with acquire semantics, whatever was written before it was
+   stored by ffts_atomic_cas_ptr (a full barrier) is visible after */
+static FFTS_INLINE void*
+ffts_atomic_load_ptr(void *volatile *ptr)
+{
+#ifdef __ATOMIC_ACQUIRE
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+    void *value = *ptr;
+    __sync_synchronize();
+    return value;
+#endif
+}
+#elif defined(_MSC_VER)
+#define FFTS_HAVE_ATOMIC_CAS
+
+static FFTS_INLINE int
+ffts_atomic_cas_ptr(void *volatile *ptr, void *expected, void *desired)
+{
+    return _InterlockedCompareExchangePointer(ptr, desired, expected) == expected;
+}
+
+static FFTS_INLINE int
+ffts_atomic_cas_long(volatile long *ptr, long expected, long desired)
+{
+    return _InterlockedCompareExchange(ptr, desired, expected) == expected;
+}
+
+static FFTS_INLINE long
+ffts_atomic_add(volatile long *ptr, long value)
+{
+    return _InterlockedExchangeAdd(ptr, value) + value;
+}
+
+/* volatile reads are acquires, the barrier keeps the compiler from
+   moving later reads before it */
+static FFTS_INLINE void*
+ffts_atomic_load_ptr(void *volatile *ptr)
+{
+    void *value = *ptr;
+    _ReadWriteBarrier();
+    return value;
+}
+#endif
+
 #endif /* FFTS_INTERNAL_H */
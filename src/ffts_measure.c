@@ -0,0 +1,510 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ffts_measure.h"
+
+#include "ffts.h"
+#include "ffts_six_step.h"
+#include "ffts_static.h"
+
+#ifndef DYNAMIC_DISABLED
+#include "codegen.h"
+#endif
+
+#if defined(_WIN32) || defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+/* each candidate runs at least this long (in seconds) per round,
+   the best of FFTS_MEASURE_ROUNDS rounds is kept */
+#define FFTS_MEASURE_MIN_TIME 1e-3
+#define FFTS_MEASURE_ROUNDS 3
+
+/* flags chosen by measuring, the rest are passed through */
+#define FFTS_MEASURE_ENGINES \
+    (FFTS_FLAG_ENGINE_JIT | FFTS_FLAG_ENGINE_STATIC)
+
+#define FFTS_MEASURE_FLAGS \
+    (FFTS_MEASURE_ENGINES | FFTS_INTERNAL_COMPACT | FFTS_INTERNAL_SIX_STEP | \
+     FFTS_INTERNAL_DIRECT | FFTS_INTERNAL_SMALL)
+
+/* each line is the size, the sign, the engine that was asked for ("any"
+   if none) and the choices joined by '+'. The choices are saved by name
+   as the internal flags may change between versions */
+#define FFTS_WISDOM_HEADER "ffts-wisdom-2\n"
+
+static const struct {
+    unsigned int flag;
+    const char *name;
+} ffts_wisdom_names[] = {
+    { FFTS_FLAG_ENGINE_JIT,    "jit"      },
+    { FFTS_FLAG_ENGINE_STATIC, "static"   },
+    { FFTS_INTERNAL_COMPACT,   "compact"  },
+    { FFTS_INTERNAL_SIX_STEP,  "six-step" },
+    { FFTS_INTERNAL_DIRECT,    "direct"   },
+    { FFTS_INTERNAL_SMALL,     "small"    }
+};
+
+#define FFTS_WISDOM_NAMES \
+    (sizeof(ffts_wisdom_names) / sizeof(ffts_wisdom_names[0]))
+
+typedef struct _ffts_wisdom_t {
+    size_t N;
+    int sign;
+    unsigned int engine;
+    unsigned int flags;
+} ffts_wisdom_t;
+
+static ffts_wisdom_t *ffts_wisdom;
+static size_t ffts_wisdom_count;
+static size_t ffts_wisdom_capacity;
+static void *volatile ffts_wisdom_lock;
+
+static void
+ffts_wisdom_acquire(void)
+{
+    while (!ffts_atomic_cas_ptr(&ffts_wisdom_lock, NULL, (void*) &ffts_wisdom_lock));
+}
+
+static void
+ffts_wisdom_release(void)
+{
+    ffts_atomic_cas_ptr(&ffts_wisdom_lock, (void*) &ffts_wisdom_lock, NULL);
+}
+
+/* must be called with the lock held */
+static ffts_wisdom_t*
+ffts_wisdom_find(size_t N, int sign, unsigned int engine)
+{
+    size_t i;
+
+    for (i = 0; i < ffts_wisdom_count; i++) {
+        if (ffts_wisdom[i].N == N && ffts_wisdom[i].sign == sign &&
+                ffts_wisdom[i].engine == engine) {
+            return &ffts_wisdom[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* must be called with the lock held */
+static int
+ffts_wisdom_add(size_t N, int sign, unsigned int engine, unsigned int flags)
+{
+    ffts_wisdom_t *w = ffts_wisdom_find(N, sign, engine);
+
+    if (!w) {
+        if (ffts_wisdom_count == ffts_wisdom_capacity) {
+            size_t capacity = ffts_wisdom_capacity ? 2 * ffts_wisdom_capacity : 16;
+
+            w = (ffts_wisdom_t*) realloc(ffts_wisdom, capacity * sizeof(*w));
+            if (!w) {
+                return -1;
+            }
+
+            ffts_wisdom = w;
+            ffts_wisdom_capacity = capacity;
+        }
+
+        w = &ffts_wisdom[ffts_wisdom_count++];
+        w->N = N;
+        w->sign = sign;
+        w->engine = engine;
+    }
+
+    w->flags = flags;
+    return 0;
+}
+
+static double
+ffts_measure_seconds(void)
+{
+#if defined(_WIN32) || defined(WIN32)
+    LARGE_INTEGER count, frequency;
+
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double) count.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + 1e-9 * (double) ts.tv_nsec;
+#endif
+}
+
+/* returns the best time per transform */
+static double
+ffts_measure_plan(ffts_plan_t *p, const float *in, float *out)
+{
+    double best, t;
+    size_t i, reps;
+    int round;
+
+    /* warm up caches and page in the code */
+    p->transform(p, in, out);
+
+    /* find a number of repetitions the timer can resolve */
+    for (reps = 1; ; reps *= 2) {
+        t = ffts_measure_seconds();
+        for (i = 0; i < reps; i++) {
+            p->transform(p, in, out);
+        }
+        t = ffts_measure_seconds() - t;
+
+        if (t >= FFTS_MEASURE_MIN_TIME || reps >= ((size_t) 1 << 20)) {
+            break;
+        }
+    }
+
+    best = t;
+    for (round = 1; round < FFTS_MEASURE_ROUNDS; round++) {
+        t = ffts_measure_seconds();
+        for (i = 0; i < reps; i++) {
+            p->transform(p, in, out);
+        }
+        t = ffts_measure_seconds() - t;
+
+        if (t < best) {
+            best = t;
+        }
+    }
+
+    return best / (double) reps;
+}
+
+/* the configurations of N that use engine, or all if it is zero */
+static unsigned int
+ffts_measure_candidates(size_t N, unsigned int engine, unsigned int *candidates)
+{
+    unsigned int direct = 0;
+    unsigned int i, n = 0;
+
+    if (N >= FFTS_SIX_STEP_MIN_N) {
+        direct = FFTS_INTERNAL_DIRECT;
+    }
+
+#if !defined(DYNAMIC_DISABLED) && !defined(__arm__)
+    candidates[n++] = FFTS_FLAG_ENGINE_JIT | direct;
+
+    /* larger sizes are always generated as subroutines */
+    if (N <= FFTS_STRAIGHT_LINE_MAX_N) {
+        candidates[n++] = FFTS_FLAG_ENGINE_JIT | FFTS_INTERNAL_COMPACT | direct;
+    }
+
+    candidates[n++] = FFTS_FLAG_ENGINE_STATIC | direct;
+
+    if (direct) {
+        candidates[n++] = FFTS_FLAG_ENGINE_JIT | FFTS_INTERNAL_SIX_STEP;
+        candidates[n++] = FFTS_FLAG_ENGINE_STATIC | FFTS_INTERNAL_SIX_STEP;
+    }
+#else
+    if (direct) {
+        candidates[n++] = direct;
+        candidates[n++] = FFTS_INTERNAL_SIX_STEP;
+    }
+#endif
+
+    /* the precompiled transforms are in place of either engine */
+    if (!engine && N >= FFTS_SMALL_MIN_N && N <= FFTS_SMALL_MAX_N) {
+        candidates[n++] = FFTS_INTERNAL_SMALL;
+    }
+
+    if (engine) {
+        unsigned int k = 0;
+
+        for (i = 0; i < n; i++) {
+            if (!(candidates[i] & FFTS_MEASURE_ENGINES & ~engine)) {
+                candidates[k++] = candidates[i];
+            }
+        }
+
+        n = k;
+    }
+
+    return n;
+}
+
+unsigned int
+ffts_measure_1d(size_t N, int sign, unsigned int flags)
+{
+    unsigned int candidates[8];
+    unsigned int best_flags, engine, i, n;
+    ffts_wisdom_t *w;
+    double best_time;
+    float *in, *out;
+
+    /* only power of two sizes from 32 up have a choice, other sizes
+       keep the flag for their sub-plans */
+    if (N < 32 || (N & (N - 1))) {
+        return flags;
+    }
+
+    /* an engine that is asked for is kept, the rest is measured. The
+       static engine wins if both are given, as it does without measuring */
+    engine = flags & FFTS_MEASURE_ENGINES;
+    if (engine & FFTS_FLAG_ENGINE_STATIC) {
+        engine = FFTS_FLAG_ENGINE_STATIC;
+    }
+
+    flags &= ~(FFTS_FLAG_MEASURE | FFTS_MEASURE_FLAGS);
+    flags |= engine;
+
+    ffts_wisdom_acquire();
+    w = ffts_wisdom_find(N, sign, engine);
+    best_flags = w ? w->flags : 0;
+    ffts_wisdom_release();
+
+    if (w) {
+        return flags | best_flags;
+    }
+
+    n = ffts_measure_candidates(N, engine, candidates);
+    if (n < 2) {
+        return flags | (n ? candidates[0] : 0);
+    }
+
+    in = (float*) ffts_aligned_malloc(2 * N * sizeof(*in));
+    out = (float*) ffts_aligned_malloc(2 * N * sizeof(*out));
+    if (!in || !out) {
+        goto cleanup;
+    }
+
+    /* avoid denormals which would distort the timing */
+    for (i = 0; i < 2 * N; i++) {
+        in[i] = (float) (i % 7) - 3.0f;
+    }
+
+    /* the candidates are timed with the other flags of the plan, which
+       change how each of them runs (prefetching, streaming, twiddles,
+       threads). Generating code in the background would time the static
+       transform instead */
+    best_time = 0.0;
+    for (i = 0; i < n; i++) {
+        ffts_plan_t *p = ffts_init_1d_32f(N, sign,
+            (flags & ~FFTS_FLAG_BACKGROUND_JIT) | candidates[i]);
+        double t;
+
+        if (!p) {
+            continue;
+        }
+
+        t = ffts_measure_plan(p, in, out);
+        if (!best_flags || t < best_time) {
+            best_flags = candidates[i];
+            best_time = t;
+        }
+
+        ffts_free(p);
+    }
+
+    if (best_flags) {
+        ffts_wisdom_acquire();
+        ffts_wisdom_add(N, sign, engine, best_flags);
+        ffts_wisdom_release();
+    }
+
+cleanup:
+    if (out) {
+        ffts_aligned_free(out);
+    }
+
+    if (in) {
+        ffts_aligned_free(in);
+    }
+
+    return flags | best_flags;
+}
+
+/* writes the names of flags joined by '+' to line, returns their length */
+static int
+ffts_wisdom_format(char *line, size_t size, unsigned int flags)
+{
+    size_t i;
+    int n = 0;
+
+    for (i = 0; i < FFTS_WISDOM_NAMES; i++) {
+        if (flags & ffts_wisdom_names[i].flag) {
+            n += snprintf(line + n, size - n, "%s%s",
+                n ? "+" : "", ffts_wisdom_names[i].name);
+        }
+    }
+
+    return n;
+}
+
+/* returns the flags named in names, or zero if one is unknown */
+static unsigned int
+ffts_wisdom_parse(char *names)
+{
+    unsigned int flags = 0;
+    char *name, *next;
+    size_t i;
+
+    for (name = names; name; name = next) {
+        next = strchr(name, '+');
+        if (next) {
+            *next++ = '\0';
+        }
+
+        for (i = 0; i < FFTS_WISDOM_NAMES; i++) {
+            if (!strcmp(name, ffts_wisdom_names[i].name)) {
+                break;
+            }
+        }
+
+        if (i == FFTS_WISDOM_NAMES) {
+            return 0;
+        }
+
+        flags |= ffts_wisdom_names[i].flag;
+    }
+
+    return flags;
+}
+
+FFTS_API size_t
+ffts_export_wisdom(char *buffer, size_t size)
+{
+    size_t i, copied, length;
+    char line[128];
+    int n;
+
+    /* whole lines are copied while they fit, the length is that of all */
+    copied = 0;
+    length = strlen(FFTS_WISDOM_HEADER);
+    if (buffer && size > length) {
+        memcpy(buffer, FFTS_WISDOM_HEADER, length);
+        copied = length;
+    }
+
+    ffts_wisdom_acquire();
+    for (i = 0; i < ffts_wisdom_count; i++) {
+        n = snprintf(line, sizeof(line), "%lu %d ",
+            (unsigned long) ffts_wisdom[i].N, ffts_wisdom[i].sign);
+
+        if (ffts_wisdom[i].engine) {
+            n += ffts_wisdom_format(line + n, sizeof(line) - n,
+                ffts_wisdom[i].engine);
+        } else {
+            n += snprintf(line + n, sizeof(line) - n, "any");
+        }
+
+        line[n++] = ' ';
+        n += ffts_wisdom_format(line + n, sizeof(line) - n,
+            ffts_wisdom[i].flags);
+        line[n++] = '\n';
+
+        if (buffer && copied == length && size > length + n) {
+            memcpy(buffer + length, line, n);
+            copied += n;
+        }
+
+        length += n;
+    }
+    ffts_wisdom_release();
+
+    if (buffer && size) {
+        buffer[copied] = '\0';
+    }
+
+    return length;
+}
+
+FFTS_API int
+ffts_import_wisdom(const char *wisdom)
+{
+    size_t length = strlen(FFTS_WISDOM_HEADER);
+    char engine_names[16], names[64];
+    unsigned int engine, flags;
+    unsigned long N;
+    int n, sign;
+
+    if (!wisdom || strncmp(wisdom, FFTS_WISDOM_HEADER, length)) {
+        return -1;
+    }
+
+    wisdom += length;
+
+    ffts_wisdom_acquire();
+    while (sscanf(wisdom, "%lu %d %15s %63s\n%n",
+            &N, &sign, engine_names, names, &n) == 4) {
+        if (N < 32 || (N & (N - 1)) || (sign != -1 && sign != 1)) {
+            break;
+        }
+
+        if (!strcmp(engine_names, "any")) {
+            engine = 0;
+        } else {
+            engine = ffts_wisdom_parse(engine_names);
+            if (engine != FFTS_FLAG_ENGINE_JIT &&
+                    engine != FFTS_FLAG_ENGINE_STATIC) {
+                break;
+            }
+        }
+
+        /* the choice of an engine that was asked for uses that */
+        flags = ffts_wisdom_parse(names);
+        if (!flags || (engine && (flags & FFTS_MEASURE_ENGINES & ~engine))) {
+            break;
+        }
+
+        if (ffts_wisdom_add((size_t) N, sign, engine, flags)) {
+            break;
+        }
+
+        wisdom += n;
+    }
+    ffts_wisdom_release();
+
+    return *wisdom ? -1 : 0;
+}
+
+FFTS_API void
+ffts_forget_wisdom(void)
+{
+    ffts_wisdom_acquire();
+    free(ffts_wisdom);
+    ffts_wisdom = NULL;
+    ffts_wisdom_count = 0;
+    ffts_wisdom_capacity = 0;
+    ffts_wisdom_release();
+}
@@ -47,7 +47,7 @@ ffts_free_nd(ffts_plan_t *p)
 
             if (plan) {
                 for (j = 0; j < i; j++) {
-                    if (p->Ns[i] == p->Ns[j]) {
+                    if (p->plans[j] == plan) {
                         plan = NULL;
                         break;
                     }
@@ -106,6 +106,43 @@ ffts_execute_nd(ffts_plan_t *p, const void *in, void *out)
     }
 }
 
+/* the last dimension scales its output, with a sub-plan of its own if
+   shared with another dimension */
+static int
+ffts_set_scale_nd(ffts_plan_t *p, float scale)
+{
+    ffts_plan_t *plan = p->plans[p->rank - 1];
+    int i, shared = 0;
+
+    for (i = 0; i < p->rank - 1; i++) {
+        if (p->plans[i] == plan) {
+            shared = 1;
+        }
+    }
+
+    if (shared) {
+        if (scale == 1.0f) {
+            return 0;
+        }
+
+        plan = ffts_init_1d(p->Ns[p->rank - 1], p->sign);
+        if (!plan) {
+            return -1;
+        }
+    }
+
+    if (ffts_set_scale(plan, scale)) {
+        if (shared) {
+            ffts_free(plan);
+        }
+
+        return -1;
+    }
+
+    p->plans[p->rank - 1] = plan;
+    return 0;
+}
+
 FFTS_API ffts_plan_t*
 ffts_init_nd(int rank, size_t *Ns, int sign)
 {
@@ -128,7 +165,9 @@ ffts_init_nd(int rank, size_t *Ns, int sign)
 
     p->transform = &ffts_execute_nd;
     p->destroy   = &ffts_free_nd;
+    p->set_scale = &ffts_set_scale_nd;
     p->rank      = rank;
+    p->sign      = sign;
 
     p->Ms = malloc(rank * sizeof(*p->Ms));
     if (!p->Ms) {
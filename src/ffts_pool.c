@@ -0,0 +1,155 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ffts_pool.h"
+
+#ifdef FFTS_HAVE_POOL
+typedef struct _ffts_pool_t {
+    ffts_mutex_t mutex;
+
+    /* the workers wait for a job to join */
+    ffts_cond_t wake;
+
+    /* the caller waits for the workers to leave its job */
+    ffts_cond_t done;
+
+    ffts_pool_job_t *job;
+    size_t n_workers;
+} ffts_pool_t;
+
+static ffts_pool_t ffts_pool;
+static void *volatile ffts_pool_lock;
+static int ffts_pool_state;
+
+/* workers run until the process exits */
+static FFTS_THREAD_FUNC(ffts_pool_worker, arg)
+{
+    ffts_pool_t *pool = (ffts_pool_t*) arg;
+
+    ffts_mutex_lock(&pool->mutex);
+
+    for (;;) {
+        ffts_pool_job_t *job = pool->job;
+        size_t participant;
+
+        if (!job || job->joined >= job->n_participants) {
+            ffts_cond_wait(&pool->wake, &pool->mutex);
+            continue;
+        }
+
+        participant = job->joined++;
+        job->active++;
+        ffts_mutex_unlock(&pool->mutex);
+
+        job->run(job, participant);
+
+        ffts_mutex_lock(&pool->mutex);
+        if (!--job->active) {
+            ffts_cond_broadcast(&pool->done);
+        }
+    }
+
+    FFTS_THREAD_RETURN;
+}
+
+/* returns the pool once its mutex and condition variables exist */
+static ffts_pool_t*
+ffts_pool_get(void)
+{
+    ffts_pool_t *pool = &ffts_pool;
+
+    while (!ffts_atomic_cas_ptr(&ffts_pool_lock, NULL, (void*) &ffts_pool_lock));
+
+    if (!ffts_pool_state) {
+        ffts_pool_state = -1;
+
+        if (!ffts_mutex_init(&pool->mutex)) {
+            if (!ffts_cond_init(&pool->wake)) {
+                if (!ffts_cond_init(&pool->done)) {
+                    ffts_pool_state = 1;
+                }
+            }
+        }
+    }
+
+    ffts_atomic_cas_ptr(&ffts_pool_lock, (void*) &ffts_pool_lock, NULL);
+    return (ffts_pool_state > 0) ? pool : NULL;
+}
+
+void
+ffts_pool_run(ffts_pool_job_t *job)
+{
+    ffts_pool_t *pool = (job->n_participants > 1) ? ffts_pool_get() : NULL;
+
+    if (!pool) {
+        job->run(job, 0);
+        return;
+    }
+
+    ffts_mutex_lock(&pool->mutex);
+
+    if (pool->job) {
+        ffts_mutex_unlock(&pool->mutex);
+        job->run(job, 0);
+        return;
+    }
+
+    /* workers are only added, a failure to start one limits the pool */
+    while (pool->n_workers + 1 < job->n_participants &&
+            pool->n_workers + 1 < FFTS_PARALLEL_MAX_THREADS) {
+        ffts_thread_t thread;
+
+        if (ffts_thread_create(&thread, ffts_pool_worker, pool)) {
+            break;
+        }
+
+        ffts_thread_detach(thread);
+        pool->n_workers++;
+    }
+
+    job->joined = 1;
+    job->active = 0;
+    pool->job = job;
+    ffts_cond_broadcast(&pool->wake);
+    ffts_mutex_unlock(&pool->mutex);
+
+    job->run(job, 0);
+
+    ffts_mutex_lock(&pool->mutex);
+    pool->job = NULL;
+    while (job->active) {
+        ffts_cond_wait(&pool->done, &pool->mutex);
+    }
+    ffts_mutex_unlock(&pool->mutex);
+}
+#endif
@@ -0,0 +1,71 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef FFTS_POOL_H
+#define FFTS_POOL_H
+
+#if defined (_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "ffts_internal.h"
+#include "ffts_thread.h"
+
+#include <stddef.h>
+
+/* Process wide pool of worker threads, started on first use and kept
+   for the following jobs. FFTS_HAVE_POOL is defined when available. */
+#if defined(FFTS_HAVE_THREADS) && defined(FFTS_HAVE_ATOMIC_CAS)
+#define FFTS_HAVE_POOL
+
+typedef struct _ffts_pool_job_t ffts_pool_job_t;
+
+struct _ffts_pool_job_t {
+    /* called once by every participant, the caller being participant 0,
+       the others may join late or not at all */
+    void (*run)(ffts_pool_job_t *job, size_t participant);
+    size_t n_participants;
+
+    /* owned by the pool */
+    size_t joined;
+    size_t active;
+};
+
+/* Runs the job on the calling thread and up to n_participants - 1
+   workers, returns when all of them have left. A job started while the
+   pool is busy with another one runs on the calling thread only. */
+void
+ffts_pool_run(ffts_pool_job_t *job);
+#endif
+
+#endif /* FFTS_POOL_H */
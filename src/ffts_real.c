@@ -79,6 +79,132 @@ ffts_free_1d_real(ffts_plan_t *p)
     free(p);
 }
 
+/* rearrange the forward table in the order the generated split step reads it,
+   see generate_real_split */
+static float*
+ffts_generate_table_1d_real_split(const float *A, const float *B, size_t N)
+{
+    float *table;
+    size_t i, j, k;
+
+    table = (float*) ffts_aligned_malloc((2 * N + 8) * sizeof(float));
+    if (!table) {
+        return NULL;
+    }
+
+    for (i = 0, k = 0; k < N/4; i += 16, k += 2) {
+        for (j = 0; j < 4; j++) {
+            table[i + j + 0] = A[2*k + j];
+            table[i + j + 4] = B[2*k + j];
+        }
+
+        /* mirrored pair, the element at N/2 is shared with the first */
+        if (k) {
+            table[i +  8] = A[N - 2*k + 0];
+            table[i +  9] = A[N - 2*k + 1];
+            table[i + 12] = B[N - 2*k + 0];
+            table[i + 13] = B[N - 2*k + 1];
+        } else {
+            table[i +  8] =  0.5f;
+            table[i +  9] =  0.5f;
+            table[i + 12] =  0.5f;
+            table[i + 13] = -0.5f;
+        }
+
+        table[i + 10] = A[N - 2*k - 2];
+        table[i + 11] = A[N - 2*k - 1];
+        table[i + 14] = B[N - 2*k - 2];
+        table[i + 15] = B[N - 2*k - 1];
+    }
+
+    /* the middle element */
+    table[i + 0] = A[N/2 + 0];
+    table[i + 1] = A[N/2 + 1];
+    table[i + 2] = table[i + 3] = 0.0f;
+    table[i + 4] = B[N/2 + 0];
+    table[i + 5] = B[N/2 + 1];
+    table[i + 6] = table[i + 7] = 0.0f;
+
+    return table;
+}
+
+static void
+ffts_execute_1d_real_split(ffts_plan_t *p, const void *input, void *output)
+{
+    /* the split step is part of the generated transform */
+    p->plans[0]->transform(p->plans[0], input, output);
+}
+
+/* the vectorized split steps take 16 floats of each half at a time */
+#define FFTS_REAL_VECTOR_SIZE(N) ((N) <= 8 || !((N) & 15))
+
+static void
+ffts_split_1d_real(float *const FFTS_RESTRICT out,
+                   const float *const FFTS_RESTRICT buf,
+                   const float *const FFTS_RESTRICT A,
+                   const float *const FFTS_RESTRICT B,
+                   const int N)
+{
+    int i;
+
+    for (i = 0; i < N/2; i++) {
+        out[2*i + 0] =
+            buf[    2*i + 0] * A[2*i + 0] - buf[    2*i + 1] * A[2*i + 1] +
+            buf[N - 2*i + 0] * B[2*i + 0] + buf[N - 2*i + 1] * B[2*i + 1];
+        out[2*i + 1] =
+            buf[    2*i + 1] * A[2*i + 0] + buf[    2*i + 0] * A[2*i + 1] +
+            buf[N - 2*i + 0] * B[2*i + 1] - buf[N - 2*i + 1] * B[2*i + 0];
+    }
+}
+
+static void
+ffts_split_1d_real_inv(float *const FFTS_RESTRICT buf,
+                       const float *const FFTS_RESTRICT in,
+                       const float *const FFTS_RESTRICT A,
+                       const float *const FFTS_RESTRICT B,
+                       const int N)
+{
+    int i;
+
+    for (i = 0; i < N/2; i++) {
+        buf[2*i + 0] =
+            in[    2*i + 0] * A[2*i + 0] + in[    2*i + 1] * A[2*i + 1] +
+            in[N - 2*i + 0] * B[2*i + 0] - in[N - 2*i + 1] * B[2*i + 1];
+        buf[2*i + 1] =
+            in[    2*i + 1] * A[2*i + 0] - in[    2*i + 0] * A[2*i + 1] -
+            in[N - 2*i + 0] * B[2*i + 1] - in[N - 2*i + 1] * B[2*i + 0];
+    }
+}
+
+/* sizes the vectorized split steps don't take */
+static void
+ffts_execute_1d_real_generic(ffts_plan_t *p, const void *input, void *output)
+{
+    float *const out = (float*) output;
+    float *const buf = (float*) p->buf;
+    const int N = (const int) p->N;
+
+    p->plans[0]->transform(p->plans[0], input, buf);
+
+    buf[N + 0] = buf[0];
+    buf[N + 1] = buf[1];
+
+    ffts_split_1d_real(out, buf, p->A, p->B, N);
+
+    out[N + 0] = p->scale * (buf[0] - buf[1]);
+    out[N + 1] = 0.0f;
+}
+
+static void
+ffts_execute_1d_real_inv_generic(ffts_plan_t *p, const void *input, void *output)
+{
+    float *const buf = (float*) p->buf;
+
+    ffts_split_1d_real_inv(buf, (const float*) input, p->A, p->B, (int) p->N);
+
+    p->plans[0]->transform(p->plans[0], buf, output);
+}
+
 static void
 ffts_execute_1d_real(ffts_plan_t *p, const void *input, void *output)
 {
@@ -328,17 +454,10 @@ ffts_execute_1d_real(ffts_plan_t *p, const void *input, void *output)
         }
     }
 #else
-    for (i = 0; i < N/2; i++) {
-        out[2*i + 0] =
-            buf[    2*i + 0] * A[2*i + 0] - buf[    2*i + 1] * A[2*i + 1] +
-            buf[N - 2*i + 0] * B[2*i + 0] + buf[N - 2*i + 1] * B[2*i + 1];
-        out[2*i + 1] =
-            buf[    2*i + 1] * A[2*i + 0] + buf[    2*i + 0] * A[2*i + 1] +
-            buf[N - 2*i + 0] * B[2*i + 1] - buf[N - 2*i + 1] * B[2*i + 0];
-    }
+    ffts_split_1d_real(out, buf, A, B, N);
 #endif
 
-    out[N + 0] = buf[0] - buf[1];
+    out[N + 0] = p->scale * (buf[0] - buf[1]);
     out[N + 1] = 0.0f;
 }
 
@@ -586,19 +705,96 @@ ffts_execute_1d_real_inv(ffts_plan_t *p, const void *input, void *output)
         }
     }
 #else
-    for (i = 0; i < N/2; i++) {
-        buf[2*i + 0] =
-            in[    2*i + 0] * A[2*i + 0] + in[    2*i + 1] * A[2*i + 1] +
-            in[N - 2*i + 0] * B[2*i + 0] - in[N - 2*i + 1] * B[2*i + 1];
-        buf[2*i + 1] =
-            in[    2*i + 1] * A[2*i + 0] - in[    2*i + 0] * A[2*i + 1] -
-            in[N - 2*i + 0] * B[2*i + 1] - in[N - 2*i + 1] * B[2*i + 0];
-    }
+    ffts_split_1d_real_inv(buf, in, A, B, N);
 #endif
 
     p->plans[0]->transform(p->plans[0], buf, output);
 }
 
+/* builds the tables of a plan of sign with the factor of ffts_set_scale
+   folded in, replacing the previous ones */
+static int
+ffts_generate_tables_1d_real(ffts_plan_t *p, int sign, float scale)
+{
+    float *A = p->A;
+    float *B = p->B;
+    size_t i, N = p->N;
+
+    p->A = (float*) ffts_aligned_malloc(N * sizeof(float));
+    p->B = (float*) ffts_aligned_malloc(N * sizeof(float));
+    if (!p->A || !p->B) {
+        goto cleanup;
+    }
+
+    if (p->plans[0]->flags & FFTS_INTERNAL_REAL_SPLIT) {
+        float *table;
+
+        ffts_generate_table_1d_real_32f(p, sign, 0);
+
+        table = ffts_generate_table_1d_real_split(p->A, p->B, N);
+        if (!table) {
+            goto cleanup;
+        }
+
+        for (i = 0; i < 2 * N + 8; i++) {
+            table[i] *= scale;
+        }
+
+        ffts_aligned_free(p->B);
+        ffts_aligned_free(p->A);
+        p->B = NULL;
+
+        /* the generated code reads the table through the sub-plan */
+        p->A = p->plans[0]->A = table;
+    } else {
+#ifdef HAVE_SSE3
+        ffts_generate_table_1d_real_32f(p, sign, FFTS_REAL_VECTOR_SIZE(N));
+#else
+        ffts_generate_table_1d_real_32f(p, sign, 0);
+#endif
+
+        for (i = 0; i < N; i++) {
+            p->A[i] *= scale;
+            p->B[i] *= scale;
+        }
+    }
+
+    if (B) {
+        ffts_aligned_free(B);
+    }
+
+    if (A) {
+        ffts_aligned_free(A);
+    }
+
+    p->scale = scale;
+    return 0;
+
+cleanup:
+    if (p->B) {
+        ffts_aligned_free(p->B);
+    }
+
+    if (p->A) {
+        ffts_aligned_free(p->A);
+    }
+
+    p->A = A;
+    p->B = B;
+    return -1;
+}
+
+/* the split step of the forward transform scales the output, and that of
+   the inverse its input */
+static int
+ffts_set_scale_1d_real(ffts_plan_t *p, float scale)
+{
+    int sign = (p->transform == &ffts_execute_1d_real_inv ||
+        p->transform == &ffts_execute_1d_real_inv_generic) ? 1 : -1;
+
+    return ffts_generate_tables_1d_real(p, sign, scale);
+}
+
 FFTS_API ffts_plan_t*
 ffts_init_1d_real(size_t N, int sign)
 {
@@ -610,45 +806,47 @@ ffts_init_1d_real(size_t N, int sign)
     }
 
     if (sign < 0) {
-        p->transform = &ffts_execute_1d_real;
+        if (FFTS_REAL_VECTOR_SIZE(N)) {
+            p->transform = &ffts_execute_1d_real;
+        } else {
+            p->transform = &ffts_execute_1d_real_generic;
+        }
     } else {
-        p->transform = &ffts_execute_1d_real_inv;
+        if (FFTS_REAL_VECTOR_SIZE(N)) {
+            p->transform = &ffts_execute_1d_real_inv;
+        } else {
+            p->transform = &ffts_execute_1d_real_inv_generic;
+        }
     }
 
-    p->destroy = &ffts_free_1d_real;
-    p->N       = N;
-    p->rank    = 1;
-    p->plans   = (ffts_plan_t**) &p[1];
+    p->destroy   = &ffts_free_1d_real;
+    p->set_scale = &ffts_set_scale_1d_real;
+    p->N         = N;
+    p->rank      = 1;
+    p->plans     = (ffts_plan_t**) &p[1];
 
-    p->plans[0] = ffts_init_1d(N/2, sign);
+    p->plans[0] = ffts_init_1d_32f(N/2, sign, FFTS_INTERNAL_REAL_SPLIT);
     if (!p->plans[0]) {
         goto cleanup;
     }
 
-    p->buf = ffts_aligned_malloc(2 * ((N/2) + 1) * sizeof(float));
-    if (!p->buf) {
+    if (ffts_generate_tables_1d_real(p, sign, 1.0f)) {
         goto cleanup;
     }
 
-    p->A = (float*) ffts_aligned_malloc(N * sizeof(float));
-    if (!p->A) {
-        goto cleanup;
+    if (p->plans[0]->flags & FFTS_INTERNAL_REAL_SPLIT) {
+        p->transform = &ffts_execute_1d_real_split;
+        return p;
     }
 
-    p->B = (float*) ffts_aligned_malloc(N * sizeof(float));
-    if (!p->B) {
+    p->buf = ffts_aligned_malloc(2 * ((N/2) + 1) * sizeof(float));
+    if (!p->buf) {
         goto cleanup;
     }
 
-#ifdef HAVE_SSE3
-    ffts_generate_table_1d_real_32f(p, sign, 1);
-#else
-    ffts_generate_table_1d_real_32f(p, sign, 0);
-#endif
-
     return p;
 
 cleanup:
     ffts_free_1d_real(p);
     return NULL;
-}
\ No newline at end of file
+}
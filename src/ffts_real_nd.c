@@ -36,6 +36,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ffts_internal.h"
 #include "ffts_transpose.h"
 
+#define TSIZE 8
+
 static void
 ffts_free_nd_real(ffts_plan_t *p)
 {
@@ -47,7 +49,7 @@ ffts_free_nd_real(ffts_plan_t *p)
 
 			if (plan) {
 				for (j = 0; j < i; j++) {
-					if (p->Ns[i] == p->Ns[j]) {
+					if (p->plans[j] == plan) {
 						plan = NULL;
 						break;
 					}
@@ -62,6 +64,10 @@ ffts_free_nd_real(ffts_plan_t *p)
         free(p->plans);
     }
 
+    if (p->transpose_buf) {
+        ffts_aligned_free(p->transpose_buf);
+    }
+
     if (p->buf) {
         ffts_aligned_free(p->buf);
     }
@@ -83,32 +89,56 @@ ffts_execute_nd_real(ffts_plan_t *p, const void *in, void *out)
     const size_t Ms0 = p->Ms[0];
     const size_t Ns0 = p->Ns[0];
 
-    uint32_t *din = (uint32_t*) in;
-    uint64_t *buf = p->buf;
-    uint64_t *dout = (uint64_t*) out;
+    /* row length of the real-to-complex output, padded to keep 16 byte alignment */
+    const size_t Ws0 = Ms0 / 2 + 1;
+    const size_t stride0 = (Ws0 + 1) & ~((size_t) 1);
+
+    const float *din = (const float*) in;
+    uint64_t *tile = (uint64_t*) p->transpose_buf;
+    uint64_t *dst, *src;
 
     ffts_plan_t *plan;
     int i;
-    size_t j;
+    size_t j, k, h;
+
+    /* alternate between buffers so that the last dimension lands in output */
+    dst = (p->rank & 1) ? (uint64_t*) out : (uint64_t*) p->buf;
 
+    /* transform a tile of rows at a time and write them out transposed,
+       so that each dimension is a single pass over memory */
     plan = p->plans[0];
-    for (j = 0; j < Ns0; j++) {
-        plan->transform(plan, din + (j * Ms0), buf + (j * (Ms0 / 2 + 1)));
-    }
+    for (j = 0; j < Ns0; j += TSIZE) {
+        h = (Ns0 - j < TSIZE) ? Ns0 - j : TSIZE;
 
-    ffts_transpose(buf, dout, Ms0 / 2 + 1, Ns0);
+        for (k = 0; k < h; k++) {
+            plan->transform(plan, din + (j + k) * Ms0, tile + k * stride0);
+        }
+
+        ffts_transpose_block(tile, stride0, dst + j, Ns0, Ws0, h);
+    }
 
     for (i = 1; i < p->rank; i++) {
         const size_t Ms = p->Ms[i];
         const size_t Ns = p->Ns[i];
 
+        /* the rows of the tile are padded like those of the first dimension,
+           the rows of src are not. An odd Ms leaves them 8 byte aligned, but
+           the sub-plans of odd lengths are chirp-z plans, which accept that */
+        const size_t stride = (Ms + 1) & ~((size_t) 1);
+
+        src = dst;
+        dst = (src == (uint64_t*) out) ? (uint64_t*) p->buf : (uint64_t*) out;
         plan = p->plans[i];
 
-        for (j = 0; j < Ns; j++) {
-            plan->transform(plan, dout + (j * Ms), buf + (j * Ms));
-        }
+        for (j = 0; j < Ns; j += TSIZE) {
+            h = (Ns - j < TSIZE) ? Ns - j : TSIZE;
 
-        ffts_transpose(buf, dout, Ms, Ns);
+            for (k = 0; k < h; k++) {
+                plan->transform(plan, src + (j + k) * Ms, tile + k * stride);
+            }
+
+            ffts_transpose_block(tile, stride, dst + j, Ns, Ms, h);
+        }
     }
 }
 
@@ -120,37 +150,51 @@ ffts_execute_nd_real_inv(ffts_plan_t *p, const void *in, void *out)
     const size_t Ns0 = p->Ns[0];
     const size_t Ns1 = p->Ns[1];
 
-    uint64_t *din = (uint64_t*) in;
-    uint64_t *buf = p->buf;
-    uint64_t *buf2;
+    /* row length of the complex-to-real input, padded to keep 16 byte alignment */
+    const size_t stride = (Ms0 + 1) & ~((size_t) 1);
+
+    /* column length in the tiles, padded the same way */
+    const size_t stride0 = (Ns0 + 1) & ~((size_t) 1);
+
+    const uint64_t *din = (const uint64_t*) in;
+    uint64_t *buf = (uint64_t*) p->buf;
+    uint64_t *tile = (uint64_t*) p->transpose_buf;
+    uint64_t *tile2 = tile + TSIZE * stride0;
     float    *doutr = (float*) out;
 
     ffts_plan_t *plan;
-    size_t vol;
-
-    int i;
-    size_t j;
+    size_t j, k, w;
 
-    vol = p->Ns[0];
-    for (i = 1; i < p->rank; i++) {
-        vol *= p->Ns[i];
-    }
+    /* gather a tile of columns, transform and scatter them back */
+    plan = p->plans[0];
+    for (j = 0; j < Ms0; j += TSIZE) {
+        w = (Ms0 - j < TSIZE) ? Ms0 - j : TSIZE;
 
-    buf2 = buf + vol;
+        ffts_transpose_block(din + j, Ms0, tile, stride0, w, Ns0);
 
-    ffts_transpose(din, buf, Ms0, Ns0);
+        for (k = 0; k < w; k++) {
+            plan->transform(plan, tile + k * stride0, tile2 + k * stride0);
+        }
 
-    plan = p->plans[0];
-    for (j = 0; j < Ms0; j++) {
-        plan->transform(plan, buf + (j * Ns0), buf2 + (j * Ns0));
+        ffts_transpose_block(tile2, stride0, buf + j, stride, Ns0, w);
     }
 
-    ffts_transpose(buf2, buf, Ns0, Ms0);
-
     plan = p->plans[1];
     for (j = 0; j < Ms1; j++) {
-        plan->transform(plan, buf + (j * Ms0), &doutr[j * Ns1]);
+        plan->transform(plan, buf + j * stride, &doutr[j * Ns1]);
+    }
+}
+
+/* folded into the tables of the real sub-plan, which transforms the first
+   dimension of the forward plan and the last of the inverse */
+static int
+ffts_set_scale_nd_real(ffts_plan_t *p, float scale)
+{
+    if (p->transform == &ffts_execute_nd_real) {
+        return ffts_set_scale(p->plans[0], scale);
     }
+
+    return ffts_set_scale(p->plans[p->rank - 1], scale);
 }
 
 FFTS_API ffts_plan_t*
@@ -158,9 +202,17 @@ ffts_init_nd_real(int rank, size_t *Ns, int sign)
 {
     int i;
     size_t vol = 1;
-    size_t bufsize;
+    size_t bufsize, tilesize;
     ffts_plan_t *p;
 
+    if (!Ns || rank < 1) {
+        return NULL;
+    }
+
+    if (rank == 1) {
+        return ffts_init_1d_real(Ns[0], sign);
+    }
+
     p = (ffts_plan_t*) calloc(1, sizeof(*p));
     if (!p) {
         return NULL;
@@ -172,8 +224,9 @@ ffts_init_nd_real(int rank, size_t *Ns, int sign)
         p->transform = &ffts_execute_nd_real_inv;
     }
 
-    p->destroy = &ffts_free_nd_real;
-    p->rank    = rank;
+    p->destroy   = &ffts_free_nd_real;
+    p->set_scale = &ffts_set_scale_nd_real;
+    p->rank      = rank;
 
     p->Ms = (size_t*) malloc(rank * sizeof(*p->Ms));
     if (!p->Ms) {
@@ -194,7 +247,8 @@ ffts_init_nd_real(int rank, size_t *Ns, int sign)
     if (sign < 0) {
         bufsize = 2 * vol;
     } else {
-        bufsize = 2 * (Ns[0] * ((vol / Ns[0]) / 2 + 1) + vol);
+        /* rows are padded to keep them 16 byte aligned */
+        bufsize = 2 * Ns[0] * ((((vol / Ns[0]) / 2 + 1) + 1) & ~((size_t) 1));
     }
 
     p->buf = ffts_aligned_malloc(bufsize * sizeof(float));
@@ -251,6 +305,26 @@ ffts_init_nd_real(int rank, size_t *Ns, int sign)
         }
     }
 
+    /* tile buffer used for fused transform and transpose */
+    if (sign < 0) {
+        tilesize = ((p->Ms[0] / 2 + 1) + 1) & ~((size_t) 1);
+
+        for (i = 1; i < rank; i++) {
+            if (((p->Ms[i] + 1) & ~((size_t) 1)) > tilesize) {
+                tilesize = (p->Ms[i] + 1) & ~((size_t) 1);
+            }
+        }
+
+        tilesize *= TSIZE;
+    } else {
+        tilesize = 2 * TSIZE * ((p->Ns[0] + 1) & ~((size_t) 1));
+    }
+
+    p->transpose_buf = ffts_aligned_malloc(2 * tilesize * sizeof(float));
+    if (!p->transpose_buf) {
+        goto cleanup;
+    }
+
     return p;
 
 cleanup:
@@ -0,0 +1,664 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ffts_six_step.h"
+
+#include "ffts_pool.h"
+#include "ffts_trig.h"
+#include "macros.h"
+
+/*
+*  The six-step (or four-step) algorithm, see:
+*
+*  David H. Bailey, FFTs in external or hierarchical memory,
+*  The Journal of Supercomputing, vol. 4, pp. 23-35, 1990.
+*
+*  N = N1 * N2 is viewed as N1 rows of N2 columns. The first pass transforms
+*  the columns, FFTS_SIX_STEP_BLOCK at a time so each input cache line is
+*  used fully, and multiplies by the twiddle factors while the result is
+*  still in cache. The second pass transforms the other dimension the same
+*  way and writes the result transposed to the output. Each pass streams through memory once,
+*  and the sub-transforms of size ~sqrt(N) stay in cache.
+*
+*  With FFTS_FLAG_PARALLEL_EXECUTE the blocks of each pass are shared by
+*  the threads of the pool, each with its own transpose buffer.
+*
+*  With FFTS_FLAG_SCRAMBLED the forward transform leaves out the final
+*  transpose, and the inverse reads the rows of such a spectrum directly
+*  instead of transposing them first.
+*/
+
+/* columns per block, one cache line of complex floats */
+#define FFTS_SIX_STEP_BLOCK 8
+
+int
+ffts_six_step_preferred(size_t N)
+{
+    /* input and output of the transform no longer fit in the last level cache */
+    return N >= FFTS_SIX_STEP_MIN_N &&
+        2 * N * sizeof(ffts_cpx_32f) > ffts_cache_size();
+}
+
+static void
+ffts_six_step_free(ffts_plan_t *p)
+{
+    if (p->plans[1] && p->plans[1] != p->plans[0]) {
+        ffts_free(p->plans[1]);
+    }
+
+    if (p->plans[0]) {
+        ffts_free(p->plans[0]);
+    }
+
+    if (p->A) {
+        ffts_aligned_free(p->A);
+    }
+
+    if (p->transpose_buf) {
+        ffts_aligned_free(p->transpose_buf);
+    }
+
+    if (p->buf) {
+        ffts_aligned_free(p->buf);
+    }
+
+    free(p);
+}
+
+/* out[x * out_stride + y] = in[y * in_stride + x] for x < FFTS_SIX_STEP_BLOCK,
+   two rows at a time so each load and store moves two complex values */
+static void
+ffts_six_step_gather(const float *FFTS_RESTRICT in,
+                     size_t in_stride,
+                     float *FFTS_RESTRICT out,
+                     size_t out_stride,
+                     size_t h)
+{
+    size_t x, y;
+
+    for (y = 0; y < h; y += 2) {
+        const float *i0 = in + 2 * y * in_stride;
+        const float *i1 = i0 + 2 * in_stride;
+
+        for (x = 0; x < FFTS_SIX_STEP_BLOCK; x += 2) {
+            V4SF r0 = V4SF_LD(i0 + 2 * x);
+            V4SF r1 = V4SF_LD(i1 + 2 * x);
+
+            V4SF_ST(out + 2 * (x * out_stride + y), V4SF_UNPACK_LO(r0, r1));
+            V4SF_ST(out + 2 * ((x + 1) * out_stride + y), V4SF_UNPACK_HI(r0, r1));
+        }
+    }
+}
+
+/* out[x * out_stride + y] = in[y * in_stride + x] for y < FFTS_SIX_STEP_BLOCK,
+   writing one cache line to each output row, with non-temporal stores if
+   stream is set */
+static void
+ffts_six_step_scatter(const float *FFTS_RESTRICT in,
+                      size_t in_stride,
+                      float *FFTS_RESTRICT out,
+                      size_t out_stride,
+                      size_t w,
+                      int stream)
+{
+    size_t x, y;
+
+    for (x = 0; x < w; x += 2) {
+        float *o0 = out + 2 * x * out_stride;
+        float *o1 = o0 + 2 * out_stride;
+
+        for (y = 0; y < FFTS_SIX_STEP_BLOCK; y += 2) {
+            V4SF r0 = V4SF_LD(in + 2 * (y * in_stride + x));
+            V4SF r1 = V4SF_LD(in + 2 * ((y + 1) * in_stride + x));
+
+            if (stream) {
+                V4SF_STREAM(o0 + 2 * y, V4SF_UNPACK_LO(r0, r1));
+                V4SF_STREAM(o1 + 2 * y, V4SF_UNPACK_HI(r0, r1));
+            } else {
+                V4SF_ST(o0 + 2 * y, V4SF_UNPACK_LO(r0, r1));
+                V4SF_ST(o1 + 2 * y, V4SF_UNPACK_HI(r0, r1));
+            }
+        }
+    }
+}
+
+/* copies the n complex values of in to out with non-temporal stores */
+static void
+ffts_six_step_stream(const float *FFTS_RESTRICT in, float *FFTS_RESTRICT out, size_t n)
+{
+    size_t k;
+
+    for (k = 0; k < 2 * n; k += 4) {
+        V4SF_STREAM(out + k, V4SF_LD(in + k));
+    }
+}
+
+/* only the output is streamed, the sub-plans and buf stay in the cache.
+   The store callback reads the output while it is still there */
+static int
+ffts_six_step_streams(const ffts_plan_t *p)
+{
+    return (p->flags & FFTS_INTERNAL_STREAM) && !p->store;
+}
+
+/* gathers the columns i to i + FFTS_SIX_STEP_BLOCK - 1 of the n rows of
+   the input like ffts_six_step_gather, staging each row of the block in
+   stage through the load callback if set */
+static void
+ffts_six_step_load(const ffts_plan_t *p,
+                   const void *in,
+                   size_t in_stride,
+                   size_t i,
+                   uint64_t *FFTS_RESTRICT stage,
+                   uint64_t *FFTS_RESTRICT out,
+                   size_t n)
+{
+    size_t y;
+
+    if (!p->load) {
+        ffts_six_step_gather((const float*) ((const uint64_t*) in + i),
+            in_stride, (float*) out, n, n);
+        return;
+    }
+
+    for (y = 0; y < n; y++) {
+        p->load((float*) (stage + y * FFTS_SIX_STEP_BLOCK), in,
+            y * in_stride + i, FFTS_SIX_STEP_BLOCK, p->userdata);
+    }
+
+    ffts_six_step_gather((const float*) stage, FFTS_SIX_STEP_BLOCK,
+        (float*) out, n, n);
+}
+
+/* gives the columns i to i + FFTS_SIX_STEP_BLOCK - 1 of the n rows of the
+   output, just written by ffts_six_step_scatter, to the store callback */
+static void
+ffts_six_step_store(const ffts_plan_t *p,
+                    uint64_t *out,
+                    size_t out_stride,
+                    size_t i,
+                    size_t n)
+{
+    size_t x;
+
+    for (x = 0; x < n; x++) {
+        p->store((float*) (out + x * out_stride + i), x * out_stride + i,
+            FFTS_SIX_STEP_BLOCK, p->userdata);
+    }
+}
+
+/* multiply element k of a row of n by W^(r * k), W^m is composed of the
+   coarse table entry W^(m & ~mask) and the fine table entry W^(m & mask).
+   The coarse table carries the factor of ffts_set_scale, so the elements
+   with W^0 are only skipped if unscaled */
+static void
+ffts_six_step_twiddle(const ffts_plan_t *p, float *FFTS_RESTRICT row, size_t r, size_t n)
+{
+    const float *FFTS_RESTRICT coarse = p->A;
+    const float *FFTS_RESTRICT fine = p->B;
+    size_t mask = p->i2 - 1;
+    size_t shift = ffts_ctzl(p->i2);
+    size_t k, m, n_mask = p->N - 1;
+
+    k = (p->flags & FFTS_INTERNAL_SCALED) ? 0 : 1;
+    if (!r && k) {
+        return;
+    }
+
+    for (m = (k * r) & n_mask; k < n; k++, m = (m + r) & n_mask) {
+        const float *c = coarse + 2 * (m >> shift);
+        const float *f = fine + 2 * (m & mask);
+        float wr = c[0] * f[0] - c[1] * f[1];
+        float wi = c[0] * f[1] + c[1] * f[0];
+        float xr = row[2 * k + 0];
+        float xi = row[2 * k + 1];
+
+        row[2 * k + 0] = xr * wr - xi * wi;
+        row[2 * k + 1] = xr * wi + xi * wr;
+    }
+}
+
+/* transforms the columns i to i + FFTS_SIX_STEP_BLOCK - 1 of the input,
+   the twiddled results become the rows of buf */
+static void
+ffts_six_step_columns(ffts_plan_t *p, const void *in, void *out, uint64_t *tmp, size_t i)
+{
+    uint64_t *buf = (uint64_t*) p->buf;
+    ffts_plan_t *p1 = p->plans[0];
+    size_t N1 = p1->N;
+    size_t N2 = p->plans[1]->N;
+    uint64_t *tmp2 = tmp + FFTS_SIX_STEP_BLOCK * N2;
+    size_t j;
+
+    (void) out;
+
+    ffts_six_step_load(p, in, N2, i, tmp2, tmp, N1);
+
+    for (j = 0; j < FFTS_SIX_STEP_BLOCK; j++) {
+        uint64_t *row = buf + (i + j) * N1;
+
+        p1->transform(p1, tmp + j * N1, row);
+        ffts_six_step_twiddle(p, (float*) row, i + j, N1);
+    }
+}
+
+/* transforms the columns i to i + FFTS_SIX_STEP_BLOCK - 1 of buf, rows of
+   stride points, with plan and stores them as columns of the output */
+static void
+ffts_six_step_transpose(ffts_plan_t *p,
+                        ffts_plan_t *plan,
+                        size_t stride,
+                        void *out,
+                        uint64_t *tmp,
+                        size_t i)
+{
+    uint64_t *dout = (uint64_t*) out;
+    uint64_t *buf = (uint64_t*) p->buf;
+    uint64_t *tmp2 = tmp + FFTS_SIX_STEP_BLOCK * p->plans[1]->N;
+    size_t n = plan->N;
+    int stream = ffts_six_step_streams(p);
+    size_t j;
+
+    ffts_six_step_gather((const float*) (buf + i), stride, (float*) tmp, n, n);
+
+    for (j = 0; j < FFTS_SIX_STEP_BLOCK; j++) {
+        plan->transform(plan, tmp + j * n, tmp2 + j * n);
+    }
+
+    ffts_six_step_scatter((const float*) tmp2, n, (float*) (dout + i), stride, n, stream);
+
+    if (stream) {
+        V4SF_FENCE();
+    }
+
+    if (p->store) {
+        ffts_six_step_store(p, dout, stride, i, n);
+    }
+}
+
+/* the second pass of ffts_six_step_transform */
+static void
+ffts_six_step_rows(ffts_plan_t *p, const void *in, void *out, uint64_t *tmp, size_t i)
+{
+    (void) in;
+    ffts_six_step_transpose(p, p->plans[1], p->plans[0]->N, out, tmp, i);
+}
+
+/* each column of buf is transformed straight into its output row */
+static void
+ffts_six_step_rows_scrambled_f(ffts_plan_t *p,
+                               const void *in,
+                               void *out,
+                               uint64_t *tmp,
+                               size_t i)
+{
+    uint64_t *dout = (uint64_t*) out;
+    uint64_t *buf = (uint64_t*) p->buf;
+    ffts_plan_t *p2 = p->plans[1];
+    size_t N1 = p->plans[0]->N;
+    size_t N2 = p2->N;
+    uint64_t *tmp2 = tmp + FFTS_SIX_STEP_BLOCK * N2;
+    int stream = ffts_six_step_streams(p);
+    size_t j;
+
+    (void) in;
+
+    ffts_six_step_gather((const float*) (buf + i), N1, (float*) tmp, N2, N2);
+
+    for (j = 0; j < FFTS_SIX_STEP_BLOCK; j++) {
+        uint64_t *row = dout + (i + j) * N2;
+
+        if (stream) {
+            p2->transform(p2, tmp + j * N2, tmp2);
+            ffts_six_step_stream((const float*) tmp2, (float*) row, N2);
+        } else {
+            p2->transform(p2, tmp + j * N2, row);
+        }
+
+        if (p->store) {
+            p->store((float*) row, (i + j) * N2, N2, p->userdata);
+        }
+    }
+
+    if (stream) {
+        V4SF_FENCE();
+    }
+}
+
+/* the rows i to i + FFTS_SIX_STEP_BLOCK - 1 of a scrambled spectrum are
+   transformed in place of the first transpose */
+static void
+ffts_six_step_rows_scrambled_i(ffts_plan_t *p,
+                               const void *in,
+                               void *out,
+                               uint64_t *tmp,
+                               size_t i)
+{
+    const uint64_t *din = (const uint64_t*) in;
+    uint64_t *buf = (uint64_t*) p->buf;
+    ffts_plan_t *p2 = p->plans[1];
+    size_t N2 = p2->N;
+    size_t j;
+
+    (void) out;
+
+    for (j = i; j < i + FFTS_SIX_STEP_BLOCK; j++) {
+        uint64_t *row = buf + j * N2;
+
+        if (p->load) {
+            p->load((float*) tmp, in, j * N2, N2, p->userdata);
+            p2->transform(p2, tmp, row);
+        } else {
+            p2->transform(p2, din + j * N2, row);
+        }
+
+        ffts_six_step_twiddle(p, (float*) row, j, N2);
+    }
+}
+
+static void
+ffts_six_step_columns_scrambled_i(ffts_plan_t *p,
+                                  const void *in,
+                                  void *out,
+                                  uint64_t *tmp,
+                                  size_t i)
+{
+    (void) in;
+    ffts_six_step_transpose(p, p->plans[0], p->plans[1]->N, out, tmp, i);
+}
+
+typedef void (*ffts_six_step_block_t)(ffts_plan_t *p, const void *in, void *out,
+                                      uint64_t *tmp, size_t i);
+
+#ifdef FFTS_HAVE_POOL
+typedef struct _ffts_six_step_job_t {
+    ffts_pool_job_t job;
+    ffts_plan_t *p;
+    ffts_six_step_block_t block;
+    const void *in;
+    void *out;
+    size_t n;
+
+    /* first block not yet claimed */
+    volatile long next;
+} ffts_six_step_job_t;
+
+/* the blocks are claimed one at a time, so a participant joining late
+   or not at all leaves them to the others */
+static void
+ffts_six_step_job_run(ffts_pool_job_t *pool_job, size_t participant)
+{
+    ffts_six_step_job_t *job = (ffts_six_step_job_t*) pool_job;
+    ffts_plan_t *p = job->p;
+    uint64_t *tmp = (uint64_t*) p->transpose_buf +
+        participant * 2 * FFTS_SIX_STEP_BLOCK * p->plans[1]->N;
+    long i;
+
+    for (;;) {
+        i = ffts_atomic_add(&job->next, FFTS_SIX_STEP_BLOCK) - FFTS_SIX_STEP_BLOCK;
+        if (i >= (long) job->n) {
+            break;
+        }
+
+        job->block(p, job->in, job->out, tmp, (size_t) i);
+    }
+}
+#endif
+
+/* runs block for i = 0 to n - 1 in steps of FFTS_SIX_STEP_BLOCK, on the
+   threads of the pool for plans with several. A pass has ended for all
+   of them when this returns */
+static void
+ffts_six_step_pass(ffts_plan_t *p,
+                   ffts_six_step_block_t block,
+                   const void *in,
+                   void *out,
+                   size_t n)
+{
+    size_t i;
+
+#ifdef FFTS_HAVE_POOL
+    if (p->n_threads > 1) {
+        ffts_six_step_job_t job;
+
+        job.job.run = ffts_six_step_job_run;
+        job.job.n_participants = p->n_threads;
+        job.p = p;
+        job.block = block;
+        job.in = in;
+        job.out = out;
+        job.n = n;
+        job.next = 0;
+
+        ffts_pool_run(&job.job);
+        return;
+    }
+#endif
+
+    for (i = 0; i < n; i += FFTS_SIX_STEP_BLOCK) {
+        block(p, in, out, (uint64_t*) p->transpose_buf, i);
+    }
+}
+
+static void
+ffts_six_step_transform(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_six_step_pass(p, ffts_six_step_columns, in, out, p->plans[1]->N);
+    ffts_six_step_pass(p, ffts_six_step_rows, in, out, p->plans[0]->N);
+}
+
+/* the forward transform without the final transpose, X[k1 + N1 * k2]
+   is written to out[k1 * N2 + k2] */
+static void
+ffts_six_step_transform_scrambled_f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_six_step_pass(p, ffts_six_step_columns, in, out, p->plans[1]->N);
+    ffts_six_step_pass(p, ffts_six_step_rows_scrambled_f, in, out, p->plans[0]->N);
+}
+
+/* the inverse of input in the order of ffts_six_step_transform_scrambled_f */
+static void
+ffts_six_step_transform_scrambled_i(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_six_step_pass(p, ffts_six_step_rows_scrambled_i, in, out, p->plans[0]->N);
+    ffts_six_step_pass(p, ffts_six_step_columns_scrambled_i, in, out, p->plans[1]->N);
+}
+
+/* the twiddle factors of sign with the factor of ffts_set_scale folded
+   into the coarse table, replacing the previous ones */
+static int
+ffts_six_step_generate_twiddles(ffts_plan_t *p, size_t N, int sign, float scale)
+{
+    size_t fine_size, coarse_size, i;
+    float *table;
+
+    /* two tables of ~sqrt(N) entries instead of one of N */
+    fine_size = (size_t) 1 << ((ffts_ctzl(N) + 1) / 2);
+    coarse_size = N / fine_size;
+
+    table = (float*) ffts_aligned_malloc(2 * (coarse_size + fine_size) * sizeof(*table));
+    if (!table) {
+        return -1;
+    }
+
+    if (p->A) {
+        ffts_aligned_free(p->A);
+    }
+
+    p->A = table;
+    p->B = table + 2 * coarse_size;
+    p->i2 = fine_size;
+
+    for (i = 0; i < coarse_size; i++) {
+        ffts_cexp_32f(i * fine_size, N, p->A + 2 * i);
+    }
+
+    for (i = 0; i < fine_size; i++) {
+        ffts_cexp_32f(i, N, p->B + 2 * i);
+    }
+
+    /* W = exp(sign * 2 * pi * i / N) */
+    if (sign < 0) {
+        for (i = 0; i < coarse_size + fine_size; i++) {
+            table[2 * i + 1] = -table[2 * i + 1];
+        }
+    }
+
+    for (i = 0; i < 2 * coarse_size; i++) {
+        p->A[i] *= scale;
+    }
+
+    return 0;
+}
+
+/* called from the transposes, which stream through the whole input and
+   output */
+static int
+ffts_six_step_set_callbacks(ffts_plan_t *p,
+                            ffts_load_func_t load,
+                            ffts_store_func_t store,
+                            void *userdata)
+{
+    p->load = load;
+    p->store = store;
+    p->userdata = userdata;
+    return 0;
+}
+
+static int
+ffts_six_step_set_scale(ffts_plan_t *p, float scale)
+{
+    if (ffts_six_step_generate_twiddles(p, p->N, p->sign, scale)) {
+        return -1;
+    }
+
+    if (scale != 1.0f) {
+        p->flags |= FFTS_INTERNAL_SCALED;
+    } else {
+        p->flags &= ~FFTS_INTERNAL_SCALED;
+    }
+
+    return 0;
+}
+
+ffts_plan_t*
+ffts_six_step_init(size_t N, int sign, unsigned int flags)
+{
+    ffts_plan_t *p;
+    size_t N1, N2;
+
+    if (N < FFTS_SIX_STEP_MIN_N || (N & (N - 1))) {
+        return NULL;
+    }
+
+    p = (ffts_plan_t*) calloc(1, sizeof(*p) + 2 * sizeof(*p->plans));
+    if (!p) {
+        return NULL;
+    }
+
+    p->destroy = ffts_six_step_free;
+    p->set_scale = ffts_six_step_set_scale;
+    p->set_callbacks = ffts_six_step_set_callbacks;
+
+    if (!(flags & FFTS_FLAG_SCRAMBLED)) {
+        p->transform = ffts_six_step_transform;
+    } else if (sign < 0) {
+        p->transform = ffts_six_step_transform_scrambled_f;
+    } else {
+        p->transform = ffts_six_step_transform_scrambled_i;
+    }
+
+    p->N = N;
+    p->rank = 1;
+    p->sign = sign;
+    p->plans = (ffts_plan_t**) &p[1];
+
+    /* N1 <= N2 so the first pass gathers the fewer rows */
+    N1 = (size_t) 1 << (ffts_ctzl(N) / 2);
+    N2 = N / N1;
+
+    /* the sub-plans run in cache, never split them again, and keep
+       their natural order. The split step of a real transform is not
+       fused into them, it follows this plan. Their transforms are called
+       directly, which only ffts_execute does while code is generated, and
+       on the threads of this plan. Their output stays in the cache, only
+       the output of this plan is streamed */
+    p->n_threads = ffts_execute_threads(N, flags);
+    if (p->n_threads > FFTS_PARALLEL_MAX_THREADS) {
+        p->n_threads = FFTS_PARALLEL_MAX_THREADS;
+    }
+
+    if (ffts_stream_output(N, flags)) {
+        p->flags |= FFTS_INTERNAL_STREAM;
+    }
+
+    flags = (flags & ~(FFTS_INTERNAL_SIX_STEP | FFTS_FLAG_SCRAMBLED |
+        FFTS_INTERNAL_REAL_SPLIT | FFTS_FLAG_BACKGROUND_JIT |
+        FFTS_FLAG_PARALLEL_EXECUTE | FFTS_FLAG_STREAM | FFTS_FLAG_NO_PREFETCH |
+        FFTS_FLAG_PREFETCH(0xff))) | FFTS_INTERNAL_DIRECT | FFTS_FLAG_NO_STREAM;
+
+    p->plans[0] = ffts_init_1d_32f(N1, sign, flags);
+    if (!p->plans[0]) {
+        goto cleanup;
+    }
+
+    if (N2 == N1) {
+        p->plans[1] = p->plans[0];
+    } else {
+        p->plans[1] = ffts_init_1d_32f(N2, sign, flags);
+        if (!p->plans[1]) {
+            goto cleanup;
+        }
+    }
+
+    p->buf = ffts_aligned_malloc(N * sizeof(ffts_cpx_32f));
+    if (!p->buf) {
+        goto cleanup;
+    }
+
+    p->transpose_buf = ffts_aligned_malloc(
+        p->n_threads * 2 * FFTS_SIX_STEP_BLOCK * N2 * sizeof(ffts_cpx_32f));
+    if (!p->transpose_buf) {
+        goto cleanup;
+    }
+
+    if (ffts_six_step_generate_twiddles(p, N, sign, 1.0f)) {
+        goto cleanup;
+    }
+
+    return p;
+
+cleanup:
+    ffts_six_step_free(p);
+    return NULL;
+}
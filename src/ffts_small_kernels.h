@@ -0,0 +1,1029 @@
+/* generated by generate_small_kernels.py, do not edit */
+
+#ifndef FFTS_SMALL_KERNELS_H
+#define FFTS_SMALL_KERNELS_H
+
+#if defined (_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+/* twiddle factors of the passes of 16 up to 512, one level per size
+   in the order of ffts_generate_luts */
+static const FFTS_ALIGN(16) float ffts_small_lut_32f[1504] = {
+    1.0f, 1.0f, 0.923879504f, 0.923879504f,
+    -0.0f, 0.0f, -0.382683426f, 0.382683426f,
+    0.707106769f, 0.707106769f, 0.382683426f, 0.382683426f,
+    -0.707106769f, 0.707106769f, -0.923879504f, 0.923879504f,
+    1.0f, 1.0f, 0.923879504f, 0.923879504f,
+    -0.0f, 0.0f, -0.382683426f, 0.382683426f,
+    1.0f, 1.0f, 0.980785251f, 0.980785251f,
+    -0.0f, 0.0f, -0.195090324f, 0.195090324f,
+    0.707106769f, 0.707106769f, 0.555570245f, 0.555570245f,
+    -0.707106769f, 0.707106769f, -0.831469595f, 0.831469595f,
+    0.707106769f, 0.707106769f, 0.382683426f, 0.382683426f,
+    -0.707106769f, 0.707106769f, -0.923879504f, 0.923879504f,
+    0.923879504f, 0.923879504f, 0.831469595f, 0.831469595f,
+    -0.382683426f, 0.382683426f, -0.555570245f, 0.555570245f,
+    0.382683426f, 0.382683426f, 0.195090324f, 0.195090324f,
+    -0.923879504f, 0.923879504f, -0.980785251f, 0.980785251f,
+    1.0f, 1.0f, 0.980785251f, 0.980785251f,
+    -0.0f, 0.0f, -0.195090324f, 0.195090324f,
+    1.0f, 1.0f, 0.99518472f, 0.99518472f,
+    -0.0f, 0.0f, -0.0980171412f, 0.0980171412f,
+    0.707106769f, 0.707106769f, 0.634393275f, 0.634393275f,
+    -0.707106769f, 0.707106769f, -0.773010433f, 0.773010433f,
+    0.923879504f, 0.923879504f, 0.831469595f, 0.831469595f,
+    -0.382683426f, 0.382683426f, -0.555570245f, 0.555570245f,
+    0.980785251f, 0.980785251f, 0.956940353f, 0.956940353f,
+    -0.195090324f, 0.195090324f, -0.290284663f, 0.290284663f,
+    0.555570245f, 0.555570245f, 0.471396744f, 0.471396744f,
+    -0.831469595f, 0.831469595f, -0.881921291f, 0.881921291f,
+    0.707106769f, 0.707106769f, 0.555570245f, 0.555570245f,
+    -0.707106769f, 0.707106769f, -0.831469595f, 0.831469595f,
+    0.923879504f, 0.923879504f, 0.881921291f, 0.881921291f,
+    -0.382683426f, 0.382683426f, -0.471396744f, 0.471396744f,
+    0.382683426f, 0.382683426f, 0.290284663f, 0.290284663f,
+    -0.923879504f, 0.923879504f, -0.956940353f, 0.956940353f,
+    0.382683426f, 0.382683426f, 0.195090324f, 0.195090324f,
+    -0.923879504f, 0.923879504f, -0.980785251f, 0.980785251f,
+    0.831469595f, 0.831469595f, 0.773010433f, 0.773010433f,
+    -0.555570245f, 0.555570245f, -0.634393275f, 0.634393275f,
+    0.195090324f, 0.195090324f, 0.0980171412f, 0.0980171412f,
+    -0.980785251f, 0.980785251f, -0.99518472f, 0.99518472f,
+    1.0f, 1.0f, 0.99518472f, 0.99518472f,
+    -0.0f, 0.0f, -0.0980171412f, 0.0980171412f,
+    1.0f, 1.0f, 0.99879545f, 0.99879545f,
+    -0.0f, 0.0f, -0.0490676761f, 0.0490676761f,
+    0.707106769f, 0.707106769f, 0.671558976f, 0.671558976f,
+    -0.707106769f, 0.707106769f, -0.740951121f, 0.740951121f,
+    0.980785251f, 0.980785251f, 0.956940353f, 0.956940353f,
+    -0.195090324f, 0.195090324f, -0.290284663f, 0.290284663f,
+    0.99518472f, 0.99518472f, 0.989176512f, 0.989176512f,
+    -0.0980171412f, 0.0980171412f, -0.146730468f, 0.146730468f,
+    0.634393275f, 0.634393275f, 0.59569931f, 0.59569931f,
+    -0.773010433f, 0.773010433f, -0.803207517f, 0.803207517f,
+    0.923879504f, 0.923879504f, 0.881921291f, 0.881921291f,
+    -0.382683426f, 0.382683426f, -0.471396744f, 0.471396744f,
+    0.980785251f, 0.980785251f, 0.970031261f, 0.970031261f,
+    -0.195090324f, 0.195090324f, -0.242980182f, 0.242980182f,
+    0.555570245f, 0.555570245f, 0.514102757f, 0.514102757f,
+    -0.831469595f, 0.831469595f, -0.857728601f, 0.857728601f,
+    0.831469595f, 0.831469595f, 0.773010433f, 0.773010433f,
+    -0.555570245f, 0.555570245f, -0.634393275f, 0.634393275f,
+    0.956940353f, 0.956940353f, 0.941544056f, 0.941544056f,
+    -0.290284663f, 0.290284663f, -0.336889863f, 0.336889863f,
+    0.471396744f, 0.471396744f, 0.427555084f, 0.427555084f,
+    -0.881921291f, 0.881921291f, -0.903989315f, 0.903989315f,
+    0.707106769f, 0.707106769f, 0.634393275f, 0.634393275f,
+    -0.707106769f, 0.707106769f, -0.773010433f, 0.773010433f,
+    0.923879504f, 0.923879504f, 0.903989315f, 0.903989315f,
+    -0.382683426f, 0.382683426f, -0.427555084f, 0.427555084f,
+    0.382683426f, 0.382683426f, 0.336889863f, 0.336889863f,
+    -0.923879504f, 0.923879504f, -0.941544056f, 0.941544056f,
+    0.555570245f, 0.555570245f, 0.471396744f, 0.471396744f,
+    -0.831469595f, 0.831469595f, -0.881921291f, 0.881921291f,
+    0.881921291f, 0.881921291f, 0.857728601f, 0.857728601f,
+    -0.471396744f, 0.471396744f, -0.514102757f, 0.514102757f,
+    0.290284663f, 0.290284663f, 0.242980182f, 0.242980182f,
+    -0.956940353f, 0.956940353f, -0.970031261f, 0.970031261f,
+    0.382683426f, 0.382683426f, 0.290284663f, 0.290284663f,
+    -0.923879504f, 0.923879504f, -0.956940353f, 0.956940353f,
+    0.831469595f, 0.831469595f, 0.803207517f, 0.803207517f,
+    -0.555570245f, 0.555570245f, -0.59569931f, 0.59569931f,
+    0.195090324f, 0.195090324f, 0.146730468f, 0.146730468f,
+    -0.980785251f, 0.980785251f, -0.989176512f, 0.989176512f,
+    0.195090324f, 0.195090324f, 0.0980171412f, 0.0980171412f,
+    -0.980785251f, 0.980785251f, -0.99518472f, 0.99518472f,
+    0.773010433f, 0.773010433f, 0.740951121f, 0.740951121f,
+    -0.634393275f, 0.634393275f, -0.671558976f, 0.671558976f,
+    0.0980171412f, 0.0980171412f, 0.0490676761f, 0.0490676761f,
+    -0.99518472f, 0.99518472f, -0.99879545f, 0.99879545f,
+    1.0f, 1.0f, 0.99879545f, 0.99879545f,
+    -0.0f, 0.0f, -0.0490676761f, 0.0490676761f,
+    1.0f, 1.0f, 0.999698818f, 0.999698818f,
+    -0.0f, 0.0f, -0.024541229f, 0.024541229f,
+    0.707106769f, 0.707106769f, 0.689540565f, 0.689540565f,
+    -0.707106769f, 0.707106769f, -0.724247098f, 0.724247098f,
+    0.99518472f, 0.99518472f, 0.989176512f, 0.989176512f,
+    -0.0980171412f, 0.0980171412f, -0.146730468f, 0.146730468f,
+    0.99879545f, 0.99879545f, 0.997290432f, 0.997290432f,
+    -0.0490676761f, 0.0490676761f, -0.0735645667f, 0.0735645667f,
+    0.671558976f, 0.671558976f, 0.653172851f, 0.653172851f,
+    -0.740951121f, 0.740951121f, -0.757208824f, 0.757208824f,
+    0.980785251f, 0.980785251f, 0.970031261f, 0.970031261f,
+    -0.195090324f, 0.195090324f, -0.242980182f, 0.242980182f,
+    0.99518472f, 0.99518472f, 0.992479563f, 0.992479563f,
+    -0.0980171412f, 0.0980171412f, -0.122410677f, 0.122410677f,
+    0.634393275f, 0.634393275f, 0.615231574f, 0.615231574f,
+    -0.773010433f, 0.773010433f, -0.78834641f, 0.78834641f,
+    0.956940353f, 0.956940353f, 0.941544056f, 0.941544056f,
+    -0.290284663f, 0.290284663f, -0.336889863f, 0.336889863f,
+    0.989176512f, 0.989176512f, 0.985277653f, 0.985277653f,
+    -0.146730468f, 0.146730468f, -0.170961887f, 0.170961887f,
+    0.59569931f, 0.59569931f, 0.575808167f, 0.575808167f,
+    -0.803207517f, 0.803207517f, -0.817584813f, 0.817584813f,
+    0.923879504f, 0.923879504f, 0.903989315f, 0.903989315f,
+    -0.382683426f, 0.382683426f, -0.427555084f, 0.427555084f,
+    0.980785251f, 0.980785251f, 0.975702107f, 0.975702107f,
+    -0.195090324f, 0.195090324f, -0.219101235f, 0.219101235f,
+    0.555570245f, 0.555570245f, 0.534997642f, 0.534997642f,
+    -0.831469595f, 0.831469595f, -0.84485358f, 0.84485358f,
+    0.881921291f, 0.881921291f, 0.857728601f, 0.857728601f,
+    -0.471396744f, 0.471396744f, -0.514102757f, 0.514102757f,
+    0.970031261f, 0.970031261f, 0.963776052f, 0.963776052f,
+    -0.242980182f, 0.242980182f, -0.266712755f, 0.266712755f,
+    0.514102757f, 0.514102757f, 0.492898196f, 0.492898196f,
+    -0.857728601f, 0.857728601f, -0.870086968f, 0.870086968f,
+    0.831469595f, 0.831469595f, 0.803207517f, 0.803207517f,
+    -0.555570245f, 0.555570245f, -0.59569931f, 0.59569931f,
+    0.956940353f, 0.956940353f, 0.949528158f, 0.949528158f,
+    -0.290284663f, 0.290284663f, -0.313681751f, 0.313681751f,
+    0.471396744f, 0.471396744f, 0.449611336f, 0.449611336f,
+    -0.881921291f, 0.881921291f, -0.893224299f, 0.893224299f,
+    0.773010433f, 0.773010433f, 0.740951121f, 0.740951121f,
+    -0.634393275f, 0.634393275f, -0.671558976f, 0.671558976f,
+    0.941544056f, 0.941544056f, 0.932992816f, 0.932992816f,
+    -0.336889863f, 0.336889863f, -0.359895051f, 0.359895051f,
+    0.427555084f, 0.427555084f, 0.405241311f, 0.405241311f,
+    -0.903989315f, 0.903989315f, -0.914209783f, 0.914209783f,
+    0.707106769f, 0.707106769f, 0.671558976f, 0.671558976f,
+    -0.707106769f, 0.707106769f, -0.740951121f, 0.740951121f,
+    0.923879504f, 0.923879504f, 0.914209783f, 0.914209783f,
+    -0.382683426f, 0.382683426f, -0.405241311f, 0.405241311f,
+    0.382683426f, 0.382683426f, 0.359895051f, 0.359895051f,
+    -0.923879504f, 0.923879504f, -0.932992816f, 0.932992816f,
+    0.634393275f, 0.634393275f, 0.59569931f, 0.59569931f,
+    -0.773010433f, 0.773010433f, -0.803207517f, 0.803207517f,
+    0.903989315f, 0.903989315f, 0.893224299f, 0.893224299f,
+    -0.427555084f, 0.427555084f, -0.449611336f, 0.449611336f,
+    0.336889863f, 0.336889863f, 0.313681751f, 0.313681751f,
+    -0.941544056f, 0.941544056f, -0.949528158f, 0.949528158f,
+    0.555570245f, 0.555570245f, 0.514102757f, 0.514102757f,
+    -0.831469595f, 0.831469595f, -0.857728601f, 0.857728601f,
+    0.881921291f, 0.881921291f, 0.870086968f, 0.870086968f,
+    -0.471396744f, 0.471396744f, -0.492898196f, 0.492898196f,
+    0.290284663f, 0.290284663f, 0.266712755f, 0.266712755f,
+    -0.956940353f, 0.956940353f, -0.963776052f, 0.963776052f,
+    0.471396744f, 0.471396744f, 0.427555084f, 0.427555084f,
+    -0.881921291f, 0.881921291f, -0.903989315f, 0.903989315f,
+    0.857728601f, 0.857728601f, 0.84485358f, 0.84485358f,
+    -0.514102757f, 0.514102757f, -0.534997642f, 0.534997642f,
+    0.242980182f, 0.242980182f, 0.219101235f, 0.219101235f,
+    -0.970031261f, 0.970031261f, -0.975702107f, 0.975702107f,
+    0.382683426f, 0.382683426f, 0.336889863f, 0.336889863f,
+    -0.923879504f, 0.923879504f, -0.941544056f, 0.941544056f,
+    0.831469595f, 0.831469595f, 0.817584813f, 0.817584813f,
+    -0.555570245f, 0.555570245f, -0.575808167f, 0.575808167f,
+    0.195090324f, 0.195090324f, 0.170961887f, 0.170961887f,
+    -0.980785251f, 0.980785251f, -0.985277653f, 0.985277653f,
+    0.290284663f, 0.290284663f, 0.242980182f, 0.242980182f,
+    -0.956940353f, 0.956940353f, -0.970031261f, 0.970031261f,
+    0.803207517f, 0.803207517f, 0.78834641f, 0.78834641f,
+    -0.59569931f, 0.59569931f, -0.615231574f, 0.615231574f,
+    0.146730468f, 0.146730468f, 0.122410677f, 0.122410677f,
+    -0.989176512f, 0.989176512f, -0.992479563f, 0.992479563f,
+    0.195090324f, 0.195090324f, 0.146730468f, 0.146730468f,
+    -0.980785251f, 0.980785251f, -0.989176512f, 0.989176512f,
+    0.773010433f, 0.773010433f, 0.757208824f, 0.757208824f,
+    -0.634393275f, 0.634393275f, -0.653172851f, 0.653172851f,
+    0.0980171412f, 0.0980171412f, 0.0735645667f, 0.0735645667f,
+    -0.99518472f, 0.99518472f, -0.997290432f, 0.997290432f,
+    0.0980171412f, 0.0980171412f, 0.0490676761f, 0.0490676761f,
+    -0.99518472f, 0.99518472f, -0.99879545f, 0.99879545f,
+    0.740951121f, 0.740951121f, 0.724247098f, 0.724247098f,
+    -0.671558976f, 0.671558976f, -0.689540565f, 0.689540565f,
+    0.0490676761f, 0.0490676761f, 0.024541229f, 0.024541229f,
+    -0.99879545f, 0.99879545f, -0.999698818f, 0.999698818f,
+    1.0f, 1.0f, 0.999698818f, 0.999698818f,
+    -0.0f, 0.0f, -0.024541229f, 0.024541229f,
+    1.0f, 1.0f, 0.999924719f, 0.999924719f,
+    -0.0f, 0.0f, -0.0122715384f, 0.0122715384f,
+    0.707106769f, 0.707106769f, 0.698376238f, 0.698376238f,
+    -0.707106769f, 0.707106769f, -0.715730846f, 0.715730846f,
+    0.99879545f, 0.99879545f, 0.997290432f, 0.997290432f,
+    -0.0490676761f, 0.0490676761f, -0.0735645667f, 0.0735645667f,
+    0.999698818f, 0.999698818f, 0.999322355f, 0.999322355f,
+    -0.024541229f, 0.024541229f, -0.0368072242f, 0.0368072242f,
+    0.689540565f, 0.689540565f, 0.680601001f, 0.680601001f,
+    -0.724247098f, 0.724247098f, -0.732654274f, 0.732654274f,
+    0.99518472f, 0.99518472f, 0.992479563f, 0.992479563f,
+    -0.0980171412f, 0.0980171412f, -0.122410677f, 0.122410677f,
+    0.99879545f, 0.99879545f, 0.998118103f, 0.998118103f,
+    -0.0490676761f, 0.0490676761f, -0.061320737f, 0.061320737f,
+    0.671558976f, 0.671558976f, 0.662415802f, 0.662415802f,
+    -0.740951121f, 0.740951121f, -0.749136388f, 0.749136388f,
+    0.989176512f, 0.989176512f, 0.985277653f, 0.985277653f,
+    -0.146730468f, 0.146730468f, -0.170961887f, 0.170961887f,
+    0.997290432f, 0.997290432f, 0.996312618f, 0.996312618f,
+    -0.0735645667f, 0.0735645667f, -0.0857973099f, 0.0857973099f,
+    0.653172851f, 0.653172851f, 0.643831551f, 0.643831551f,
+    -0.757208824f, 0.757208824f, -0.765167236f, 0.765167236f,
+    0.980785251f, 0.980785251f, 0.975702107f, 0.975702107f,
+    -0.195090324f, 0.195090324f, -0.219101235f, 0.219101235f,
+    0.99518472f, 0.99518472f, 0.993906975f, 0.993906975f,
+    -0.0980171412f, 0.0980171412f, -0.110222206f, 0.110222206f,
+    0.634393275f, 0.634393275f, 0.624859512f, 0.624859512f,
+    -0.773010433f, 0.773010433f, -0.780737221f, 0.780737221f,
+    0.970031261f, 0.970031261f, 0.963776052f, 0.963776052f,
+    -0.242980182f, 0.242980182f, -0.266712755f, 0.266712755f,
+    0.992479563f, 0.992479563f, 0.990902662f, 0.990902662f,
+    -0.122410677f, 0.122410677f, -0.134580702f, 0.134580702f,
+    0.615231574f, 0.615231574f, 0.605511069f, 0.605511069f,
+    -0.78834641f, 0.78834641f, -0.795836926f, 0.795836926f,
+    0.956940353f, 0.956940353f, 0.949528158f, 0.949528158f,
+    -0.290284663f, 0.290284663f, -0.313681751f, 0.313681751f,
+    0.989176512f, 0.989176512f, 0.987301409f, 0.987301409f,
+    -0.146730468f, 0.146730468f, -0.15885815f, 0.15885815f,
+    0.59569931f, 0.59569931f, 0.585797846f, 0.585797846f,
+    -0.803207517f, 0.803207517f, -0.81045717f, 0.81045717f,
+    0.941544056f, 0.941544056f, 0.932992816f, 0.932992816f,
+    -0.336889863f, 0.336889863f, -0.359895051f, 0.359895051f,
+    0.985277653f, 0.985277653f, 0.983105481f, 0.983105481f,
+    -0.170961887f, 0.170961887f, -0.183039889f, 0.183039889f,
+    0.575808167f, 0.575808167f, 0.565731823f, 0.565731823f,
+    -0.817584813f, 0.817584813f, -0.824589312f, 0.824589312f,
+    0.923879504f, 0.923879504f, 0.914209783f, 0.914209783f,
+    -0.382683426f, 0.382683426f, -0.405241311f, 0.405241311f,
+    0.980785251f, 0.980785251f, 0.97831738f, 0.97831738f,
+    -0.195090324f, 0.195090324f, -0.207111374f, 0.207111374f,
+    0.555570245f, 0.555570245f, 0.545324981f, 0.545324981f,
+    -0.831469595f, 0.831469595f, -0.838224709f, 0.838224709f,
+    0.903989315f, 0.903989315f, 0.893224299f, 0.893224299f,
+    -0.427555084f, 0.427555084f, -0.449611336f, 0.449611336f,
+    0.975702107f, 0.975702107f, 0.972939968f, 0.972939968f,
+    -0.219101235f, 0.219101235f, -0.231058106f, 0.231058106f,
+    0.534997642f, 0.534997642f, 0.524589658f, 0.524589658f,
+    -0.84485358f, 0.84485358f, -0.851355195f, 0.851355195f,
+    0.881921291f, 0.881921291f, 0.870086968f, 0.870086968f,
+    -0.471396744f, 0.471396744f, -0.492898196f, 0.492898196f,
+    0.970031261f, 0.970031261f, 0.966976464f, 0.966976464f,
+    -0.242980182f, 0.242980182f, -0.254865646f, 0.254865646f,
+    0.514102757f, 0.514102757f, 0.50353837f, 0.50353837f,
+    -0.857728601f, 0.857728601f, -0.863972843f, 0.863972843f,
+    0.857728601f, 0.857728601f, 0.84485358f, 0.84485358f,
+    -0.514102757f, 0.514102757f, -0.534997642f, 0.534997642f,
+    0.963776052f, 0.963776052f, 0.960430503f, 0.960430503f,
+    -0.266712755f, 0.266712755f, -0.27851969f, 0.27851969f,
+    0.492898196f, 0.492898196f, 0.482183784f, 0.482183784f,
+    -0.870086968f, 0.870086968f, -0.876070082f, 0.876070082f,
+    0.831469595f, 0.831469595f, 0.817584813f, 0.817584813f,
+    -0.555570245f, 0.555570245f, -0.575808167f, 0.575808167f,
+    0.956940353f, 0.956940353f, 0.953306019f, 0.953306019f,
+    -0.290284663f, 0.290284663f, -0.302005947f, 0.302005947f,
+    0.471396744f, 0.471396744f, 0.460538715f, 0.460538715f,
+    -0.881921291f, 0.881921291f, -0.887639642f, 0.887639642f,
+    0.803207517f, 0.803207517f, 0.78834641f, 0.78834641f,
+    -0.59569931f, 0.59569931f, -0.615231574f, 0.615231574f,
+    0.949528158f, 0.949528158f, 0.945607305f, 0.945607305f,
+    -0.313681751f, 0.313681751f, -0.32531029f, 0.32531029f,
+    0.449611336f, 0.449611336f, 0.438616246f, 0.438616246f,
+    -0.893224299f, 0.893224299f, -0.898674488f, 0.898674488f,
+    0.773010433f, 0.773010433f, 0.757208824f, 0.757208824f,
+    -0.634393275f, 0.634393275f, -0.653172851f, 0.653172851f,
+    0.941544056f, 0.941544056f, 0.937339008f, 0.937339008f,
+    -0.336889863f, 0.336889863f, -0.348418683f, 0.348418683f,
+    0.427555084f, 0.427555084f, 0.416429549f, 0.416429549f,
+    -0.903989315f, 0.903989315f, -0.909168005f, 0.909168005f,
+    0.740951121f, 0.740951121f, 0.724247098f, 0.724247098f,
+    -0.671558976f, 0.671558976f, -0.689540565f, 0.689540565f,
+    0.932992816f, 0.932992816f, 0.928506076f, 0.928506076f,
+    -0.359895051f, 0.359895051f, -0.371317208f, 0.371317208f,
+    0.405241311f, 0.405241311f, 0.393992037f, 0.393992037f,
+    -0.914209783f, 0.914209783f, -0.919113874f, 0.919113874f,
+    0.707106769f, 0.707106769f, 0.689540565f, 0.689540565f,
+    -0.707106769f, 0.707106769f, -0.724247098f, 0.724247098f,
+    0.923879504f, 0.923879504f, 0.919113874f, 0.919113874f,
+    -0.382683426f, 0.382683426f, -0.393992037f, 0.393992037f,
+    0.382683426f, 0.382683426f, 0.371317208f, 0.371317208f,
+    -0.923879504f, 0.923879504f, -0.928506076f, 0.928506076f,
+    0.671558976f, 0.671558976f, 0.653172851f, 0.653172851f,
+    -0.740951121f, 0.740951121f, -0.757208824f, 0.757208824f,
+    0.914209783f, 0.914209783f, 0.909168005f, 0.909168005f,
+    -0.405241311f, 0.405241311f, -0.416429549f, 0.416429549f,
+    0.359895051f, 0.359895051f, 0.348418683f, 0.348418683f,
+    -0.932992816f, 0.932992816f, -0.937339008f, 0.937339008f,
+    0.634393275f, 0.634393275f, 0.615231574f, 0.615231574f,
+    -0.773010433f, 0.773010433f, -0.78834641f, 0.78834641f,
+    0.903989315f, 0.903989315f, 0.898674488f, 0.898674488f,
+    -0.427555084f, 0.427555084f, -0.438616246f, 0.438616246f,
+    0.336889863f, 0.336889863f, 0.32531029f, 0.32531029f,
+    -0.941544056f, 0.941544056f, -0.945607305f, 0.945607305f,
+    0.59569931f, 0.59569931f, 0.575808167f, 0.575808167f,
+    -0.803207517f, 0.803207517f, -0.817584813f, 0.817584813f,
+    0.893224299f, 0.893224299f, 0.887639642f, 0.887639642f,
+    -0.449611336f, 0.449611336f, -0.460538715f, 0.460538715f,
+    0.313681751f, 0.313681751f, 0.302005947f, 0.302005947f,
+    -0.949528158f, 0.949528158f, -0.953306019f, 0.953306019f,
+    0.555570245f, 0.555570245f, 0.534997642f, 0.534997642f,
+    -0.831469595f, 0.831469595f, -0.84485358f, 0.84485358f,
+    0.881921291f, 0.881921291f, 0.876070082f, 0.876070082f,
+    -0.471396744f, 0.471396744f, -0.482183784f, 0.482183784f,
+    0.290284663f, 0.290284663f, 0.27851969f, 0.27851969f,
+    -0.956940353f, 0.956940353f, -0.960430503f, 0.960430503f,
+    0.514102757f, 0.514102757f, 0.492898196f, 0.492898196f,
+    -0.857728601f, 0.857728601f, -0.870086968f, 0.870086968f,
+    0.870086968f, 0.870086968f, 0.863972843f, 0.863972843f,
+    -0.492898196f, 0.492898196f, -0.50353837f, 0.50353837f,
+    0.266712755f, 0.266712755f, 0.254865646f, 0.254865646f,
+    -0.963776052f, 0.963776052f, -0.966976464f, 0.966976464f,
+    0.471396744f, 0.471396744f, 0.449611336f, 0.449611336f,
+    -0.881921291f, 0.881921291f, -0.893224299f, 0.893224299f,
+    0.857728601f, 0.857728601f, 0.851355195f, 0.851355195f,
+    -0.514102757f, 0.514102757f, -0.524589658f, 0.524589658f,
+    0.242980182f, 0.242980182f, 0.231058106f, 0.231058106f,
+    -0.970031261f, 0.970031261f, -0.972939968f, 0.972939968f,
+    0.427555084f, 0.427555084f, 0.405241311f, 0.405241311f,
+    -0.903989315f, 0.903989315f, -0.914209783f, 0.914209783f,
+    0.84485358f, 0.84485358f, 0.838224709f, 0.838224709f,
+    -0.534997642f, 0.534997642f, -0.545324981f, 0.545324981f,
+    0.219101235f, 0.219101235f, 0.207111374f, 0.207111374f,
+    -0.975702107f, 0.975702107f, -0.97831738f, 0.97831738f,
+    0.382683426f, 0.382683426f, 0.359895051f, 0.359895051f,
+    -0.923879504f, 0.923879504f, -0.932992816f, 0.932992816f,
+    0.831469595f, 0.831469595f, 0.824589312f, 0.824589312f,
+    -0.555570245f, 0.555570245f, -0.565731823f, 0.565731823f,
+    0.195090324f, 0.195090324f, 0.183039889f, 0.183039889f,
+    -0.980785251f, 0.980785251f, -0.983105481f, 0.983105481f,
+    0.336889863f, 0.336889863f, 0.313681751f, 0.313681751f,
+    -0.941544056f, 0.941544056f, -0.949528158f, 0.949528158f,
+    0.817584813f, 0.817584813f, 0.81045717f, 0.81045717f,
+    -0.575808167f, 0.575808167f, -0.585797846f, 0.585797846f,
+    0.170961887f, 0.170961887f, 0.15885815f, 0.15885815f,
+    -0.985277653f, 0.985277653f, -0.987301409f, 0.987301409f,
+    0.290284663f, 0.290284663f, 0.266712755f, 0.266712755f,
+    -0.956940353f, 0.956940353f, -0.963776052f, 0.963776052f,
+    0.803207517f, 0.803207517f, 0.795836926f, 0.795836926f,
+    -0.59569931f, 0.59569931f, -0.605511069f, 0.605511069f,
+    0.146730468f, 0.146730468f, 0.134580702f, 0.134580702f,
+    -0.989176512f, 0.989176512f, -0.990902662f, 0.990902662f,
+    0.242980182f, 0.242980182f, 0.219101235f, 0.219101235f,
+    -0.970031261f, 0.970031261f, -0.975702107f, 0.975702107f,
+    0.78834641f, 0.78834641f, 0.780737221f, 0.780737221f,
+    -0.615231574f, 0.615231574f, -0.624859512f, 0.624859512f,
+    0.122410677f, 0.122410677f, 0.110222206f, 0.110222206f,
+    -0.992479563f, 0.992479563f, -0.993906975f, 0.993906975f,
+    0.195090324f, 0.195090324f, 0.170961887f, 0.170961887f,
+    -0.980785251f, 0.980785251f, -0.985277653f, 0.985277653f,
+    0.773010433f, 0.773010433f, 0.765167236f, 0.765167236f,
+    -0.634393275f, 0.634393275f, -0.643831551f, 0.643831551f,
+    0.0980171412f, 0.0980171412f, 0.0857973099f, 0.0857973099f,
+    -0.99518472f, 0.99518472f, -0.996312618f, 0.996312618f,
+    0.146730468f, 0.146730468f, 0.122410677f, 0.122410677f,
+    -0.989176512f, 0.989176512f, -0.992479563f, 0.992479563f,
+    0.757208824f, 0.757208824f, 0.749136388f, 0.749136388f,
+    -0.653172851f, 0.653172851f, -0.662415802f, 0.662415802f,
+    0.0735645667f, 0.0735645667f, 0.061320737f, 0.061320737f,
+    -0.997290432f, 0.997290432f, -0.998118103f, 0.998118103f,
+    0.0980171412f, 0.0980171412f, 0.0735645667f, 0.0735645667f,
+    -0.99518472f, 0.99518472f, -0.997290432f, 0.997290432f,
+    0.740951121f, 0.740951121f, 0.732654274f, 0.732654274f,
+    -0.671558976f, 0.671558976f, -0.680601001f, 0.680601001f,
+    0.0490676761f, 0.0490676761f, 0.0368072242f, 0.0368072242f,
+    -0.99879545f, 0.99879545f, -0.999322355f, 0.999322355f,
+    0.0490676761f, 0.0490676761f, 0.024541229f, 0.024541229f,
+    -0.99879545f, 0.99879545f, -0.999698818f, 0.999698818f,
+    0.724247098f, 0.724247098f, 0.715730846f, 0.715730846f,
+    -0.689540565f, 0.689540565f, -0.698376238f, 0.698376238f,
+    0.024541229f, 0.024541229f, 0.0122715384f, 0.0122715384f,
+    -0.999698818f, 0.999698818f, -0.999924719f, 0.999924719f
+};
+
+static const FFTS_ALIGN(16) float ffts_small_lut_inv_32f[1504] = {
+    1.0f, 1.0f, 0.923879504f, 0.923879504f,
+    0.0f, -0.0f, 0.382683426f, -0.382683426f,
+    0.707106769f, 0.707106769f, 0.382683426f, 0.382683426f,
+    0.707106769f, -0.707106769f, 0.923879504f, -0.923879504f,
+    1.0f, 1.0f, 0.923879504f, 0.923879504f,
+    0.0f, -0.0f, 0.382683426f, -0.382683426f,
+    1.0f, 1.0f, 0.980785251f, 0.980785251f,
+    0.0f, -0.0f, 0.195090324f, -0.195090324f,
+    0.707106769f, 0.707106769f, 0.555570245f, 0.555570245f,
+    0.707106769f, -0.707106769f, 0.831469595f, -0.831469595f,
+    0.707106769f, 0.707106769f, 0.382683426f, 0.382683426f,
+    0.707106769f, -0.707106769f, 0.923879504f, -0.923879504f,
+    0.923879504f, 0.923879504f, 0.831469595f, 0.831469595f,
+    0.382683426f, -0.382683426f, 0.555570245f, -0.555570245f,
+    0.382683426f, 0.382683426f, 0.195090324f, 0.195090324f,
+    0.923879504f, -0.923879504f, 0.980785251f, -0.980785251f,
+    1.0f, 1.0f, 0.980785251f, 0.980785251f,
+    0.0f, -0.0f, 0.195090324f, -0.195090324f,
+    1.0f, 1.0f, 0.99518472f, 0.99518472f,
+    0.0f, -0.0f, 0.0980171412f, -0.0980171412f,
+    0.707106769f, 0.707106769f, 0.634393275f, 0.634393275f,
+    0.707106769f, -0.707106769f, 0.773010433f, -0.773010433f,
+    0.923879504f, 0.923879504f, 0.831469595f, 0.831469595f,
+    0.382683426f, -0.382683426f, 0.555570245f, -0.555570245f,
+    0.980785251f, 0.980785251f, 0.956940353f, 0.956940353f,
+    0.195090324f, -0.195090324f, 0.290284663f, -0.290284663f,
+    0.555570245f, 0.555570245f, 0.471396744f, 0.471396744f,
+    0.831469595f, -0.831469595f, 0.881921291f, -0.881921291f,
+    0.707106769f, 0.707106769f, 0.555570245f, 0.555570245f,
+    0.707106769f, -0.707106769f, 0.831469595f, -0.831469595f,
+    0.923879504f, 0.923879504f, 0.881921291f, 0.881921291f,
+    0.382683426f, -0.382683426f, 0.471396744f, -0.471396744f,
+    0.382683426f, 0.382683426f, 0.290284663f, 0.290284663f,
+    0.923879504f, -0.923879504f, 0.956940353f, -0.956940353f,
+    0.382683426f, 0.382683426f, 0.195090324f, 0.195090324f,
+    0.923879504f, -0.923879504f, 0.980785251f, -0.980785251f,
+    0.831469595f, 0.831469595f, 0.773010433f, 0.773010433f,
+    0.555570245f, -0.555570245f, 0.634393275f, -0.634393275f,
+    0.195090324f, 0.195090324f, 0.0980171412f, 0.0980171412f,
+    0.980785251f, -0.980785251f, 0.99518472f, -0.99518472f,
+    1.0f, 1.0f, 0.99518472f, 0.99518472f,
+    0.0f, -0.0f, 0.0980171412f, -0.0980171412f,
+    1.0f, 1.0f, 0.99879545f, 0.99879545f,
+    0.0f, -0.0f, 0.0490676761f, -0.0490676761f,
+    0.707106769f, 0.707106769f, 0.671558976f, 0.671558976f,
+    0.707106769f, -0.707106769f, 0.740951121f, -0.740951121f,
+    0.980785251f, 0.980785251f, 0.956940353f, 0.956940353f,
+    0.195090324f, -0.195090324f, 0.290284663f, -0.290284663f,
+    0.99518472f, 0.99518472f, 0.989176512f, 0.989176512f,
+    0.0980171412f, -0.0980171412f, 0.146730468f, -0.146730468f,
+    0.634393275f, 0.634393275f, 0.59569931f, 0.59569931f,
+    0.773010433f, -0.773010433f, 0.803207517f, -0.803207517f,
+    0.923879504f, 0.923879504f, 0.881921291f, 0.881921291f,
+    0.382683426f, -0.382683426f, 0.471396744f, -0.471396744f,
+    0.980785251f, 0.980785251f, 0.970031261f, 0.970031261f,
+    0.195090324f, -0.195090324f, 0.242980182f, -0.242980182f,
+    0.555570245f, 0.555570245f, 0.514102757f, 0.514102757f,
+    0.831469595f, -0.831469595f, 0.857728601f, -0.857728601f,
+    0.831469595f, 0.831469595f, 0.773010433f, 0.773010433f,
+    0.555570245f, -0.555570245f, 0.634393275f, -0.634393275f,
+    0.956940353f, 0.956940353f, 0.941544056f, 0.941544056f,
+    0.290284663f, -0.290284663f, 0.336889863f, -0.336889863f,
+    0.471396744f, 0.471396744f, 0.427555084f, 0.427555084f,
+    0.881921291f, -0.881921291f, 0.903989315f, -0.903989315f,
+    0.707106769f, 0.707106769f, 0.634393275f, 0.634393275f,
+    0.707106769f, -0.707106769f, 0.773010433f, -0.773010433f,
+    0.923879504f, 0.923879504f, 0.903989315f, 0.903989315f,
+    0.382683426f, -0.382683426f, 0.427555084f, -0.427555084f,
+    0.382683426f, 0.382683426f, 0.336889863f, 0.336889863f,
+    0.923879504f, -0.923879504f, 0.941544056f, -0.941544056f,
+    0.555570245f, 0.555570245f, 0.471396744f, 0.471396744f,
+    0.831469595f, -0.831469595f, 0.881921291f, -0.881921291f,
+    0.881921291f, 0.881921291f, 0.857728601f, 0.857728601f,
+    0.471396744f, -0.471396744f, 0.514102757f, -0.514102757f,
+    0.290284663f, 0.290284663f, 0.242980182f, 0.242980182f,
+    0.956940353f, -0.956940353f, 0.970031261f, -0.970031261f,
+    0.382683426f, 0.382683426f, 0.290284663f, 0.290284663f,
+    0.923879504f, -0.923879504f, 0.956940353f, -0.956940353f,
+    0.831469595f, 0.831469595f, 0.803207517f, 0.803207517f,
+    0.555570245f, -0.555570245f, 0.59569931f, -0.59569931f,
+    0.195090324f, 0.195090324f, 0.146730468f, 0.146730468f,
+    0.980785251f, -0.980785251f, 0.989176512f, -0.989176512f,
+    0.195090324f, 0.195090324f, 0.0980171412f, 0.0980171412f,
+    0.980785251f, -0.980785251f, 0.99518472f, -0.99518472f,
+    0.773010433f, 0.773010433f, 0.740951121f, 0.740951121f,
+    0.634393275f, -0.634393275f, 0.671558976f, -0.671558976f,
+    0.0980171412f, 0.0980171412f, 0.0490676761f, 0.0490676761f,
+    0.99518472f, -0.99518472f, 0.99879545f, -0.99879545f,
+    1.0f, 1.0f, 0.99879545f, 0.99879545f,
+    0.0f, -0.0f, 0.0490676761f, -0.0490676761f,
+    1.0f, 1.0f, 0.999698818f, 0.999698818f,
+    0.0f, -0.0f, 0.024541229f, -0.024541229f,
+    0.707106769f, 0.707106769f, 0.689540565f, 0.689540565f,
+    0.707106769f, -0.707106769f, 0.724247098f, -0.724247098f,
+    0.99518472f, 0.99518472f, 0.989176512f, 0.989176512f,
+    0.0980171412f, -0.0980171412f, 0.146730468f, -0.146730468f,
+    0.99879545f, 0.99879545f, 0.997290432f, 0.997290432f,
+    0.0490676761f, -0.0490676761f, 0.0735645667f, -0.0735645667f,
+    0.671558976f, 0.671558976f, 0.653172851f, 0.653172851f,
+    0.740951121f, -0.740951121f, 0.757208824f, -0.757208824f,
+    0.980785251f, 0.980785251f, 0.970031261f, 0.970031261f,
+    0.195090324f, -0.195090324f, 0.242980182f, -0.242980182f,
+    0.99518472f, 0.99518472f, 0.992479563f, 0.992479563f,
+    0.0980171412f, -0.0980171412f, 0.122410677f, -0.122410677f,
+    0.634393275f, 0.634393275f, 0.615231574f, 0.615231574f,
+    0.773010433f, -0.773010433f, 0.78834641f, -0.78834641f,
+    0.956940353f, 0.956940353f, 0.941544056f, 0.941544056f,
+    0.290284663f, -0.290284663f, 0.336889863f, -0.336889863f,
+    0.989176512f, 0.989176512f, 0.985277653f, 0.985277653f,
+    0.146730468f, -0.146730468f, 0.170961887f, -0.170961887f,
+    0.59569931f, 0.59569931f, 0.575808167f, 0.575808167f,
+    0.803207517f, -0.803207517f, 0.817584813f, -0.817584813f,
+    0.923879504f, 0.923879504f, 0.903989315f, 0.903989315f,
+    0.382683426f, -0.382683426f, 0.427555084f, -0.427555084f,
+    0.980785251f, 0.980785251f, 0.975702107f, 0.975702107f,
+    0.195090324f, -0.195090324f, 0.219101235f, -0.219101235f,
+    0.555570245f, 0.555570245f, 0.534997642f, 0.534997642f,
+    0.831469595f, -0.831469595f, 0.84485358f, -0.84485358f,
+    0.881921291f, 0.881921291f, 0.857728601f, 0.857728601f,
+    0.471396744f, -0.471396744f, 0.514102757f, -0.514102757f,
+    0.970031261f, 0.970031261f, 0.963776052f, 0.963776052f,
+    0.242980182f, -0.242980182f, 0.266712755f, -0.266712755f,
+    0.514102757f, 0.514102757f, 0.492898196f, 0.492898196f,
+    0.857728601f, -0.857728601f, 0.870086968f, -0.870086968f,
+    0.831469595f, 0.831469595f, 0.803207517f, 0.803207517f,
+    0.555570245f, -0.555570245f, 0.59569931f, -0.59569931f,
+    0.956940353f, 0.956940353f, 0.949528158f, 0.949528158f,
+    0.290284663f, -0.290284663f, 0.313681751f, -0.313681751f,
+    0.471396744f, 0.471396744f, 0.449611336f, 0.449611336f,
+    0.881921291f, -0.881921291f, 0.893224299f, -0.893224299f,
+    0.773010433f, 0.773010433f, 0.740951121f, 0.740951121f,
+    0.634393275f, -0.634393275f, 0.671558976f, -0.671558976f,
+    0.941544056f, 0.941544056f, 0.932992816f, 0.932992816f,
+    0.336889863f, -0.336889863f, 0.359895051f, -0.359895051f,
+    0.427555084f, 0.427555084f, 0.405241311f, 0.405241311f,
+    0.903989315f, -0.903989315f, 0.914209783f, -0.914209783f,
+    0.707106769f, 0.707106769f, 0.671558976f, 0.671558976f,
+    0.707106769f, -0.707106769f, 0.740951121f, -0.740951121f,
+    0.923879504f, 0.923879504f, 0.914209783f, 0.914209783f,
+    0.382683426f, -0.382683426f, 0.405241311f, -0.405241311f,
+    0.382683426f, 0.382683426f, 0.359895051f, 0.359895051f,
+    0.923879504f, -0.923879504f, 0.932992816f, -0.932992816f,
+    0.634393275f, 0.634393275f, 0.59569931f, 0.59569931f,
+    0.773010433f, -0.773010433f, 0.803207517f, -0.803207517f,
+    0.903989315f, 0.903989315f, 0.893224299f, 0.893224299f,
+    0.427555084f, -0.427555084f, 0.449611336f, -0.449611336f,
+    0.336889863f, 0.336889863f, 0.313681751f, 0.313681751f,
+    0.941544056f, -0.941544056f, 0.949528158f, -0.949528158f,
+    0.555570245f, 0.555570245f, 0.514102757f, 0.514102757f,
+    0.831469595f, -0.831469595f, 0.857728601f, -0.857728601f,
+    0.881921291f, 0.881921291f, 0.870086968f, 0.870086968f,
+    0.471396744f, -0.471396744f, 0.492898196f, -0.492898196f,
+    0.290284663f, 0.290284663f, 0.266712755f, 0.266712755f,
+    0.956940353f, -0.956940353f, 0.963776052f, -0.963776052f,
+    0.471396744f, 0.471396744f, 0.427555084f, 0.427555084f,
+    0.881921291f, -0.881921291f, 0.903989315f, -0.903989315f,
+    0.857728601f, 0.857728601f, 0.84485358f, 0.84485358f,
+    0.514102757f, -0.514102757f, 0.534997642f, -0.534997642f,
+    0.242980182f, 0.242980182f, 0.219101235f, 0.219101235f,
+    0.970031261f, -0.970031261f, 0.975702107f, -0.975702107f,
+    0.382683426f, 0.382683426f, 0.336889863f, 0.336889863f,
+    0.923879504f, -0.923879504f, 0.941544056f, -0.941544056f,
+    0.831469595f, 0.831469595f, 0.817584813f, 0.817584813f,
+    0.555570245f, -0.555570245f, 0.575808167f, -0.575808167f,
+    0.195090324f, 0.195090324f, 0.170961887f, 0.170961887f,
+    0.980785251f, -0.980785251f, 0.985277653f, -0.985277653f,
+    0.290284663f, 0.290284663f, 0.242980182f, 0.242980182f,
+    0.956940353f, -0.956940353f, 0.970031261f, -0.970031261f,
+    0.803207517f, 0.803207517f, 0.78834641f, 0.78834641f,
+    0.59569931f, -0.59569931f, 0.615231574f, -0.615231574f,
+    0.146730468f, 0.146730468f, 0.122410677f, 0.122410677f,
+    0.989176512f, -0.989176512f, 0.992479563f, -0.992479563f,
+    0.195090324f, 0.195090324f, 0.146730468f, 0.146730468f,
+    0.980785251f, -0.980785251f, 0.989176512f, -0.989176512f,
+    0.773010433f, 0.773010433f, 0.757208824f, 0.757208824f,
+    0.634393275f, -0.634393275f, 0.653172851f, -0.653172851f,
+    0.0980171412f, 0.0980171412f, 0.0735645667f, 0.0735645667f,
+    0.99518472f, -0.99518472f, 0.997290432f, -0.997290432f,
+    0.0980171412f, 0.0980171412f, 0.0490676761f, 0.0490676761f,
+    0.99518472f, -0.99518472f, 0.99879545f, -0.99879545f,
+    0.740951121f, 0.740951121f, 0.724247098f, 0.724247098f,
+    0.671558976f, -0.671558976f, 0.689540565f, -0.689540565f,
+    0.0490676761f, 0.0490676761f, 0.024541229f, 0.024541229f,
+    0.99879545f, -0.99879545f, 0.999698818f, -0.999698818f,
+    1.0f, 1.0f, 0.999698818f, 0.999698818f,
+    0.0f, -0.0f, 0.024541229f, -0.024541229f,
+    1.0f, 1.0f, 0.999924719f, 0.999924719f,
+    0.0f, -0.0f, 0.0122715384f, -0.0122715384f,
+    0.707106769f, 0.707106769f, 0.698376238f, 0.698376238f,
+    0.707106769f, -0.707106769f, 0.715730846f, -0.715730846f,
+    0.99879545f, 0.99879545f, 0.997290432f, 0.997290432f,
+    0.0490676761f, -0.0490676761f, 0.0735645667f, -0.0735645667f,
+    0.999698818f, 0.999698818f, 0.999322355f, 0.999322355f,
+    0.024541229f, -0.024541229f, 0.0368072242f, -0.0368072242f,
+    0.689540565f, 0.689540565f, 0.680601001f, 0.680601001f,
+    0.724247098f, -0.724247098f, 0.732654274f, -0.732654274f,
+    0.99518472f, 0.99518472f, 0.992479563f, 0.992479563f,
+    0.0980171412f, -0.0980171412f, 0.122410677f, -0.122410677f,
+    0.99879545f, 0.99879545f, 0.998118103f, 0.998118103f,
+    0.0490676761f, -0.0490676761f, 0.061320737f, -0.061320737f,
+    0.671558976f, 0.671558976f, 0.662415802f, 0.662415802f,
+    0.740951121f, -0.740951121f, 0.749136388f, -0.749136388f,
+    0.989176512f, 0.989176512f, 0.985277653f, 0.985277653f,
+    0.146730468f, -0.146730468f, 0.170961887f, -0.170961887f,
+    0.997290432f, 0.997290432f, 0.996312618f, 0.996312618f,
+    0.0735645667f, -0.0735645667f, 0.0857973099f, -0.0857973099f,
+    0.653172851f, 0.653172851f, 0.643831551f, 0.643831551f,
+    0.757208824f, -0.757208824f, 0.765167236f, -0.765167236f,
+    0.980785251f, 0.980785251f, 0.975702107f, 0.975702107f,
+    0.195090324f, -0.195090324f, 0.219101235f, -0.219101235f,
+    0.99518472f, 0.99518472f, 0.993906975f, 0.993906975f,
+    0.0980171412f, -0.0980171412f, 0.110222206f, -0.110222206f,
+    0.634393275f, 0.634393275f, 0.624859512f, 0.624859512f,
+    0.773010433f, -0.773010433f, 0.780737221f, -0.780737221f,
+    0.970031261f, 0.970031261f, 0.963776052f, 0.963776052f,
+    0.242980182f, -0.242980182f, 0.266712755f, -0.266712755f,
+    0.992479563f, 0.992479563f, 0.990902662f, 0.990902662f,
+    0.122410677f, -0.122410677f, 0.134580702f, -0.134580702f,
+    0.615231574f, 0.615231574f, 0.605511069f, 0.605511069f,
+    0.78834641f, -0.78834641f, 0.795836926f, -0.795836926f,
+    0.956940353f, 0.956940353f, 0.949528158f, 0.949528158f,
+    0.290284663f, -0.290284663f, 0.313681751f, -0.313681751f,
+    0.989176512f, 0.989176512f, 0.987301409f, 0.987301409f,
+    0.146730468f, -0.146730468f, 0.15885815f, -0.15885815f,
+    0.59569931f, 0.59569931f, 0.585797846f, 0.585797846f,
+    0.803207517f, -0.803207517f, 0.81045717f, -0.81045717f,
+    0.941544056f, 0.941544056f, 0.932992816f, 0.932992816f,
+    0.336889863f, -0.336889863f, 0.359895051f, -0.359895051f,
+    0.985277653f, 0.985277653f, 0.983105481f, 0.983105481f,
+    0.170961887f, -0.170961887f, 0.183039889f, -0.183039889f,
+    0.575808167f, 0.575808167f, 0.565731823f, 0.565731823f,
+    0.817584813f, -0.817584813f, 0.824589312f, -0.824589312f,
+    0.923879504f, 0.923879504f, 0.914209783f, 0.914209783f,
+    0.382683426f, -0.382683426f, 0.405241311f, -0.405241311f,
+    0.980785251f, 0.980785251f, 0.97831738f, 0.97831738f,
+    0.195090324f, -0.195090324f, 0.207111374f, -0.207111374f,
+    0.555570245f, 0.555570245f, 0.545324981f, 0.545324981f,
+    0.831469595f, -0.831469595f, 0.838224709f, -0.838224709f,
+    0.903989315f, 0.903989315f, 0.893224299f, 0.893224299f,
+    0.427555084f, -0.427555084f, 0.449611336f, -0.449611336f,
+    0.975702107f, 0.975702107f, 0.972939968f, 0.972939968f,
+    0.219101235f, -0.219101235f, 0.231058106f, -0.231058106f,
+    0.534997642f, 0.534997642f, 0.524589658f, 0.524589658f,
+    0.84485358f, -0.84485358f, 0.851355195f, -0.851355195f,
+    0.881921291f, 0.881921291f, 0.870086968f, 0.870086968f,
+    0.471396744f, -0.471396744f, 0.492898196f, -0.492898196f,
+    0.970031261f, 0.970031261f, 0.966976464f, 0.966976464f,
+    0.242980182f, -0.242980182f, 0.254865646f, -0.254865646f,
+    0.514102757f, 0.514102757f, 0.50353837f, 0.50353837f,
+    0.857728601f, -0.857728601f, 0.863972843f, -0.863972843f,
+    0.857728601f, 0.857728601f, 0.84485358f, 0.84485358f,
+    0.514102757f, -0.514102757f, 0.534997642f, -0.534997642f,
+    0.963776052f, 0.963776052f, 0.960430503f, 0.960430503f,
+    0.266712755f, -0.266712755f, 0.27851969f, -0.27851969f,
+    0.492898196f, 0.492898196f, 0.482183784f, 0.482183784f,
+    0.870086968f, -0.870086968f, 0.876070082f, -0.876070082f,
+    0.831469595f, 0.831469595f, 0.817584813f, 0.817584813f,
+    0.555570245f, -0.555570245f, 0.575808167f, -0.575808167f,
+    0.956940353f, 0.956940353f, 0.953306019f, 0.953306019f,
+    0.290284663f, -0.290284663f, 0.302005947f, -0.302005947f,
+    0.471396744f, 0.471396744f, 0.460538715f, 0.460538715f,
+    0.881921291f, -0.881921291f, 0.887639642f, -0.887639642f,
+    0.803207517f, 0.803207517f, 0.78834641f, 0.78834641f,
+    0.59569931f, -0.59569931f, 0.615231574f, -0.615231574f,
+    0.949528158f, 0.949528158f, 0.945607305f, 0.945607305f,
+    0.313681751f, -0.313681751f, 0.32531029f, -0.32531029f,
+    0.449611336f, 0.449611336f, 0.438616246f, 0.438616246f,
+    0.893224299f, -0.893224299f, 0.898674488f, -0.898674488f,
+    0.773010433f, 0.773010433f, 0.757208824f, 0.757208824f,
+    0.634393275f, -0.634393275f, 0.653172851f, -0.653172851f,
+    0.941544056f, 0.941544056f, 0.937339008f, 0.937339008f,
+    0.336889863f, -0.336889863f, 0.348418683f, -0.348418683f,
+    0.427555084f, 0.427555084f, 0.416429549f, 0.416429549f,
+    0.903989315f, -0.903989315f, 0.909168005f, -0.909168005f,
+    0.740951121f, 0.740951121f, 0.724247098f, 0.724247098f,
+    0.671558976f, -0.671558976f, 0.689540565f, -0.689540565f,
+    0.932992816f, 0.932992816f, 0.928506076f, 0.928506076f,
+    0.359895051f, -0.359895051f, 0.371317208f, -0.371317208f,
+    0.405241311f, 0.405241311f, 0.393992037f, 0.393992037f,
+    0.914209783f, -0.914209783f, 0.919113874f, -0.919113874f,
+    0.707106769f, 0.707106769f, 0.689540565f, 0.689540565f,
+    0.707106769f, -0.707106769f, 0.724247098f, -0.724247098f,
+    0.923879504f, 0.923879504f, 0.919113874f, 0.919113874f,
+    0.382683426f, -0.382683426f, 0.393992037f, -0.393992037f,
+    0.382683426f, 0.382683426f, 0.371317208f, 0.371317208f,
+    0.923879504f, -0.923879504f, 0.928506076f, -0.928506076f,
+    0.671558976f, 0.671558976f, 0.653172851f, 0.653172851f,
+    0.740951121f, -0.740951121f, 0.757208824f, -0.757208824f,
+    0.914209783f, 0.914209783f, 0.909168005f, 0.909168005f,
+    0.405241311f, -0.405241311f, 0.416429549f, -0.416429549f,
+    0.359895051f, 0.359895051f, 0.348418683f, 0.348418683f,
+    0.932992816f, -0.932992816f, 0.937339008f, -0.937339008f,
+    0.634393275f, 0.634393275f, 0.615231574f, 0.615231574f,
+    0.773010433f, -0.773010433f, 0.78834641f, -0.78834641f,
+    0.903989315f, 0.903989315f, 0.898674488f, 0.898674488f,
+    0.427555084f, -0.427555084f, 0.438616246f, -0.438616246f,
+    0.336889863f, 0.336889863f, 0.32531029f, 0.32531029f,
+    0.941544056f, -0.941544056f, 0.945607305f, -0.945607305f,
+    0.59569931f, 0.59569931f, 0.575808167f, 0.575808167f,
+    0.803207517f, -0.803207517f, 0.817584813f, -0.817584813f,
+    0.893224299f, 0.893224299f, 0.887639642f, 0.887639642f,
+    0.449611336f, -0.449611336f, 0.460538715f, -0.460538715f,
+    0.313681751f, 0.313681751f, 0.302005947f, 0.302005947f,
+    0.949528158f, -0.949528158f, 0.953306019f, -0.953306019f,
+    0.555570245f, 0.555570245f, 0.534997642f, 0.534997642f,
+    0.831469595f, -0.831469595f, 0.84485358f, -0.84485358f,
+    0.881921291f, 0.881921291f, 0.876070082f, 0.876070082f,
+    0.471396744f, -0.471396744f, 0.482183784f, -0.482183784f,
+    0.290284663f, 0.290284663f, 0.27851969f, 0.27851969f,
+    0.956940353f, -0.956940353f, 0.960430503f, -0.960430503f,
+    0.514102757f, 0.514102757f, 0.492898196f, 0.492898196f,
+    0.857728601f, -0.857728601f, 0.870086968f, -0.870086968f,
+    0.870086968f, 0.870086968f, 0.863972843f, 0.863972843f,
+    0.492898196f, -0.492898196f, 0.50353837f, -0.50353837f,
+    0.266712755f, 0.266712755f, 0.254865646f, 0.254865646f,
+    0.963776052f, -0.963776052f, 0.966976464f, -0.966976464f,
+    0.471396744f, 0.471396744f, 0.449611336f, 0.449611336f,
+    0.881921291f, -0.881921291f, 0.893224299f, -0.893224299f,
+    0.857728601f, 0.857728601f, 0.851355195f, 0.851355195f,
+    0.514102757f, -0.514102757f, 0.524589658f, -0.524589658f,
+    0.242980182f, 0.242980182f, 0.231058106f, 0.231058106f,
+    0.970031261f, -0.970031261f, 0.972939968f, -0.972939968f,
+    0.427555084f, 0.427555084f, 0.405241311f, 0.405241311f,
+    0.903989315f, -0.903989315f, 0.914209783f, -0.914209783f,
+    0.84485358f, 0.84485358f, 0.838224709f, 0.838224709f,
+    0.534997642f, -0.534997642f, 0.545324981f, -0.545324981f,
+    0.219101235f, 0.219101235f, 0.207111374f, 0.207111374f,
+    0.975702107f, -0.975702107f, 0.97831738f, -0.97831738f,
+    0.382683426f, 0.382683426f, 0.359895051f, 0.359895051f,
+    0.923879504f, -0.923879504f, 0.932992816f, -0.932992816f,
+    0.831469595f, 0.831469595f, 0.824589312f, 0.824589312f,
+    0.555570245f, -0.555570245f, 0.565731823f, -0.565731823f,
+    0.195090324f, 0.195090324f, 0.183039889f, 0.183039889f,
+    0.980785251f, -0.980785251f, 0.983105481f, -0.983105481f,
+    0.336889863f, 0.336889863f, 0.313681751f, 0.313681751f,
+    0.941544056f, -0.941544056f, 0.949528158f, -0.949528158f,
+    0.817584813f, 0.817584813f, 0.81045717f, 0.81045717f,
+    0.575808167f, -0.575808167f, 0.585797846f, -0.585797846f,
+    0.170961887f, 0.170961887f, 0.15885815f, 0.15885815f,
+    0.985277653f, -0.985277653f, 0.987301409f, -0.987301409f,
+    0.290284663f, 0.290284663f, 0.266712755f, 0.266712755f,
+    0.956940353f, -0.956940353f, 0.963776052f, -0.963776052f,
+    0.803207517f, 0.803207517f, 0.795836926f, 0.795836926f,
+    0.59569931f, -0.59569931f, 0.605511069f, -0.605511069f,
+    0.146730468f, 0.146730468f, 0.134580702f, 0.134580702f,
+    0.989176512f, -0.989176512f, 0.990902662f, -0.990902662f,
+    0.242980182f, 0.242980182f, 0.219101235f, 0.219101235f,
+    0.970031261f, -0.970031261f, 0.975702107f, -0.975702107f,
+    0.78834641f, 0.78834641f, 0.780737221f, 0.780737221f,
+    0.615231574f, -0.615231574f, 0.624859512f, -0.624859512f,
+    0.122410677f, 0.122410677f, 0.110222206f, 0.110222206f,
+    0.992479563f, -0.992479563f, 0.993906975f, -0.993906975f,
+    0.195090324f, 0.195090324f, 0.170961887f, 0.170961887f,
+    0.980785251f, -0.980785251f, 0.985277653f, -0.985277653f,
+    0.773010433f, 0.773010433f, 0.765167236f, 0.765167236f,
+    0.634393275f, -0.634393275f, 0.643831551f, -0.643831551f,
+    0.0980171412f, 0.0980171412f, 0.0857973099f, 0.0857973099f,
+    0.99518472f, -0.99518472f, 0.996312618f, -0.996312618f,
+    0.146730468f, 0.146730468f, 0.122410677f, 0.122410677f,
+    0.989176512f, -0.989176512f, 0.992479563f, -0.992479563f,
+    0.757208824f, 0.757208824f, 0.749136388f, 0.749136388f,
+    0.653172851f, -0.653172851f, 0.662415802f, -0.662415802f,
+    0.0735645667f, 0.0735645667f, 0.061320737f, 0.061320737f,
+    0.997290432f, -0.997290432f, 0.998118103f, -0.998118103f,
+    0.0980171412f, 0.0980171412f, 0.0735645667f, 0.0735645667f,
+    0.99518472f, -0.99518472f, 0.997290432f, -0.997290432f,
+    0.740951121f, 0.740951121f, 0.732654274f, 0.732654274f,
+    0.671558976f, -0.671558976f, 0.680601001f, -0.680601001f,
+    0.0490676761f, 0.0490676761f, 0.0368072242f, 0.0368072242f,
+    0.99879545f, -0.99879545f, 0.999322355f, -0.999322355f,
+    0.0490676761f, 0.0490676761f, 0.024541229f, 0.024541229f,
+    0.99879545f, -0.99879545f, 0.999698818f, -0.999698818f,
+    0.724247098f, 0.724247098f, 0.715730846f, 0.715730846f,
+    0.689540565f, -0.689540565f, 0.698376238f, -0.698376238f,
+    0.024541229f, 0.024541229f, 0.0122715384f, 0.0122715384f,
+    0.999698818f, -0.999698818f, 0.999924719f, -0.999924719f
+};
+
+static const int32_t ffts_small_is32[8] = {
+    0, 32, 16, 48, 8, 40, 56, 24
+};
+
+static const int32_t ffts_small_os32[4] = {
+    0, 32, 16, 48
+};
+
+static const int32_t ffts_small_is64[8] = {
+    0, 64, 32, 96, 16, 80, 112, 48
+};
+
+static const int32_t ffts_small_os64[8] = {
+    0, 64, 32, 112, 16, 80, 48, 96
+};
+
+static const int32_t ffts_small_is128[8] = {
+    0, 128, 64, 192, 32, 160, 224, 96
+};
+
+static const int32_t ffts_small_os128[16] = {
+    0, 128, 64, 224, 32, 160, 112, 208,
+    16, 144, 80, 240, 48, 176, 96, 192
+};
+
+static const int32_t ffts_small_is256[8] = {
+    0, 256, 128, 384, 64, 320, 448, 192
+};
+
+static const int32_t ffts_small_os256[32] = {
+    0, 256, 128, 448, 64, 320, 224, 416,
+    32, 288, 160, 496, 112, 368, 208, 400,
+    16, 272, 144, 464, 80, 336, 240, 432,
+    48, 304, 176, 480, 96, 352, 192, 384
+};
+
+static const int32_t ffts_small_is512[8] = {
+    0, 512, 256, 768, 128, 640, 896, 384
+};
+
+static const int32_t ffts_small_os512[64] = {
+    0, 512, 256, 896, 128, 640, 448, 832,
+    64, 576, 320, 992, 224, 736, 416, 800,
+    32, 544, 288, 928, 160, 672, 496, 880,
+    112, 624, 368, 976, 208, 720, 400, 784,
+    16, 528, 272, 912, 144, 656, 464, 848,
+    80, 592, 336, 1008, 240, 752, 432, 816,
+    48, 560, 304, 944, 176, 688, 480, 864,
+    96, 608, 352, 960, 192, 704, 384, 768
+};
+
+static FFTS_ALWAYS_INLINE void
+ffts_small_transform32_32f(const float *FFTS_RESTRICT din,
+                          float *FFTS_RESTRICT dout,
+                          int inv,
+                          const float *FFTS_RESTRICT scale)
+{
+    const float *FFTS_RESTRICT lut = inv ?
+        ffts_small_lut_inv_32f : ffts_small_lut_32f;
+
+    V4SF_LEAF_EE(dout, ffts_small_os32 + 0, din + 0, ffts_small_is32, inv);
+    V4SF_LEAF_OE(dout, ffts_small_os32 + 2, din + 4, ffts_small_is32, inv);
+
+    V4SF_X_8_SPLIT(inv, scale, dout + 0, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, scale, dout + 4, 32, 1, lut + 40);
+}
+
+static FFTS_ALWAYS_INLINE void
+ffts_small_transform64_32f(const float *FFTS_RESTRICT din,
+                          float *FFTS_RESTRICT dout,
+                          int inv,
+                          const float *FFTS_RESTRICT scale)
+{
+    const float *FFTS_RESTRICT lut = inv ?
+        ffts_small_lut_inv_32f : ffts_small_lut_32f;
+
+    V4SF_LEAF_EE(dout, ffts_small_os64 + 0, din + 0, ffts_small_is64, inv);
+    V4SF_LEAF_EO(dout, ffts_small_os64 + 2, din + 4, ffts_small_is64, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os64 + 4, din + 8, ffts_small_is64, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os64 + 6, din + 12, ffts_small_is64, inv);
+
+    V4SF_X_4_SPLIT(inv, dout + 0, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 64, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 96, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, scale, dout + 0, 64, 1, lut + 64);
+    V4SF_X_8_SPLIT(inv, scale, dout + 4, 64, 1, lut + 88);
+    V4SF_X_8_SPLIT(inv, scale, dout + 8, 64, 1, lut + 112);
+    V4SF_X_8_SPLIT(inv, scale, dout + 12, 64, 1, lut + 136);
+}
+
+static FFTS_ALWAYS_INLINE void
+ffts_small_transform128_32f(const float *FFTS_RESTRICT din,
+                          float *FFTS_RESTRICT dout,
+                          int inv,
+                          const float *FFTS_RESTRICT scale)
+{
+    const float *FFTS_RESTRICT lut = inv ?
+        ffts_small_lut_inv_32f : ffts_small_lut_32f;
+
+    V4SF_LEAF_EE(dout, ffts_small_os128 + 0, din + 0, ffts_small_is128, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os128 + 2, din + 4, ffts_small_is128, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os128 + 4, din + 8, ffts_small_is128, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os128 + 6, din + 12, ffts_small_is128, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os128 + 8, din + 16, ffts_small_is128, inv);
+    V4SF_LEAF_OE(dout, ffts_small_os128 + 10, din + 20, ffts_small_is128, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os128 + 12, din + 24, ffts_small_is128, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os128 + 14, din + 28, ffts_small_is128, inv);
+
+    V4SF_X_8_SPLIT(inv, NULL, dout + 0, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 4, 32, 1, lut + 40);
+    V4SF_X_4_SPLIT(inv, dout + 64, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 96, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 128, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 132, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 192, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 196, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, scale, dout + 0, 128, 8, lut + 160);
+}
+
+static FFTS_ALWAYS_INLINE void
+ffts_small_transform256_32f(const float *FFTS_RESTRICT din,
+                          float *FFTS_RESTRICT dout,
+                          int inv,
+                          const float *FFTS_RESTRICT scale)
+{
+    const float *FFTS_RESTRICT lut = inv ?
+        ffts_small_lut_inv_32f : ffts_small_lut_32f;
+
+    V4SF_LEAF_EE(dout, ffts_small_os256 + 0, din + 0, ffts_small_is256, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os256 + 2, din + 4, ffts_small_is256, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os256 + 4, din + 8, ffts_small_is256, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os256 + 6, din + 12, ffts_small_is256, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os256 + 8, din + 16, ffts_small_is256, inv);
+    V4SF_LEAF_EO(dout, ffts_small_os256 + 10, din + 20, ffts_small_is256, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os256 + 12, din + 24, ffts_small_is256, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os256 + 14, din + 28, ffts_small_is256, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os256 + 16, din + 32, ffts_small_is256, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os256 + 18, din + 36, ffts_small_is256, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os256 + 20, din + 40, ffts_small_is256, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os256 + 22, din + 44, ffts_small_is256, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os256 + 24, din + 48, ffts_small_is256, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os256 + 26, din + 52, ffts_small_is256, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os256 + 28, din + 56, ffts_small_is256, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os256 + 30, din + 60, ffts_small_is256, inv);
+
+    V4SF_X_4_SPLIT(inv, dout + 0, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 64, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 96, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 0, 64, 1, lut + 64);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 4, 64, 1, lut + 88);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 8, 64, 1, lut + 112);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 12, 64, 1, lut + 136);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 128, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 132, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 192, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 196, 32, 1, lut + 40);
+    V4SF_X_4_SPLIT(inv, dout + 256, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 320, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 352, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 256, 64, 1, lut + 64);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 260, 64, 1, lut + 88);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 264, 64, 1, lut + 112);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 268, 64, 1, lut + 136);
+    V4SF_X_4_SPLIT(inv, dout + 384, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 448, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 480, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 384, 64, 1, lut + 64);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 388, 64, 1, lut + 88);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 392, 64, 1, lut + 112);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 396, 64, 1, lut + 136);
+    V4SF_X_8_SPLIT(inv, scale, dout + 0, 256, 16, lut + 352);
+}
+
+static FFTS_ALWAYS_INLINE void
+ffts_small_transform512_32f(const float *FFTS_RESTRICT din,
+                          float *FFTS_RESTRICT dout,
+                          int inv,
+                          const float *FFTS_RESTRICT scale)
+{
+    const float *FFTS_RESTRICT lut = inv ?
+        ffts_small_lut_inv_32f : ffts_small_lut_32f;
+
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 0, din + 0, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 2, din + 4, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 4, din + 8, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 6, din + 12, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 8, din + 16, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 10, din + 20, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 12, din + 24, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 14, din + 28, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 16, din + 32, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 18, din + 36, ffts_small_is512, inv);
+    V4SF_LEAF_EE(dout, ffts_small_os512 + 20, din + 40, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 22, din + 44, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 24, din + 48, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 26, din + 52, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 28, din + 56, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 30, din + 60, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 32, din + 64, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 34, din + 68, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 36, din + 72, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 38, din + 76, ffts_small_is512, inv);
+    V4SF_LEAF_OO(dout, ffts_small_os512 + 40, din + 80, ffts_small_is512, inv);
+    V4SF_LEAF_OE(dout, ffts_small_os512 + 42, din + 84, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 44, din + 88, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 46, din + 92, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 48, din + 96, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 50, din + 100, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 52, din + 104, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 54, din + 108, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 56, din + 112, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 58, din + 116, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 60, din + 120, ffts_small_is512, inv);
+    V4SF_LEAF_EE2(dout, ffts_small_os512 + 62, din + 124, ffts_small_is512, inv);
+
+    V4SF_X_8_SPLIT(inv, NULL, dout + 0, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 4, 32, 1, lut + 40);
+    V4SF_X_4_SPLIT(inv, dout + 64, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 96, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 128, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 132, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 192, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 196, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 0, 128, 8, lut + 160);
+    V4SF_X_4_SPLIT(inv, dout + 256, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 320, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 352, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 256, 64, 1, lut + 64);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 260, 64, 1, lut + 88);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 264, 64, 1, lut + 112);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 268, 64, 1, lut + 136);
+    V4SF_X_4_SPLIT(inv, dout + 384, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 448, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 480, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 384, 64, 1, lut + 64);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 388, 64, 1, lut + 88);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 392, 64, 1, lut + 112);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 396, 64, 1, lut + 136);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 512, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 516, 32, 1, lut + 40);
+    V4SF_X_4_SPLIT(inv, dout + 576, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 608, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 640, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 644, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 704, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 708, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 512, 128, 8, lut + 160);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 768, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 772, 32, 1, lut + 40);
+    V4SF_X_4_SPLIT(inv, dout + 832, 16, lut + 0);
+    V4SF_X_4_SPLIT(inv, dout + 864, 16, lut + 0);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 896, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 900, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 960, 32, 1, lut + 16);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 964, 32, 1, lut + 40);
+    V4SF_X_8_SPLIT(inv, NULL, dout + 768, 128, 8, lut + 160);
+    V4SF_X_8_SPLIT(inv, scale, dout + 0, 512, 32, lut + 736);
+}
+
+#endif /* FFTS_SMALL_KERNELS_H */
@@ -40,6 +40,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "neon.h"
 #endif
 
+#if defined(HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
 #include <assert.h>
 
 static const FFTS_ALIGN(16) float ffts_constants_small_32f[24] = {
@@ -258,7 +262,7 @@ static const FFTS_ALIGN(16) double ffts_constants_inv_64f[16] = {
     -0.7071067811865475244008443621048490392848359376884740
 };
 
-static FFTS_INLINE void
+static FFTS_ALWAYS_INLINE void
 V4SF_K_0(int inv,
          V4SF *r0,
          V4SF *r1,
@@ -279,7 +283,7 @@ V4SF_K_0(int inv,
     *r3 = V4SF_ADD(t1, t3);
 }
 
-static FFTS_INLINE void
+static FFTS_ALWAYS_INLINE void
 V4SF_L_2(const float *FFTS_RESTRICT i0,
          const float *FFTS_RESTRICT i1,
          const float *FFTS_RESTRICT i2,
@@ -302,7 +306,7 @@ V4SF_L_2(const float *FFTS_RESTRICT i0,
     *r3 = V4SF_SUB(t2, t3);
 }
 
-static FFTS_INLINE void
+static FFTS_ALWAYS_INLINE void
 V4SF_L_4(int inv,
          const float *FFTS_RESTRICT i0,
          const float *FFTS_RESTRICT i1,
@@ -331,11 +335,11 @@ V4SF_L_4(int inv,
     *r3 = V4SF_ADD(t5, t7);
 }
 
-static FFTS_INLINE void
+static FFTS_ALWAYS_INLINE void
 V4SF_LEAF_EE(float *const FFTS_RESTRICT out,
-             const ptrdiff_t *FFTS_RESTRICT os,
-             const float     *FFTS_RESTRICT in,
-             const ptrdiff_t *FFTS_RESTRICT is,
+             const int32_t *FFTS_RESTRICT os,
+             const float   *FFTS_RESTRICT in,
+             const int32_t *FFTS_RESTRICT is,
              int inv)
 {
     const float *FFTS_RESTRICT LUT = inv ? ffts_constants_inv_32f : ffts_constants_32f;
@@ -359,11 +363,11 @@ V4SF_LEAF_EE(float *const FFTS_RESTRICT out,
     V4SF_S_4(r1, r3, r5, r7, out1 + 0, out1 + 4, out1 + 8, out1 + 12);
 }
 
-static FFTS_INLINE void
+static FFTS_ALWAYS_INLINE void
 V4SF_LEAF_EE2(float *const FFTS_RESTRICT out,
-              const ptrdiff_t *FFTS_RESTRICT os,
+              const int32_t *FFTS_RESTRICT os,
               const float *FFTS_RESTRICT in,
-              const ptrdiff_t *FFTS_RESTRICT is,
+              const int32_t *FFTS_RESTRICT is,
               int inv)
 {
     const float *FFTS_RESTRICT LUT = inv ? ffts_constants_inv_32f : ffts_constants_32f;
@@ -387,11 +391,11 @@ V4SF_LEAF_EE2(float *const FFTS_RESTRICT out,
     V4SF_S_4(r1, r3, r5, r7, out1 + 0, out1 + 4, out1 + 8, out1 + 12);
 }
 
-static FFTS_INLINE void
+static FFTS_ALWAYS_INLINE void
 V4SF_LEAF_EO(float *const FFTS_RESTRICT out,
-             const ptrdiff_t *FFTS_RESTRICT os,
+             const int32_t *FFTS_RESTRICT os,
              const float *FFTS_RESTRICT in,
-             const ptrdiff_t *FFTS_RESTRICT is,
+             const int32_t *FFTS_RESTRICT is,
              int inv)
 {
     const float *FFTS_RESTRICT LUT = inv ? ffts_constants_inv_32f : ffts_constants_32f;
@@ -409,11 +413,11 @@ V4SF_LEAF_EO(float *const FFTS_RESTRICT out,
     V4SF_S_4(r0, r1, r4, r5, out0 + 0, out0 + 4, out0 + 8, out0 + 12);
 }
 
-static FFTS_INLINE void
+static FFTS_ALWAYS_INLINE void
 V4SF_LEAF_OE(float *const FFTS_RESTRICT out,
-             const ptrdiff_t *FFTS_RESTRICT os,
+             const int32_t *FFTS_RESTRICT os,
              const float *FFTS_RESTRICT in,
-             const ptrdiff_t *FFTS_RESTRICT is,
+             const int32_t *FFTS_RESTRICT is,
              int inv)
 {
     const float *FFTS_RESTRICT LUT = inv ? ffts_constants_inv_32f : ffts_constants_32f;
@@ -431,11 +435,11 @@ V4SF_LEAF_OE(float *const FFTS_RESTRICT out,
     V4SF_S_4(r6, r7, r2, r3, out1 + 0, out1 + 4, out1 + 8, out1 + 12);
 }
 
-static FFTS_INLINE void
+static FFTS_ALWAYS_INLINE void
 V4SF_LEAF_OO(float *const FFTS_RESTRICT out,
-             const ptrdiff_t *FFTS_RESTRICT os,
+             const int32_t *FFTS_RESTRICT os,
              const float *FFTS_RESTRICT in,
-             const ptrdiff_t *FFTS_RESTRICT is,
+             const int32_t *FFTS_RESTRICT is,
              int inv)
 {
     V4SF r0, r1, r2, r3, r4, r5, r6, r7;
@@ -450,7 +454,25 @@ V4SF_LEAF_OO(float *const FFTS_RESTRICT out,
     V4SF_S_4(r2, r3, r6, r7, out1 + 0, out1 + 4, out1 + 8, out1 + 12);
 }
 
-static FFTS_INLINE void
+/* butterfly with two twiddle factors stored as [re0, im0, re1, im1],
+   the real and imaginary parts are duplicated after the load */
+static FFTS_ALWAYS_INLINE void
+V4SF_K_N_LUT(int inv,
+             const float *FFTS_RESTRICT LUT,
+             V4SF *r0,
+             V4SF *r1,
+             V4SF *r2,
+             V4SF *r3)
+{
+    const V4SF sign = inv ?
+        V4SF_LIT4(0.0f, -0.0f, 0.0f, -0.0f) : V4SF_LIT4(-0.0f, 0.0f, -0.0f, 0.0f);
+    V4SF w = V4SF_LD(LUT);
+
+    V4SF_K_N(inv, V4SF_DUPLICATE_RE(w), V4SF_XOR(V4SF_DUPLICATE_IM(w), sign),
+        r0, r1, r2, r3);
+}
+
+static FFTS_ALWAYS_INLINE void
 V4SF_X_4(int inv,
          float *FFTS_RESTRICT data,
          size_t N,
@@ -464,24 +486,41 @@ V4SF_X_4(int inv,
         V4SF r2 = V4SF_LD(data + 4*N/4);
         V4SF r3 = V4SF_LD(data + 6*N/4);
 
-        V4SF_K_N(inv, V4SF_LD(LUT), V4SF_LD(LUT + 4), &r0, &r1, &r2, &r3);
+        V4SF_K_N_LUT(inv, LUT, &r0, &r1, &r2, &r3);
 
         V4SF_ST(data        , r0);
         V4SF_ST(data + 2*N/4, r1);
         V4SF_ST(data + 4*N/4, r2);
         V4SF_ST(data + 6*N/4, r3);
 
-        LUT += 8;
+        LUT += 4;
         data += 4;
     }
 }
 
-static FFTS_INLINE void
-V4SF_X_8(int inv,
-         float *FFTS_RESTRICT data0,
-         size_t N,
-         const float *FFTS_RESTRICT LUT)
+static FFTS_ALWAYS_INLINE void
+V4SF_X_8_STORE(int stream, float *FFTS_RESTRICT addr, V4SF r)
 {
+    if (stream) {
+        V4SF_STREAM(addr, r);
+    } else {
+        V4SF_ST(addr, r);
+    }
+}
+
+/* count butterflies of a pass of size N, N/16 for the whole pass, the
+   results are multiplied by scale unless NULL */
+static FFTS_ALWAYS_INLINE void
+V4SF_X_8_PASS(int inv,
+              int stream,
+              const float *FFTS_RESTRICT scale,
+              float *FFTS_RESTRICT data0,
+              size_t N,
+              size_t count,
+              const float *FFTS_RESTRICT LUT)
+{
+    const float k = scale ? *scale : 1.0f;
+    const V4SF s = V4SF_LIT4(k, k, k, k);
     float *data1 = data0 + 1*N/4;
     float *data2 = data0 + 2*N/4;
     float *data3 = data0 + 3*N/4;
@@ -491,7 +530,7 @@ V4SF_X_8(int inv,
     float *data7 = data0 + 7*N/4;
     size_t i;
 
-    for (i = 0; i < N/16; i++) {
+    for (i = 0; i < count; i++) {
         V4SF r0, r1, r2, r3, r4, r5, r6, r7;
 
         r0 = V4SF_LD(data0);
@@ -499,43 +538,293 @@ V4SF_X_8(int inv,
         r2 = V4SF_LD(data2);
         r3 = V4SF_LD(data3);
 
-        V4SF_K_N(inv, V4SF_LD(LUT), V4SF_LD(LUT + 4), &r0, &r1, &r2, &r3);
+        V4SF_K_N_LUT(inv, LUT, &r0, &r1, &r2, &r3);
         r4 = V4SF_LD(data4);
         r6 = V4SF_LD(data6);
 
-        V4SF_K_N(inv, V4SF_LD(LUT + 8), V4SF_LD(LUT + 12), &r0, &r2, &r4, &r6);
+        V4SF_K_N_LUT(inv, LUT + 4, &r0, &r2, &r4, &r6);
         r5 = V4SF_LD(data5);
         r7 = V4SF_LD(data7);
 
-        V4SF_K_N(inv, V4SF_LD(LUT + 16), V4SF_LD(LUT + 20), &r1, &r3, &r5, &r7);
-        LUT += 24;
-
-        V4SF_ST(data0, r0);
+        V4SF_K_N_LUT(inv, LUT + 8, &r1, &r3, &r5, &r7);
+        LUT += 12;
+
+        if (scale) {
+            r0 = V4SF_MUL(r0, s);
+            r1 = V4SF_MUL(r1, s);
+            r2 = V4SF_MUL(r2, s);
+            r3 = V4SF_MUL(r3, s);
+            r4 = V4SF_MUL(r4, s);
+            r5 = V4SF_MUL(r5, s);
+            r6 = V4SF_MUL(r6, s);
+            r7 = V4SF_MUL(r7, s);
+        }
+
+        V4SF_X_8_STORE(stream, data0, r0);
         data0 += 4;
 
-        V4SF_ST(data1, r1);
+        V4SF_X_8_STORE(stream, data1, r1);
         data1 += 4;
 
-        V4SF_ST(data2, r2);
+        V4SF_X_8_STORE(stream, data2, r2);
         data2 += 4;
 
-        V4SF_ST(data3, r3);
+        V4SF_X_8_STORE(stream, data3, r3);
         data3 += 4;
 
-        V4SF_ST(data4, r4);
+        V4SF_X_8_STORE(stream, data4, r4);
         data4 += 4;
 
-        V4SF_ST(data5, r5);
+        V4SF_X_8_STORE(stream, data5, r5);
         data5 += 4;
 
-        V4SF_ST(data6, r6);
+        V4SF_X_8_STORE(stream, data6, r6);
         data6 += 4;
 
-        V4SF_ST(data7, r7);
+        V4SF_X_8_STORE(stream, data7, r7);
         data7 += 4;
     }
 }
 
+static FFTS_ALWAYS_INLINE void
+V4SF_X_8(int inv,
+         float *FFTS_RESTRICT data0,
+         size_t N,
+         const float *FFTS_RESTRICT LUT)
+{
+    V4SF_X_8_PASS(inv, 0, NULL, data0, N, N/16, LUT);
+}
+
+/* butterflies of V4SF_X_4 and V4SF_X_8_PASS reading tables with the
+   twiddle factors already duplicated and signed for the direction, as
+   [re0, re0, re1, re1] followed by [im0, -im0, im1, -im1] */
+static FFTS_ALWAYS_INLINE void
+V4SF_X_4_SPLIT(int inv,
+               float *FFTS_RESTRICT data,
+               size_t N,
+               const float *FFTS_RESTRICT LUT)
+{
+    size_t i;
+
+    for (i = 0; i < N/8; i++) {
+        V4SF r0 = V4SF_LD(data);
+        V4SF r1 = V4SF_LD(data + 2*N/4);
+        V4SF r2 = V4SF_LD(data + 4*N/4);
+        V4SF r3 = V4SF_LD(data + 6*N/4);
+
+        V4SF_K_N(inv, V4SF_LD(LUT), V4SF_LD(LUT + 4), &r0, &r1, &r2, &r3);
+
+        V4SF_ST(data        , r0);
+        V4SF_ST(data + 2*N/4, r1);
+        V4SF_ST(data + 4*N/4, r2);
+        V4SF_ST(data + 6*N/4, r3);
+
+        LUT += 8;
+        data += 4;
+    }
+}
+
+static FFTS_ALWAYS_INLINE void
+V4SF_X_8_SPLIT(int inv,
+               const float *FFTS_RESTRICT scale,
+               float *FFTS_RESTRICT data0,
+               size_t N,
+               size_t count,
+               const float *FFTS_RESTRICT LUT)
+{
+    const float k = scale ? *scale : 1.0f;
+    const V4SF s = V4SF_LIT4(k, k, k, k);
+    float *data1 = data0 + 1*N/4;
+    float *data2 = data0 + 2*N/4;
+    float *data3 = data0 + 3*N/4;
+    float *data4 = data0 + 4*N/4;
+    float *data5 = data0 + 5*N/4;
+    float *data6 = data0 + 6*N/4;
+    float *data7 = data0 + 7*N/4;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        V4SF r0, r1, r2, r3, r4, r5, r6, r7;
+
+        r0 = V4SF_LD(data0 + 4*i);
+        r1 = V4SF_LD(data1 + 4*i);
+        r2 = V4SF_LD(data2 + 4*i);
+        r3 = V4SF_LD(data3 + 4*i);
+
+        V4SF_K_N(inv, V4SF_LD(LUT), V4SF_LD(LUT + 4), &r0, &r1, &r2, &r3);
+        r4 = V4SF_LD(data4 + 4*i);
+        r6 = V4SF_LD(data6 + 4*i);
+
+        V4SF_K_N(inv, V4SF_LD(LUT + 8), V4SF_LD(LUT + 12), &r0, &r2, &r4, &r6);
+        r5 = V4SF_LD(data5 + 4*i);
+        r7 = V4SF_LD(data7 + 4*i);
+
+        V4SF_K_N(inv, V4SF_LD(LUT + 16), V4SF_LD(LUT + 20), &r1, &r3, &r5, &r7);
+        LUT += 24;
+
+        if (scale) {
+            r0 = V4SF_MUL(r0, s);
+            r1 = V4SF_MUL(r1, s);
+            r2 = V4SF_MUL(r2, s);
+            r3 = V4SF_MUL(r3, s);
+            r4 = V4SF_MUL(r4, s);
+            r5 = V4SF_MUL(r5, s);
+            r6 = V4SF_MUL(r6, s);
+            r7 = V4SF_MUL(r7, s);
+        }
+
+        V4SF_ST(data0 + 4*i, r0);
+        V4SF_ST(data1 + 4*i, r1);
+        V4SF_ST(data2 + 4*i, r2);
+        V4SF_ST(data3 + 4*i, r3);
+        V4SF_ST(data4 + 4*i, r4);
+        V4SF_ST(data5 + 4*i, r5);
+        V4SF_ST(data6 + 4*i, r6);
+        V4SF_ST(data7 + 4*i, r7);
+    }
+}
+
+/* straight-line transforms of 32 up to 512 points, generated from the
+   leaves and passes above by generate_small_kernels.py */
+#include "ffts_small_kernels.h"
+
+/* the factor of ffts_set_scale for the last pass of a straight-line
+   transform, NULL if unscaled or run without a plan */
+#define FFTS_SMALL_SCALE(p) \
+    (((p) && ((p)->flags & FFTS_INTERNAL_SCALED)) ? &(p)->scale : NULL)
+
+#if !defined(HAVE_NEON) || !defined(DYNAMIC_DISABLED)
+/* butterflies of a pass with computed twiddle factors per block */
+#define FFTS_TWIDDLE_BLOCK 64
+
+/* exp(-2 * pi * i * k / p->N) for k0 and k1 as the products of a coarse
+   and a fine factor, rounded once to single precision */
+static FFTS_INLINE void
+ffts_static_twiddles_32f(const ffts_plan_t *p, size_t k0, size_t k1, float *w)
+{
+    const size_t mask = ((size_t) 1 << p->tw_fine_log2) - 1;
+    const double *c0 = p->tw_coarse[k0 >> p->tw_fine_log2];
+    const double *c1 = p->tw_coarse[k1 >> p->tw_fine_log2];
+    const double *f0 = p->tw_fine[k0 & mask];
+    const double *f1 = p->tw_fine[k1 & mask];
+
+#ifdef HAVE_SSE2
+    __m128d c, f, t0, t1;
+
+    c = _mm_load_pd(c0);
+    f = _mm_load_pd(f0);
+    t0 = _mm_mul_pd(_mm_unpacklo_pd(c, c), f);
+    t1 = _mm_mul_pd(_mm_unpackhi_pd(c, c), _mm_shuffle_pd(f, f, 1));
+    t0 = _mm_add_pd(t0, _mm_xor_pd(t1, _mm_set_pd(0.0, -0.0)));
+
+    c = _mm_load_pd(c1);
+    f = _mm_load_pd(f1);
+    t1 = _mm_mul_pd(_mm_unpacklo_pd(c, c), f);
+    f = _mm_mul_pd(_mm_unpackhi_pd(c, c), _mm_shuffle_pd(f, f, 1));
+    t1 = _mm_add_pd(t1, _mm_xor_pd(f, _mm_set_pd(0.0, -0.0)));
+
+    _mm_store_ps(w, _mm_movelh_ps(_mm_cvtpd_ps(t0), _mm_cvtpd_ps(t1)));
+#else
+    w[0] = (float) (c0[0] * f0[0] - c0[1] * f0[1]);
+    w[1] = (float) (c0[0] * f0[1] + c0[1] * f0[0]);
+    w[2] = (float) (c1[0] * f1[0] - c1[1] * f1[1]);
+    w[3] = (float) (c1[0] * f1[1] + c1[1] * f1[0]);
+#endif
+}
+
+/* same as V4SF_X_8 but the twiddle factors of each block are computed
+   into a small table in the layout of ffts_generate_luts, for the
+   butterflies begin to end of the pass */
+static void
+ffts_static_x8_computed_32f(const ffts_plan_t *p,
+                            int inv,
+                            int stream,
+                            const float *FFTS_RESTRICT scale,
+                            float *FFTS_RESTRICT data,
+                            size_t N,
+                            size_t begin,
+                            size_t end)
+{
+    float FFTS_ALIGN(16) LUT[12 * FFTS_TWIDDLE_BLOCK];
+    const size_t stride = p->N / N;
+    size_t i, j, count;
+
+    for (i = begin; i < end; i += count) {
+        count = end - i;
+        if (count > FFTS_TWIDDLE_BLOCK) {
+            count = FFTS_TWIDDLE_BLOCK;
+        }
+
+        for (j = 0; j < count; j++) {
+            const size_t k = 2 * (i + j);
+
+            ffts_static_twiddles_32f(p, stride * (2*k), stride * (2*k + 2),
+                LUT + 12*j + 0);
+            ffts_static_twiddles_32f(p, stride * k, stride * (k + 1),
+                LUT + 12*j + 4);
+            ffts_static_twiddles_32f(p, stride * (k + N/8), stride * (k + 1 + N/8),
+                LUT + 12*j + 8);
+        }
+
+        V4SF_X_8_PASS(inv, stream, scale, data + 4*i, N, count, LUT);
+    }
+}
+
+/* butterflies begin to end of the last pass of a sub-transform of size
+   N, the twiddle factors are read from the table when it holds them */
+static FFTS_INLINE void
+ffts_static_x8_range_32f(const ffts_plan_t *p,
+                         int inv,
+                         int stream,
+                         const float *FFTS_RESTRICT scale,
+                         float *FFTS_RESTRICT data,
+                         size_t N,
+                         size_t begin,
+                         size_t end)
+{
+    const float *ws = (const float*) p->ws;
+
+    if ((p->flags & FFTS_INTERNAL_COMPUTED_TWIDDLES) && N > FFTS_TWIDDLE_TABLE_MAX_N) {
+        ffts_static_x8_computed_32f(p, inv, stream, scale, data, N, begin, end);
+    } else {
+        V4SF_X_8_PASS(inv, stream, scale, data + 4*begin, N, end - begin,
+            ws + (p->ws_is[ffts_ctzl(N) - 4] << 1) + 12*begin);
+    }
+}
+
+/* last pass of a sub-transform of size N */
+static FFTS_INLINE void
+ffts_static_x8_32f(const ffts_plan_t *p,
+                   int inv,
+                   int stream,
+                   const float *FFTS_RESTRICT scale,
+                   float *FFTS_RESTRICT data,
+                   size_t N)
+{
+    ffts_static_x8_range_32f(p, inv, stream, scale, data, N, 0, N/16);
+}
+#endif
+
+/* prefetch the eight leaf input streams once per cache line */
+static FFTS_INLINE void
+ffts_static_prefetch_leaf(const float *FFTS_RESTRICT in,
+                          const int32_t *FFTS_RESTRICT is,
+                          size_t distance)
+{
+    if (distance && !((uintptr_t) in & 63)) {
+        const float *ahead = in + distance / sizeof(*in);
+
+        FFTS_PREFETCH(ahead + is[0]);
+        FFTS_PREFETCH(ahead + is[1]);
+        FFTS_PREFETCH(ahead + is[2]);
+        FFTS_PREFETCH(ahead + is[3]);
+        FFTS_PREFETCH(ahead + is[4]);
+        FFTS_PREFETCH(ahead + is[5]);
+        FFTS_PREFETCH(ahead + is[6]);
+        FFTS_PREFETCH(ahead + is[7]);
+    }
+}
+
 static FFTS_INLINE void
 ffts_static_firstpass_odd_32f(float *const FFTS_RESTRICT out,
                               const float *FFTS_RESTRICT in,
@@ -543,16 +832,19 @@ ffts_static_firstpass_odd_32f(float *const FFTS_RESTRICT out,
                               int inv)
 {
     size_t i, i0 = p->i0, i1 = p->i1;
-    const ptrdiff_t *is = (const ptrdiff_t*) p->is;
-    const ptrdiff_t *os = (const ptrdiff_t*) p->offsets;
+    const int32_t *is = p->is;
+    const int32_t *os = p->offsets;
+    size_t pf = p->prefetch_distance;
 
     for (i = i0; i > 0; --i) {
+        ffts_static_prefetch_leaf(in, is, pf);
         V4SF_LEAF_EE(out, os, in, is, inv);
         in += 4;
         os += 2;
     }
 
     for (i = i1; i > 0; --i) {
+        ffts_static_prefetch_leaf(in, is, pf);
         V4SF_LEAF_OO(out, os, in, is, inv);
         in += 4;
         os += 2;
@@ -563,13 +855,14 @@ ffts_static_firstpass_odd_32f(float *const FFTS_RESTRICT out,
     os += 2;
 
     for (i = i1; i > 0; --i) {
+        ffts_static_prefetch_leaf(in, is, pf);
         V4SF_LEAF_EE2(out, os, in, is, inv);
         in += 4;
         os += 2;
     }
 }
 
-void
+FFTS_API void
 ffts_small_2_32f(ffts_plan_t *p, const void *in, void *out)
 {
     const float *din = (const float*) in;
@@ -621,7 +914,7 @@ ffts_small_2_64f(ffts_plan_t *p, const void *in, void *out)
     dout[3] = r1[1];
 }
 
-void
+FFTS_API void
 ffts_small_forward4_32f(ffts_plan_t *p, const void *in, void *out)
 {
     const float *din = (const float*) in;
@@ -697,7 +990,7 @@ ffts_small_forward4_64f(ffts_plan_t *p, const void *in, void *out)
     dout[7] = t5[1] + t7[0];
 }
 
-void
+FFTS_API void
 ffts_small_backward4_32f(ffts_plan_t *p, const void *in, void *out)
 {
     const float *din = (const float*) in;
@@ -773,7 +1066,7 @@ ffts_small_backward4_64f(ffts_plan_t *p, const void *in, void *out)
     dout[7] = t5[1] - t7[0];
 }
 
-void
+FFTS_API void
 ffts_small_forward8_32f(ffts_plan_t *p, const void *in, void *out)
 {
     const float *FFTS_RESTRICT lut = ffts_constants_small_32f;
@@ -807,7 +1100,7 @@ ffts_small_forward8_64f(ffts_plan_t *p, const void *in, void *out)
 #endif
 }
 
-void
+FFTS_API void
 ffts_small_backward8_32f(ffts_plan_t *p, const void *in, void *out)
 {
     const float *FFTS_RESTRICT lut = ffts_constants_small_inv_32f;
@@ -842,7 +1135,7 @@ ffts_small_backward8_64f(ffts_plan_t *p, const void *in, void *out)
 #endif
 }
 
-void
+FFTS_API void
 ffts_small_forward16_32f(ffts_plan_t *p, const void *in, void *out)
 {
     const float *FFTS_RESTRICT lut = ffts_constants_small_32f;
@@ -884,7 +1177,7 @@ ffts_small_forward16_64f(ffts_plan_t *p, const void *in, void *out)
 #endif
 }
 
-void
+FFTS_API void
 ffts_small_backward16_32f(ffts_plan_t *p, const void *in, void *out)
 {
     const float *FFTS_RESTRICT lut = ffts_constants_small_inv_32f;
@@ -926,6 +1219,76 @@ ffts_small_backward16_64f(ffts_plan_t *p, const void *in, void *out)
 #endif
 }
 
+FFTS_API void
+ffts_small_forward32_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform32_32f((const float*) in, (float*) out, 0,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_backward32_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform32_32f((const float*) in, (float*) out, 1,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_forward64_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform64_32f((const float*) in, (float*) out, 0,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_backward64_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform64_32f((const float*) in, (float*) out, 1,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_forward128_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform128_32f((const float*) in, (float*) out, 0,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_backward128_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform128_32f((const float*) in, (float*) out, 1,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_forward256_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform256_32f((const float*) in, (float*) out, 0,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_backward256_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform256_32f((const float*) in, (float*) out, 1,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_forward512_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform512_32f((const float*) in, (float*) out, 0,
+        FFTS_SMALL_SCALE(p));
+}
+
+FFTS_API void
+ffts_small_backward512_32f(ffts_plan_t *p, const void *in, void *out)
+{
+    ffts_small_transform512_32f((const float*) in, (float*) out, 1,
+        FFTS_SMALL_SCALE(p));
+}
+
 static FFTS_INLINE void
 ffts_static_firstpass_even_32f(float *FFTS_RESTRICT out,
                                const float *FFTS_RESTRICT in,
@@ -933,10 +1296,12 @@ ffts_static_firstpass_even_32f(float *FFTS_RESTRICT out,
                                int inv)
 {
     size_t i, i0 = p->i0, i1 = p->i1;
-    const ptrdiff_t *is = (const ptrdiff_t*) p->is;
-    const ptrdiff_t *os = (const ptrdiff_t*) p->offsets;
+    const int32_t *is = p->is;
+    const int32_t *os = p->offsets;
+    size_t pf = p->prefetch_distance;
 
     for(i = i0; i > 0; --i) {
+        ffts_static_prefetch_leaf(in, is, pf);
         V4SF_LEAF_EE(out, os, in, is, inv);
         in += 4;
         os += 2;
@@ -947,12 +1312,14 @@ ffts_static_firstpass_even_32f(float *FFTS_RESTRICT out,
     os += 2;
 
     for (i = i1; i > 0; --i) {
+        ffts_static_prefetch_leaf(in, is, pf);
         V4SF_LEAF_OO(out, os, in, is, inv);
         in += 4;
         os += 2;
     }
 
     for (i = i1; i > 0; --i) {
+        ffts_static_prefetch_leaf(in, is, pf);
         V4SF_LEAF_EE2(out, os, in, is, inv);
         in += 4;
         os += 2;
@@ -1011,7 +1378,7 @@ ffts_static_rec_f_32f(const ffts_plan_t *p, float *data, size_t N)
         ffts_static_rec_f_32f(p, data + N          , N2);
         ffts_static_rec_f_32f(p, data + N + N1     , N2);
 
-        V4SF_X_8(0, data, N, ws + (p->ws_is[ffts_ctzl(N) - 4] << 1));
+        ffts_static_x8_32f(p, 0, 0, NULL, data, N);
     } else if (N == 128) {
         const float *ws1 = ws + (p->ws_is[1] << 1);
 
@@ -1087,7 +1454,7 @@ ffts_static_rec_i_32f(const ffts_plan_t *p, float *data, size_t N)
         ffts_static_rec_i_32f(p, data + N          , N2);
         ffts_static_rec_i_32f(p, data + N + N1     , N2);
 
-        V4SF_X_8(1, data, N, ws + (p->ws_is[ffts_ctzl(N) - 4] << 1));
+        ffts_static_x8_32f(p, 1, 0, NULL, data, N);
     } else if (N == 128) {
         const float *ws1 = ws + (p->ws_is[1] << 1);
 
@@ -1111,6 +1478,755 @@ ffts_static_rec_i_32f(const ffts_plan_t *p, float *data, size_t N)
 #endif
 }
 
+#if !defined(HAVE_NEON) || !defined(DYNAMIC_DISABLED)
+/* the factor of ffts_set_scale for the last pass, NULL if unscaled */
+#define FFTS_STATIC_SCALE(p) \
+    (((p)->flags & FFTS_INTERNAL_SCALED) ? &(p)->scale : NULL)
+
+/* top level of a transform, the last pass applies the scale and, for a
+   transform much larger than the cache, writes the output with
+   non-temporal stores so it doesn't evict the data still to be read */
+static void
+ffts_static_rec_top_32f(const ffts_plan_t *p, float *data, size_t N, int inv)
+{
+    const size_t N1 = N >> 1;
+    const size_t N2 = N >> 2;
+    const size_t N3 = N >> 3;
+
+    assert(N > 128);
+
+    if (inv) {
+        ffts_static_rec_i_32f(p, data              , N2);
+        ffts_static_rec_i_32f(p, data +     N1     , N3);
+        ffts_static_rec_i_32f(p, data +     N1 + N2, N3);
+        ffts_static_rec_i_32f(p, data + N          , N2);
+        ffts_static_rec_i_32f(p, data + N + N1     , N2);
+    } else {
+        ffts_static_rec_f_32f(p, data              , N2);
+        ffts_static_rec_f_32f(p, data +     N1     , N3);
+        ffts_static_rec_f_32f(p, data +     N1 + N2, N3);
+        ffts_static_rec_f_32f(p, data + N          , N2);
+        ffts_static_rec_f_32f(p, data + N + N1     , N2);
+    }
+
+    if (p->flags & FFTS_INTERNAL_STREAM) {
+        ffts_static_x8_32f(p, inv, 1, FFTS_STATIC_SCALE(p), data, N);
+        V4SF_FENCE();
+    } else {
+        ffts_static_x8_32f(p, inv, 0, FFTS_STATIC_SCALE(p), data, N);
+    }
+}
+#endif
+
+#if !defined(HAVE_NEON) || !defined(DYNAMIC_DISABLED)
+/* leaf steps per block of input staged by the load callback */
+#define FFTS_STATIC_LOAD_BLOCK 32
+
+/* butterflies per block of the last pass given to the store callback */
+#define FFTS_STATIC_STORE_BLOCK 32
+
+/* leaves begin to end of one kind */
+#define FFTS_STATIC_LEAF_RUN(LEAF, first, last) \
+    for (; i < end && i < (last); i++) { \
+        ffts_static_prefetch_leaf(in, is, pf); \
+        LEAF(out, os, in, is, inv); \
+        in += 4; \
+        os += 2; \
+    }
+
+/* leaves begin to end in the order of ffts_static_firstpass_odd_32f
+   and ffts_static_firstpass_even_32f, the leaf i reads its input at
+   in + 4*(i - begin) + is[0..7] */
+static FFTS_ALWAYS_INLINE void
+ffts_static_leaves_32f(const ffts_plan_t *p,
+                       float *const FFTS_RESTRICT out,
+                       const float *FFTS_RESTRICT in,
+                       const int32_t *FFTS_RESTRICT is,
+                       size_t begin,
+                       size_t end,
+                       size_t pf,
+                       int inv)
+{
+    const int32_t *os = p->offsets + 2*begin;
+    const size_t i0 = p->i0, i1 = p->i1;
+    size_t i = begin;
+
+    FFTS_STATIC_LEAF_RUN(V4SF_LEAF_EE, 0, i0);
+
+    if (ffts_ctzl(p->N) & 1) {
+        FFTS_STATIC_LEAF_RUN(V4SF_LEAF_OO, i0, i0 + i1);
+        FFTS_STATIC_LEAF_RUN(V4SF_LEAF_OE, i0 + i1, i0 + i1 + 1);
+    } else {
+        FFTS_STATIC_LEAF_RUN(V4SF_LEAF_EO, i0, i0 + 1);
+        FFTS_STATIC_LEAF_RUN(V4SF_LEAF_OO, i0 + 1, i0 + i1 + 1);
+    }
+
+    FFTS_STATIC_LEAF_RUN(V4SF_LEAF_EE2, i0 + i1 + 1, end);
+}
+
+#undef FFTS_STATIC_LEAF_RUN
+
+/* leaves begin to end with the input of each block of leaf steps
+   written by the load callback, one run of elements per stream */
+static void
+ffts_static_leaves_load_32f(const ffts_plan_t *p,
+                            float *const FFTS_RESTRICT out,
+                            const void *in,
+                            size_t begin,
+                            size_t end,
+                            int inv)
+{
+    float FFTS_ALIGN(16) stage[8 * 4 * FFTS_STATIC_LOAD_BLOCK];
+    int32_t is[8];
+    size_t i, j, count;
+
+    for (j = 0; j < 8; j++) {
+        is[j] = (int32_t) (j * 4 * FFTS_STATIC_LOAD_BLOCK);
+    }
+
+    for (i = begin; i < end; i += count) {
+        count = end - i;
+        if (count > FFTS_STATIC_LOAD_BLOCK) {
+            count = FFTS_STATIC_LOAD_BLOCK;
+        }
+
+        for (j = 0; j < 8; j++) {
+            p->load(stage + is[j], in, p->is[j]/2 + 2*i, 2*count, p->userdata);
+        }
+
+        if (inv) {
+            ffts_static_leaves_32f(p, out, stage, is, i, i + count, 0, 1);
+        } else {
+            ffts_static_leaves_32f(p, out, stage, is, i, i + count, 0, 0);
+        }
+    }
+}
+
+/* the output is scaled or given to the store callback once final */
+#define FFTS_STATIC_STORES(p) \
+    ((p)->store || ((p)->flags & FFTS_INTERNAL_SCALED))
+
+/* gives the output of butterflies begin to end of the last pass to the
+   store callback, one run of elements per butterfly input */
+static void
+ffts_static_store_32f(const ffts_plan_t *p, float *out, size_t begin, size_t end)
+{
+    const size_t N = p->N;
+    size_t j;
+
+    for (j = 0; j < 8; j++) {
+        size_t index = j * N/8 + 2*begin;
+
+        p->store(out + 2*index, index, 2*(end - begin), p->userdata);
+    }
+}
+
+/* scales the output of a transform too small to be split in blocks and
+   gives it to the store callback */
+static void
+ffts_static_store_all_32f(const ffts_plan_t *p, float *out, size_t N)
+{
+    size_t i;
+
+    if (p->flags & FFTS_INTERNAL_SCALED) {
+        const V4SF s = V4SF_LIT4(p->scale, p->scale, p->scale, p->scale);
+
+        for (i = 0; i < 2*N; i += 4) {
+            V4SF_ST(out + i, V4SF_MUL(V4SF_LD(out + i), s));
+        }
+    }
+
+    if (p->store) {
+        p->store(out, 0, N, p->userdata);
+    }
+}
+
+/* the transform with the load callback in place of the first pass input,
+   the scale applied by the last pass and the store callback after each
+   of its blocks */
+static void
+ffts_static_transform_callbacks_32f(const ffts_plan_t *p,
+                                    const void *in,
+                                    float *out,
+                                    int inv)
+{
+    const size_t N = p->N;
+    size_t i, count;
+
+    if (p->load) {
+        ffts_static_leaves_load_32f(p, out, in, 0, N/16, inv);
+    } else if (ffts_ctzl(N) & 1) {
+        ffts_static_firstpass_odd_32f(out, (const float*) in, p, inv);
+    } else {
+        ffts_static_firstpass_even_32f(out, (const float*) in, p, inv);
+    }
+
+    if (N > 128 && !p->store) {
+        ffts_static_rec_top_32f(p, out, N, inv);
+    } else if (N > 128) {
+        /* the output stays in cache for the callback, it is not streamed */
+        const size_t N1 = N >> 1;
+        const size_t N2 = N >> 2;
+        const size_t N3 = N >> 3;
+
+        if (inv) {
+            ffts_static_rec_i_32f(p, out              , N2);
+            ffts_static_rec_i_32f(p, out +     N1     , N3);
+            ffts_static_rec_i_32f(p, out +     N1 + N2, N3);
+            ffts_static_rec_i_32f(p, out + N          , N2);
+            ffts_static_rec_i_32f(p, out + N + N1     , N2);
+        } else {
+            ffts_static_rec_f_32f(p, out              , N2);
+            ffts_static_rec_f_32f(p, out +     N1     , N3);
+            ffts_static_rec_f_32f(p, out +     N1 + N2, N3);
+            ffts_static_rec_f_32f(p, out + N          , N2);
+            ffts_static_rec_f_32f(p, out + N + N1     , N2);
+        }
+
+        for (i = 0; i < N/16; i += count) {
+            count = N/16 - i;
+            if (count > FFTS_STATIC_STORE_BLOCK) {
+                count = FFTS_STATIC_STORE_BLOCK;
+            }
+
+            ffts_static_x8_range_32f(p, inv, 0, FFTS_STATIC_SCALE(p), out, N,
+                i, i + count);
+            ffts_static_store_32f(p, out, i, i + count);
+        }
+    } else {
+        if (inv) {
+            ffts_static_rec_i_32f(p, out, N);
+        } else {
+            ffts_static_rec_f_32f(p, out, N);
+        }
+
+        ffts_static_store_all_32f(p, out, N);
+    }
+}
+#endif
+
+#ifdef FFTS_STATIC_TASKS
+/* The parallel static engine runs the leaves in ranges of FFTS_PARALLEL_CHUNK,
+   then the recursion of ffts_static_rec_f_32f as a tree of tasks. A node
+   larger than FFTS_PARALLEL_GRAIN_N spawns its five sub-transforms, the
+   last of them to finish spawns the butterflies of its pass in ranges,
+   and the last of those completes the node. Smaller sub-transforms run
+   their passes from a precomputed schedule. Each participant pushes and
+   pops the tasks it spawns at the bottom of its own deque, and steals
+   from the top of the others when it runs out. */
+typedef enum _ffts_static_task_kind_t {
+    FFTS_TASK_LEAVES,
+    FFTS_TASK_SPLIT,
+    FFTS_TASK_SUBTREE,
+    FFTS_TASK_PASS
+} ffts_static_task_kind_t;
+
+typedef struct _ffts_static_task_t ffts_static_task_t;
+
+struct _ffts_static_task_t {
+    ffts_static_task_kind_t kind;
+
+    /* sub-transform (in floats of the output) or range of the task */
+    size_t offset;
+    size_t N;
+    size_t begin;
+    size_t end;
+
+    /* completed by this task, NULL for the root */
+    ffts_static_task_t *parent;
+
+    /* spawned when the task runs, then when they have completed */
+    ffts_static_task_t *children;
+    size_t n_children;
+    ffts_static_task_t *passes;
+    size_t n_passes;
+
+    /* reset each time the task runs */
+    volatile long pending;
+    int in_passes;
+};
+
+/* X_4 of 16 or X_8 of N points at offset, in the order of the recursion */
+typedef struct _ffts_static_pass_t {
+    uint32_t offset;
+    uint32_t N;
+} ffts_static_pass_t;
+
+typedef struct _ffts_static_deque_t {
+    ffts_mutex_t mutex;
+    ffts_static_task_t **items;
+    size_t top;
+    size_t bottom;
+} ffts_static_deque_t;
+
+struct _ffts_static_tasks_t {
+    ffts_static_task_t *nodes;
+    size_t n_nodes;
+
+    /* the schedule of subtrees of 2^i points starts at schedule_first[i] */
+    ffts_static_pass_t *schedule;
+    size_t schedule_first[32];
+    size_t schedule_count[32];
+
+    ffts_static_deque_t *deques;
+    size_t n_threads;
+
+    /* the plan of a thread running it, the others execute sequentially */
+    void *volatile busy;
+};
+
+typedef struct _ffts_static_job_t {
+    ffts_pool_job_t job;
+
+    const ffts_plan_t *p;
+    struct _ffts_static_tasks_t *tasks;
+    const void *in;
+    float *out;
+    int inv;
+    int stream;
+    volatile long done;
+} ffts_static_job_t;
+
+/* the passes of ffts_static_rec_f_32f of a sub-transform, counted only
+   when schedule is NULL */
+static size_t
+ffts_static_schedule(ffts_static_pass_t *schedule, size_t offset, size_t N)
+{
+    size_t n = 0;
+
+    if (N > 128) {
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset, N/4);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + N/2, N/8);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + N/2 + N/4, N/8);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + N, N/4);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + N + N/2, N/4);
+    } else if (N == 128) {
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset, 32);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + 64, 16);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + 96, 16);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + 128, 32);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + 192, 32);
+    } else if (N == 64) {
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset, 16);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + 64, 16);
+        n += ffts_static_schedule(schedule ? schedule + n : NULL, offset + 96, 16);
+    }
+
+    if (schedule) {
+        schedule[n].offset = (uint32_t) offset;
+        schedule[n].N = (uint32_t) N;
+    }
+
+    return n + 1;
+}
+
+/* tasks of the sub-transform of N points at offset, counted only when
+   nodes is NULL, returns the number of nodes used */
+static size_t
+ffts_static_tasks_build(ffts_static_task_t *nodes,
+                        ffts_static_task_t *node,
+                        ffts_static_task_t *parent,
+                        size_t offset,
+                        size_t N)
+{
+    const size_t sizes[5] = { N/4, N/8, N/8, N/4, N/4 };
+    const size_t offsets[5] = { 0, N/2, N/2 + N/4, N, N + N/2 };
+    size_t i, n_passes, used;
+
+    if (N <= FFTS_PARALLEL_GRAIN_N) {
+        if (nodes) {
+            node->kind = FFTS_TASK_SUBTREE;
+            node->offset = offset;
+            node->N = N;
+            node->parent = parent;
+        }
+
+        return 0;
+    }
+
+    n_passes = (N/16 + FFTS_PARALLEL_CHUNK - 1) / FFTS_PARALLEL_CHUNK;
+    used = 5 + n_passes;
+
+    if (nodes) {
+        node->kind = FFTS_TASK_SPLIT;
+        node->offset = offset;
+        node->N = N;
+        node->parent = parent;
+        node->children = nodes;
+        node->n_children = 5;
+        node->passes = nodes + 5;
+        node->n_passes = n_passes;
+
+        for (i = 0; i < n_passes; i++) {
+            ffts_static_task_t *pass = node->passes + i;
+
+            pass->kind = FFTS_TASK_PASS;
+            pass->offset = offset;
+            pass->N = N;
+            pass->begin = i * FFTS_PARALLEL_CHUNK;
+            pass->end = (i + 1 < n_passes) ? (i + 1) * FFTS_PARALLEL_CHUNK : N/16;
+            pass->parent = node;
+        }
+    }
+
+    for (i = 0; i < 5; i++) {
+        used += ffts_static_tasks_build(nodes ? nodes + used : NULL,
+            nodes ? node->children + i : NULL, node, offset + offsets[i], sizes[i]);
+    }
+
+    return used;
+}
+
+struct _ffts_static_tasks_t*
+ffts_static_tasks_init(const ffts_plan_t *p, size_t n_threads)
+{
+    struct _ffts_static_tasks_t *tasks;
+    ffts_static_task_t *start, *root;
+    size_t i, n_leaves, n_ranges, n_schedule;
+
+    if (n_threads > FFTS_PARALLEL_MAX_THREADS) {
+        n_threads = FFTS_PARALLEL_MAX_THREADS;
+    }
+
+    tasks = (struct _ffts_static_tasks_t*) calloc(1, sizeof(*tasks));
+    if (!tasks) {
+        return NULL;
+    }
+
+    /* the start node spawns the leaves, then the root of the recursion */
+    n_leaves = p->N / 16;
+    n_ranges = (n_leaves + FFTS_PARALLEL_CHUNK - 1) / FFTS_PARALLEL_CHUNK;
+    tasks->n_nodes = 2 + n_ranges + ffts_static_tasks_build(NULL, NULL, NULL, 0, p->N);
+
+    tasks->nodes = (ffts_static_task_t*) calloc(tasks->n_nodes, sizeof(*tasks->nodes));
+    if (!tasks->nodes) {
+        goto cleanup;
+    }
+
+    start = tasks->nodes;
+    root = tasks->nodes + 1;
+
+    start->kind = FFTS_TASK_SPLIT;
+    start->children = tasks->nodes + 2;
+    start->n_children = n_ranges;
+    start->passes = root;
+    start->n_passes = 1;
+
+    for (i = 0; i < n_ranges; i++) {
+        ffts_static_task_t *range = start->children + i;
+
+        range->kind = FFTS_TASK_LEAVES;
+        range->begin = i * FFTS_PARALLEL_CHUNK;
+        range->end = (i + 1 < n_ranges) ? (i + 1) * FFTS_PARALLEL_CHUNK : n_leaves;
+        range->parent = start;
+    }
+
+    ffts_static_tasks_build(tasks->nodes + 2 + n_ranges, root, start, 0, p->N);
+
+    /* one schedule per size of the subtrees */
+    n_schedule = 0;
+    for (i = 0; i < tasks->n_nodes; i++) {
+        ffts_static_task_t *node = tasks->nodes + i;
+        size_t log_N;
+
+        if (node->kind != FFTS_TASK_SUBTREE) {
+            continue;
+        }
+
+        log_N = ffts_ctzl(node->N);
+        if (!tasks->schedule_count[log_N]) {
+            tasks->schedule_count[log_N] = ffts_static_schedule(NULL, 0, node->N);
+            n_schedule += tasks->schedule_count[log_N];
+        }
+    }
+
+    tasks->schedule = (ffts_static_pass_t*) malloc(n_schedule * sizeof(*tasks->schedule));
+    if (!tasks->schedule) {
+        goto cleanup;
+    }
+
+    n_schedule = 0;
+    for (i = 0; i < 32; i++) {
+        if (tasks->schedule_count[i]) {
+            tasks->schedule_first[i] = n_schedule;
+            n_schedule += ffts_static_schedule(tasks->schedule + n_schedule, 0,
+                (size_t) 1 << i);
+        }
+    }
+
+    tasks->deques = (ffts_static_deque_t*) calloc(n_threads, sizeof(*tasks->deques));
+    if (!tasks->deques) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < n_threads; i++) {
+        tasks->deques[i].items = (ffts_static_task_t**) malloc(
+            tasks->n_nodes * sizeof(*tasks->deques[i].items));
+        if (!tasks->deques[i].items || ffts_mutex_init(&tasks->deques[i].mutex)) {
+            if (tasks->deques[i].items) {
+                free(tasks->deques[i].items);
+            }
+
+            break;
+        }
+
+        tasks->n_threads++;
+    }
+
+    if (tasks->n_threads < n_threads) {
+        goto cleanup;
+    }
+
+    return tasks;
+
+cleanup:
+    ffts_static_tasks_free(tasks);
+    return NULL;
+}
+
+void
+ffts_static_tasks_free(struct _ffts_static_tasks_t *tasks)
+{
+    size_t i;
+
+    if (tasks->deques) {
+        for (i = 0; i < tasks->n_threads; i++) {
+            ffts_mutex_destroy(&tasks->deques[i].mutex);
+            free(tasks->deques[i].items);
+        }
+
+        free(tasks->deques);
+    }
+
+    if (tasks->schedule) {
+        free(tasks->schedule);
+    }
+
+    if (tasks->nodes) {
+        free(tasks->nodes);
+    }
+
+    free(tasks);
+}
+
+static void
+ffts_static_push(ffts_static_deque_t *deque, ffts_static_task_t *first, size_t count)
+{
+    size_t i;
+
+    ffts_mutex_lock(&deque->mutex);
+    for (i = 0; i < count; i++) {
+        deque->items[deque->bottom++] = first + i;
+    }
+    ffts_mutex_unlock(&deque->mutex);
+}
+
+static ffts_static_task_t*
+ffts_static_pop(ffts_static_deque_t *deque)
+{
+    ffts_static_task_t *task = NULL;
+
+    ffts_mutex_lock(&deque->mutex);
+    if (deque->bottom > deque->top) {
+        task = deque->items[--deque->bottom];
+    }
+    ffts_mutex_unlock(&deque->mutex);
+
+    return task;
+}
+
+static ffts_static_task_t*
+ffts_static_steal(ffts_static_deque_t *deque)
+{
+    ffts_static_task_t *task = NULL;
+
+    ffts_mutex_lock(&deque->mutex);
+    if (deque->bottom > deque->top) {
+        task = deque->items[deque->top++];
+
+        /* the deque is reused from the start once drained */
+        if (deque->top == deque->bottom) {
+            deque->top = deque->bottom = 0;
+        }
+    }
+    ffts_mutex_unlock(&deque->mutex);
+
+    return task;
+}
+
+static void
+ffts_static_subtree_32f(const ffts_plan_t *p,
+                        const struct _ffts_static_tasks_t *tasks,
+                        float *data,
+                        size_t N,
+                        int inv)
+{
+    const size_t log_N = ffts_ctzl(N);
+    const ffts_static_pass_t *pass = tasks->schedule + tasks->schedule_first[log_N];
+    const ffts_static_pass_t *last = pass + tasks->schedule_count[log_N];
+    const float *ws = (const float*) p->ws;
+
+    for (; pass < last; pass++) {
+        if (pass->N == 16) {
+            V4SF_X_4(inv, data + pass->offset, 16, ws);
+        } else {
+            ffts_static_x8_32f(p, inv, 0, NULL, data + pass->offset, pass->N);
+        }
+    }
+}
+
+static void
+ffts_static_complete(ffts_static_job_t *job,
+                     ffts_static_deque_t *deque,
+                     ffts_static_task_t *task);
+
+/* spawns the children of a split node, or its passes once they are done */
+static void
+ffts_static_advance(ffts_static_job_t *job,
+                    ffts_static_deque_t *deque,
+                    ffts_static_task_t *task)
+{
+    if (!task->in_passes) {
+        task->in_passes = 1;
+        task->pending = (long) task->n_passes;
+        ffts_static_push(deque, task->passes, task->n_passes);
+    } else if (task->parent) {
+        ffts_static_complete(job, deque, task->parent);
+    } else {
+        ffts_atomic_add(&job->done, 1);
+    }
+}
+
+static void
+ffts_static_complete(ffts_static_job_t *job,
+                     ffts_static_deque_t *deque,
+                     ffts_static_task_t *task)
+{
+    if (!ffts_atomic_add(&task->pending, -1)) {
+        ffts_static_advance(job, deque, task);
+    }
+}
+
+static void
+ffts_static_run_task(ffts_static_job_t *job,
+                     ffts_static_deque_t *deque,
+                     ffts_static_task_t *task)
+{
+    const ffts_plan_t *p = job->p;
+    float *data = job->out + task->offset;
+
+    switch (task->kind) {
+    case FFTS_TASK_LEAVES:
+        if (p->load) {
+            ffts_static_leaves_load_32f(p, job->out, job->in, task->begin,
+                task->end, job->inv);
+        } else if (job->inv) {
+            ffts_static_leaves_32f(p, job->out, (const float*) job->in + 4*task->begin,
+                p->is, task->begin, task->end, p->prefetch_distance, 1);
+        } else {
+            ffts_static_leaves_32f(p, job->out, (const float*) job->in + 4*task->begin,
+                p->is, task->begin, task->end, p->prefetch_distance, 0);
+        }
+        break;
+    case FFTS_TASK_SPLIT:
+        task->in_passes = 0;
+        task->pending = (long) task->n_children;
+        ffts_static_push(deque, task->children, task->n_children);
+        return;
+    case FFTS_TASK_SUBTREE:
+        ffts_static_subtree_32f(p, job->tasks, data, task->N, job->inv);
+
+        if (FFTS_STATIC_STORES(p) && !task->parent->parent) {
+            ffts_static_store_all_32f(p, data, task->N);
+        }
+        break;
+    case FFTS_TASK_PASS:
+        /* only the top level streams, scales or stores its output */
+        if (task->parent->parent->parent) {
+            ffts_static_x8_range_32f(p, job->inv, 0, NULL, data, task->N,
+                task->begin, task->end);
+        } else if (p->store) {
+            ffts_static_x8_range_32f(p, job->inv, 0, FFTS_STATIC_SCALE(p), data,
+                task->N, task->begin, task->end);
+            ffts_static_store_32f(p, data, task->begin, task->end);
+        } else if (job->stream) {
+            ffts_static_x8_range_32f(p, job->inv, 1, FFTS_STATIC_SCALE(p), data,
+                task->N, task->begin, task->end);
+            V4SF_FENCE();
+        } else {
+            ffts_static_x8_range_32f(p, job->inv, 0, FFTS_STATIC_SCALE(p), data,
+                task->N, task->begin, task->end);
+        }
+        break;
+    }
+
+    ffts_static_complete(job, deque, task->parent);
+}
+
+static void
+ffts_static_job_run(ffts_pool_job_t *pool_job, size_t participant)
+{
+    ffts_static_job_t *job = (ffts_static_job_t*) pool_job;
+    struct _ffts_static_tasks_t *tasks = job->tasks;
+    ffts_static_deque_t *deque = tasks->deques + participant;
+    size_t i;
+
+    if (!participant) {
+        ffts_static_run_task(job, deque, tasks->nodes);
+    }
+
+    /* read with a barrier, the output of the last task is then visible */
+    while (!ffts_atomic_add(&job->done, 0)) {
+        ffts_static_task_t *task = ffts_static_pop(deque);
+
+        for (i = 1; !task && i < tasks->n_threads; i++) {
+            task = ffts_static_steal(tasks->deques + (participant + i) % tasks->n_threads);
+        }
+
+        if (task) {
+            ffts_static_run_task(job, deque, task);
+        } else {
+            ffts_thread_yield();
+        }
+    }
+}
+
+/* returns non-zero if another thread is running the tasks of the plan */
+static int
+ffts_static_transform_tasks_32f(const ffts_plan_t *p,
+                                const void *in,
+                                float *out,
+                                int inv)
+{
+    struct _ffts_static_tasks_t *tasks = p->tasks;
+    ffts_static_job_t job;
+    size_t i;
+
+    if (!ffts_atomic_cas_ptr(&tasks->busy, NULL, tasks)) {
+        return -1;
+    }
+
+    for (i = 0; i < tasks->n_threads; i++) {
+        tasks->deques[i].top = tasks->deques[i].bottom = 0;
+    }
+
+    job.job.run = ffts_static_job_run;
+    job.job.n_participants = tasks->n_threads;
+    job.p = p;
+    job.tasks = tasks;
+    job.in = in;
+    job.out = out;
+    job.inv = inv;
+    job.stream = (p->flags & FFTS_INTERNAL_STREAM) != 0;
+    job.done = 0;
+
+    ffts_pool_run(&job.job);
+
+    ffts_atomic_cas_ptr(&tasks->busy, tasks, NULL);
+    return 0;
+}
+#endif
+
 void
 ffts_static_transform_f_32f(ffts_plan_t *p, const void *in, void *out)
 {
@@ -1162,13 +2278,28 @@ ffts_static_transform_f_32f(ffts_plan_t *p, const void *in, void *out)
         neon_static_x8_t_f(dout, 32, ws + 8);
     }
 #else
+#ifdef FFTS_STATIC_TASKS
+    if (p->tasks && !ffts_static_transform_tasks_32f(p, in, dout, 0)) {
+        return;
+    }
+#endif
+
+    if (p->load || FFTS_STATIC_STORES(p)) {
+        ffts_static_transform_callbacks_32f(p, in, dout, 0);
+        return;
+    }
+
     if (N_log_2 & 1) {
         ffts_static_firstpass_odd_32f(dout, din, p, 0);
     } else {
         ffts_static_firstpass_even_32f(dout, din, p, 0);
     }
 
-    ffts_static_rec_f_32f(p, dout, N);
+    if (N > 128 && (p->flags & FFTS_INTERNAL_STREAM)) {
+        ffts_static_rec_top_32f(p, dout, N, 0);
+    } else {
+        ffts_static_rec_f_32f(p, dout, N);
+    }
 #endif
 }
 
@@ -1223,12 +2354,27 @@ ffts_static_transform_i_32f(ffts_plan_t *p, const void *in, void *out)
         neon_static_x8_t_i(dout, 32, ws + 8);
     }
 #else
+#ifdef FFTS_STATIC_TASKS
+    if (p->tasks && !ffts_static_transform_tasks_32f(p, in, dout, 1)) {
+        return;
+    }
+#endif
+
+    if (p->load || FFTS_STATIC_STORES(p)) {
+        ffts_static_transform_callbacks_32f(p, in, dout, 1);
+        return;
+    }
+
     if (N_log_2 & 1) {
         ffts_static_firstpass_odd_32f(dout, din, p, 1);
     } else {
         ffts_static_firstpass_even_32f(dout, din, p, 1);
     }
 
-    ffts_static_rec_i_32f(p, dout, N);
+    if (N > 128 && (p->flags & FFTS_INTERNAL_STREAM)) {
+        ffts_static_rec_top_32f(p, dout, N, 1);
+    } else {
+        ffts_static_rec_i_32f(p, dout, N);
+    }
 #endif
 }
\ No newline at end of file
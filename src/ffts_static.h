@@ -39,52 +39,54 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include "ffts.h"
+#include "ffts_pool.h"
 
-void
-ffts_small_2_32f(ffts_plan_t *p, const void *in, void *out);
+/* sizes of the straight-line transforms of ffts_small_kernels.h, up to
+   FFTS_SMALL_MAX_N of ffts.h */
+#define FFTS_SMALL_MIN_N 32
 
 void
 ffts_small_2_64f(ffts_plan_t *p, const void *in, void *out);
 
-void
-ffts_small_forward4_32f(ffts_plan_t *p, const void *in, void *out);
-
 void
 ffts_small_forward4_64f(ffts_plan_t *p, const void *in, void *out);
 
-void
-ffts_small_backward4_32f(ffts_plan_t *p, const void *in, void *out);
-
 void
 ffts_small_backward4_64f(ffts_plan_t *p, const void *in, void *out);
 
-void
-ffts_small_forward8_32f(ffts_plan_t *p, const void *in, void *out);
-
 void
 ffts_small_forward8_64f(ffts_plan_t *p, const void *in, void *out);
 
-void
-ffts_small_backward8_32f(ffts_plan_t *p, const void *in, void *out);
-
 void
 ffts_small_backward8_64f(ffts_plan_t *p, const void *in, void *out);
 
-void
-ffts_small_forward16_32f(ffts_plan_t *p, const void *in, void *out);
-
 void
 ffts_small_forward16_64f(ffts_plan_t *p, const void *in, void *out);
 
-void
-ffts_small_backward16_32f(ffts_plan_t *p, const void *in, void *out);
-
 void
 ffts_small_backward16_64f(ffts_plan_t *p, const void *in, void *out);
 
 void
 ffts_static_transform_f_32f(ffts_plan_t *p, const void *in, void *out);
 
+/* the static engine of the vector macros runs the callbacks of
+   ffts_set_callbacks in its first and last passes */
+#if !defined(HAVE_NEON) || !defined(DYNAMIC_DISABLED)
+#define FFTS_STATIC_CALLBACKS
+#endif
+
+/* the static engine of the vector macros runs large transforms as tasks
+   on the threads of the pool */
+#if defined(FFTS_HAVE_POOL) && (!defined(HAVE_NEON) || !defined(DYNAMIC_DISABLED))
+#define FFTS_STATIC_TASKS
+
+struct _ffts_static_tasks_t*
+ffts_static_tasks_init(const ffts_plan_t *p, size_t n_threads);
+
+void
+ffts_static_tasks_free(struct _ffts_static_tasks_t *tasks);
+#endif
+
 void
 ffts_static_transform_i_32f(ffts_plan_t *p, const void *in, void *out);
 
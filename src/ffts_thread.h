@@ -0,0 +1,293 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef FFTS_THREAD_H
+#define FFTS_THREAD_H
+
+#if defined (_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "ffts_attributes.h"
+
+#include <stddef.h>
+
+/* Minimal thread, mutex and condition variable wrappers, FFTS_HAVE_THREADS
+   is defined when available */
+
+#if defined(_WIN32) || defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#define FFTS_HAVE_THREADS
+
+typedef HANDLE ffts_thread_t;
+
+#define FFTS_THREAD_FUNC(name, arg) DWORD WINAPI name(LPVOID arg)
+#define FFTS_THREAD_RETURN return 0
+
+static FFTS_INLINE int
+ffts_thread_create(ffts_thread_t *thread, LPTHREAD_START_ROUTINE func, void *arg)
+{
+    *thread = CreateThread(NULL, 0, func, arg, 0, NULL);
+    return (*thread == NULL) ? -1 : 0;
+}
+
+static FFTS_INLINE void
+ffts_thread_join(ffts_thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static FFTS_INLINE void
+ffts_thread_detach(ffts_thread_t thread)
+{
+    CloseHandle(thread);
+}
+
+static FFTS_INLINE void
+ffts_thread_yield(void)
+{
+    SwitchToThread();
+}
+
+typedef CRITICAL_SECTION ffts_mutex_t;
+typedef CONDITION_VARIABLE ffts_cond_t;
+
+static FFTS_INLINE int
+ffts_mutex_init(ffts_mutex_t *mutex)
+{
+    InitializeCriticalSection(mutex);
+    return 0;
+}
+
+static FFTS_INLINE void
+ffts_mutex_destroy(ffts_mutex_t *mutex)
+{
+    DeleteCriticalSection(mutex);
+}
+
+static FFTS_INLINE void
+ffts_mutex_lock(ffts_mutex_t *mutex)
+{
+    EnterCriticalSection(mutex);
+}
+
+static FFTS_INLINE void
+ffts_mutex_unlock(ffts_mutex_t *mutex)
+{
+    LeaveCriticalSection(mutex);
+}
+
+static FFTS_INLINE int
+ffts_cond_init(ffts_cond_t *cond)
+{
+    InitializeConditionVariable(cond);
+    return 0;
+}
+
+static FFTS_INLINE void
+ffts_cond_wait(ffts_cond_t *cond, ffts_mutex_t *mutex)
+{
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+}
+
+static FFTS_INLINE void
+ffts_cond_broadcast(ffts_cond_t *cond)
+{
+    WakeAllConditionVariable(cond);
+}
+#elif defined(HAVE_PTHREAD)
+#include <pthread.h>
+#include <sched.h>
+
+#define FFTS_HAVE_THREADS
+
+typedef pthread_t ffts_thread_t;
+
+#define FFTS_THREAD_FUNC(name, arg) void* name(void *arg)
+#define FFTS_THREAD_RETURN return NULL
+
+static FFTS_INLINE int
+ffts_thread_create(ffts_thread_t *thread, void* (*func)(void*), void *arg)
+{
+    return pthread_create(thread, NULL, func, arg) ? -1 : 0;
+}
+
+static FFTS_INLINE void
+ffts_thread_join(ffts_thread_t thread)
+{
+    pthread_join(thread, NULL);
+}
+
+static FFTS_INLINE void
+ffts_thread_detach(ffts_thread_t thread)
+{
+    pthread_detach(thread);
+}
+
+static FFTS_INLINE void
+ffts_thread_yield(void)
+{
+    sched_yield();
+}
+
+typedef pthread_mutex_t ffts_mutex_t;
+typedef pthread_cond_t ffts_cond_t;
+
+static FFTS_INLINE int
+ffts_mutex_init(ffts_mutex_t *mutex)
+{
+    return pthread_mutex_init(mutex, NULL) ? -1 : 0;
+}
+
+static FFTS_INLINE void
+ffts_mutex_destroy(ffts_mutex_t *mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+static FFTS_INLINE void
+ffts_mutex_lock(ffts_mutex_t *mutex)
+{
+    pthread_mutex_lock(mutex);
+}
+
+static FFTS_INLINE void
+ffts_mutex_unlock(ffts_mutex_t *mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+
+static FFTS_INLINE int
+ffts_cond_init(ffts_cond_t *cond)
+{
+    return pthread_cond_init(cond, NULL) ? -1 : 0;
+}
+
+static FFTS_INLINE void
+ffts_cond_wait(ffts_cond_t *cond, ffts_mutex_t *mutex)
+{
+    pthread_cond_wait(cond, mutex);
+}
+
+static FFTS_INLINE void
+ffts_cond_broadcast(ffts_cond_t *cond)
+{
+    pthread_cond_broadcast(cond);
+}
+#endif
+
+/* smallest range given to a thread by ffts_parallel_for */
+#ifndef FFTS_PARALLEL_MIN_RANGE
+#define FFTS_PARALLEL_MIN_RANGE 4096
+#endif
+
+#ifndef FFTS_PARALLEL_MAX_THREADS
+#define FFTS_PARALLEL_MAX_THREADS 64
+#endif
+
+typedef void (*ffts_range_func_t)(void *arg, size_t begin, size_t end);
+
+#ifdef FFTS_HAVE_THREADS
+typedef struct _ffts_range_job_t {
+    ffts_range_func_t func;
+    void *arg;
+    size_t begin;
+    size_t end;
+} ffts_range_job_t;
+
+static FFTS_INLINE FFTS_THREAD_FUNC(ffts_range_job_run, arg)
+{
+    ffts_range_job_t *job = (ffts_range_job_t*) arg;
+    job->func(job->arg, job->begin, job->end);
+    FFTS_THREAD_RETURN;
+}
+#endif
+
+/* Splits [0, n) into up to n_threads ranges and calls func on each of
+   them, the first one on the calling thread, and waits for all. The ranges
+   of threads that fail to start are run by the caller. */
+static FFTS_INLINE void
+ffts_parallel_for(size_t n, size_t n_threads, ffts_range_func_t func, void *arg)
+{
+#ifdef FFTS_HAVE_THREADS
+    ffts_thread_t threads[FFTS_PARALLEL_MAX_THREADS];
+    ffts_range_job_t jobs[FFTS_PARALLEL_MAX_THREADS];
+    size_t i, size, started, end;
+
+    if (n_threads > n / FFTS_PARALLEL_MIN_RANGE) {
+        n_threads = n / FFTS_PARALLEL_MIN_RANGE;
+    }
+
+    if (n_threads > FFTS_PARALLEL_MAX_THREADS) {
+        n_threads = FFTS_PARALLEL_MAX_THREADS;
+    }
+
+    if (n_threads <= 1) {
+        func(arg, 0, n);
+        return;
+    }
+
+    size = n / n_threads;
+    end = n;
+
+    for (started = 1; started < n_threads; started++) {
+        jobs[started].func = func;
+        jobs[started].arg = arg;
+        jobs[started].begin = started * size;
+        jobs[started].end = (started + 1 < n_threads) ? (started + 1) * size : n;
+
+        if (ffts_thread_create(&threads[started], ffts_range_job_run, &jobs[started])) {
+            end = jobs[started].begin;
+            break;
+        }
+    }
+
+    func(arg, 0, size);
+
+    if (end < n) {
+        func(arg, end, n);
+    }
+
+    for (i = 1; i < started; i++) {
+        ffts_thread_join(threads[i]);
+    }
+#else
+    (void) n_threads;
+    func(arg, 0, n);
+#endif
+}
+
+#endif /* FFTS_THREAD_H */
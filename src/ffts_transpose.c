@@ -191,4 +191,26 @@ ffts_transpose(uint64_t *in, uint64_t *out, int w, int h)
         }
     }
 #endif
-}
\ No newline at end of file
+}
+
+void
+ffts_transpose_block(const uint64_t *in,
+                     size_t in_stride,
+                     uint64_t *out,
+                     size_t out_stride,
+                     size_t w,
+                     size_t h)
+{
+    size_t x, y;
+
+    /* h is small (at most a tile), so the rows being read stay in cache
+       while each output row is written contiguously */
+    for (x = 0; x < w; x++) {
+        const uint64_t *ip = in + x;
+        uint64_t *op = out + x * out_stride;
+
+        for (y = 0; y < h; y++) {
+            op[y] = ip[y * in_stride];
+        }
+    }
+}
@@ -43,4 +43,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 void
 ffts_transpose(uint64_t *in, uint64_t *out, int w, int h);
 
+/* transpose a w x h block with arbitrary row strides,
+   out[x * out_stride + y] = in[y * in_stride + x] */
+void
+ffts_transpose_block(const uint64_t *in,
+                     size_t in_stride,
+                     uint64_t *out,
+                     size_t out_stride,
+                     size_t w,
+                     size_t h);
+
 #endif /* FFTS_TRANSPOSE_H */
@@ -337,6 +337,20 @@ ffts_cexp_32f(size_t n, size_t d, float *output)
     return 0;
 }
 
+/* same as above, but keeps the double precision result */
+int
+ffts_cexp_64f(size_t n, size_t d, double *output)
+{
+    if (!d || !output)
+        return -1;
+
+    /* reduction */
+    if (FFTS_UNLIKELY(n >= d))
+        n %= d;
+
+    return ffts_cexp_32f64f(n, d, output);
+}
+
 /* used as intermediate result for single precision calculations */
 static int
 ffts_cexp_32f64f(size_t n, size_t d, double *output)
@@ -1053,6 +1067,43 @@ ffts_generate_table_1d_real_32f(struct _ffts_plan_t *const p,
         goto last;
     }
 
+    /* the recurrence below covers powers of two, the real transforms of
+       other sizes get their twiddles one at a time */
+    if (N & (N - 1)) {
+        for (i = 1; i < N/4; i++) {
+            float t0, t1, t2;
+
+            ffts_cexp_32f64f(i, N, w[0]);
+
+            if (sign < 0) {
+                t0 = (float) (0.5 * (1.0 - w[0][1]));
+                t1 = (float) (0.5 * w[0][0]);
+                t2 = (float) (0.5 * (1.0 + w[0][1]));
+
+                A[    2 * i + 1] = -t1;
+                A[N - 2 * i + 1] =  t1;
+                B[    2 * i + 0] =  invert ? -t2 : t2;
+                B[N - 2 * i + 0] =  invert ? -t2 : t2;
+            } else {
+                t0 = (float) (1.0 - w[0][1]);
+                t1 = (float) w[0][0];
+                t2 = (float) (1.0 + w[0][1]);
+
+                A[    2 * i + 1] = invert ?  t1 : -t1;
+                A[N - 2 * i + 1] = invert ? -t1 :  t1;
+                B[    2 * i + 0] = t2;
+                B[N - 2 * i + 0] = t2;
+            }
+
+            A[    2 * i + 0] = t0;
+            A[N - 2 * i + 0] = t0;
+            B[    2 * i + 1] = t1;
+            B[N - 2 * i + 1] = -t1;
+        }
+
+        goto last;
+    }
+
     /* calculate table offset */
     FFTS_ASSUME(N / 4 > 1);
     log_2 = ffts_ctzl(N);
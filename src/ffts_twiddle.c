@@ -0,0 +1,325 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ffts_twiddle.h"
+#include "ffts_thread.h"
+#include "ffts_trig.h"
+
+#include <string.h>
+
+typedef struct _ffts_twiddle_set_t ffts_twiddle_set_t;
+
+/* header placed in front of the levels of each set */
+struct _ffts_twiddle_set_t {
+    ffts_twiddle_set_t *next;
+    size_t leaf_N;
+    size_t n_luts;
+    size_t refs;
+};
+
+/* keeps the levels aligned for the vector loads */
+#define FFTS_TWIDDLE_HEADER_SIZE \
+    ((sizeof(ffts_twiddle_set_t) + 31) & ~((size_t) 31))
+
+#define FFTS_TWIDDLE_SET(ws) \
+    ((ffts_twiddle_set_t*) ((char*) (ws) - FFTS_TWIDDLE_HEADER_SIZE))
+
+#define FFTS_TWIDDLE_LEVELS(set) \
+    ((ffts_cpx_32f*) ((char*) (set) + FFTS_TWIDDLE_HEADER_SIZE))
+
+#ifdef FFTS_HAVE_ATOMIC_CAS
+/* newest first, so the first match has the most levels */
+static ffts_twiddle_set_t *ffts_twiddle_sets;
+
+/* held only while the list is searched or changed, never while the
+   levels of a set are generated */
+static void *volatile ffts_twiddle_lock;
+
+static void
+ffts_twiddle_acquire_lock(void)
+{
+    while (!ffts_atomic_cas_ptr(&ffts_twiddle_lock, NULL, (void*) &ffts_twiddle_lock));
+}
+
+static void
+ffts_twiddle_release_lock(void)
+{
+    ffts_atomic_cas_ptr(&ffts_twiddle_lock, (void*) &ffts_twiddle_lock, NULL);
+}
+#endif
+
+typedef struct _ffts_twiddle_level_t {
+    float *fw;
+    const ffts_cpx_32f *tmp;
+    size_t n;
+    size_t stride;
+} ffts_twiddle_level_t;
+
+/* factors of the first level, j from begin to end */
+static void
+ffts_twiddle_level_first(void *arg, size_t begin, size_t end)
+{
+    const ffts_twiddle_level_t *level = (const ffts_twiddle_level_t*) arg;
+    const ffts_cpx_32f *tmp = level->tmp;
+    float *fw = level->fw;
+    size_t j, stride = level->stride;
+
+    for (j = begin; j < end; j++) {
+        fw[2*j + 0] = tmp[j * stride][0];
+        fw[2*j + 1] = tmp[j * stride][1];
+    }
+}
+
+/* factors of the other levels, j from 2 * begin to 2 * end */
+static void
+ffts_twiddle_level_x8(void *arg, size_t begin, size_t end)
+{
+    const ffts_twiddle_level_t *level = (const ffts_twiddle_level_t*) arg;
+    const ffts_cpx_32f *tmp = level->tmp;
+    float *fw = level->fw;
+    size_t j, n = level->n, stride = level->stride;
+
+    for (j = 2 * begin; j < 2 * end; j += 2) {
+        fw[6*j +  0] = tmp[(2*j + 0) * stride][0];
+        fw[6*j +  1] = tmp[(2*j + 0) * stride][1];
+        fw[6*j +  2] = tmp[(2*j + 2) * stride][0];
+        fw[6*j +  3] = tmp[(2*j + 2) * stride][1];
+
+        fw[6*j +  4] = tmp[(j + 0) * stride][0];
+        fw[6*j +  5] = tmp[(j + 0) * stride][1];
+        fw[6*j +  6] = tmp[(j + 1) * stride][0];
+        fw[6*j +  7] = tmp[(j + 1) * stride][1];
+
+        fw[6*j +  8] = tmp[(j + 0 + n/8) * stride][0];
+        fw[6*j +  9] = tmp[(j + 0 + n/8) * stride][1];
+        fw[6*j + 10] = tmp[(j + 1 + n/8) * stride][0];
+        fw[6*j + 11] = tmp[(j + 1 + n/8) * stride][1];
+    }
+}
+
+/* generate the levels from first to n_luts - 1, the factors of the pass
+   of size n are exp(-2 * pi * i * k / n) stored as [re0, im0, re1, im1] */
+static int
+ffts_twiddle_generate(ffts_cpx_32f *ws,
+                      size_t leaf_N,
+                      size_t first,
+                      size_t n_luts,
+                      size_t n_threads)
+{
+    ffts_twiddle_level_t level;
+    ffts_cpx_32f *tmp;
+    size_t i;
+
+    /* factors of the largest pass, sampled for the smaller ones */
+    tmp = (ffts_cpx_32f*) ffts_aligned_malloc((leaf_N << (n_luts - 2)) * sizeof(*tmp));
+    if (!tmp) {
+        return -1;
+    }
+
+    /* a recurrence, so it stays on one thread */
+    ffts_generate_cosine_sine_pow2_32f(tmp, (int) (leaf_N << (n_luts - 2)));
+
+    level.tmp = tmp;
+
+    for (i = first; i < n_luts; i++) {
+        level.fw = (float*) (ws + ffts_twiddle_offset(leaf_N, i));
+        level.n = (leaf_N * 2) << i;
+        level.stride = (size_t) 1 << (n_luts - 1 - i);
+
+        /* the ranges write disjoint parts of the level */
+        if (!i) {
+            ffts_parallel_for(level.n/4, n_threads, ffts_twiddle_level_first, &level);
+        } else {
+            ffts_parallel_for(level.n/16, n_threads, ffts_twiddle_level_x8, &level);
+        }
+    }
+
+    ffts_aligned_free(tmp);
+    return 0;
+}
+
+static ffts_twiddle_set_t*
+ffts_twiddle_set_create(size_t leaf_N,
+                        size_t n_luts,
+                        const ffts_twiddle_set_t *prefix,
+                        size_t n_threads)
+{
+    ffts_twiddle_set_t *set;
+    size_t first = 0;
+
+    set = (ffts_twiddle_set_t*) ffts_aligned_malloc(FFTS_TWIDDLE_HEADER_SIZE +
+        ffts_twiddle_offset(leaf_N, n_luts) * sizeof(ffts_cpx_32f));
+    if (!set) {
+        return NULL;
+    }
+
+    set->next = NULL;
+    set->leaf_N = leaf_N;
+    set->n_luts = n_luts;
+    set->refs = 1;
+
+    /* the levels of a smaller set are the same */
+    if (prefix) {
+        first = prefix->n_luts;
+        memcpy(FFTS_TWIDDLE_LEVELS(set), FFTS_TWIDDLE_LEVELS(prefix),
+            ffts_twiddle_offset(leaf_N, first) * sizeof(ffts_cpx_32f));
+    }
+
+    if (ffts_twiddle_generate(FFTS_TWIDDLE_LEVELS(set), leaf_N, first, n_luts, n_threads)) {
+        ffts_aligned_free(set);
+        return NULL;
+    }
+
+    return set;
+}
+
+#ifdef FFTS_HAVE_ATOMIC_CAS
+/* returns a set of leaf_N with at least n_luts levels, and the largest
+   smaller one in prefix, must be called with the lock held */
+static ffts_twiddle_set_t*
+ffts_twiddle_find(size_t leaf_N, size_t n_luts, ffts_twiddle_set_t **prefix)
+{
+    ffts_twiddle_set_t *set;
+
+    *prefix = NULL;
+
+    for (set = ffts_twiddle_sets; set; set = set->next) {
+        if (set->leaf_N == leaf_N) {
+            if (set->n_luts >= n_luts) {
+                return set;
+            }
+
+            if (!*prefix) {
+                *prefix = set;
+            }
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+static void
+ffts_twiddle_set_release(ffts_twiddle_set_t *set)
+{
+#ifdef FFTS_HAVE_ATOMIC_CAS
+    ffts_twiddle_set_t **prev;
+
+    ffts_twiddle_acquire_lock();
+
+    if (--set->refs) {
+        set = NULL;
+    } else {
+        for (prev = &ffts_twiddle_sets; *prev != set; prev = &(*prev)->next);
+        *prev = set->next;
+    }
+
+    ffts_twiddle_release_lock();
+#endif
+
+    if (set) {
+        ffts_aligned_free(set);
+    }
+}
+
+ffts_cpx_32f*
+ffts_twiddle_acquire(size_t leaf_N, size_t n_luts, size_t n_threads)
+{
+    ffts_twiddle_set_t *set;
+
+#ifdef FFTS_HAVE_ATOMIC_CAS
+    ffts_twiddle_set_t *prefix, *created, *other;
+    size_t min_luts;
+
+    /* small plans share one set from the start */
+    min_luts = ffts_ctzl(FFTS_TWIDDLE_STORE_MIN_N / leaf_N);
+    if (n_luts < min_luts) {
+        n_luts = min_luts;
+    }
+
+    ffts_twiddle_acquire_lock();
+
+    set = ffts_twiddle_find(leaf_N, n_luts, &prefix);
+    if (set) {
+        set->refs++;
+    } else if (prefix) {
+        /* kept while its levels are copied */
+        prefix->refs++;
+    }
+
+    ffts_twiddle_release_lock();
+
+    if (set) {
+        return FFTS_TWIDDLE_LEVELS(set);
+    }
+
+    /* the levels of a large set take long to generate, other plans are
+       created and freed meanwhile */
+    created = ffts_twiddle_set_create(leaf_N, n_luts, prefix, n_threads);
+
+    ffts_twiddle_acquire_lock();
+
+    /* a set as large may have been added in the meantime, which is used
+       instead, so a set is only added with more levels than all others */
+    set = ffts_twiddle_find(leaf_N, n_luts, &other);
+    if (set) {
+        set->refs++;
+    } else if (created) {
+        set = created;
+        set->next = ffts_twiddle_sets;
+        ffts_twiddle_sets = set;
+        created = NULL;
+    }
+
+    ffts_twiddle_release_lock();
+
+    if (created) {
+        ffts_aligned_free(created);
+    }
+
+    if (prefix) {
+        ffts_twiddle_set_release(prefix);
+    }
+#else
+    /* without atomics every plan has its own table */
+    set = ffts_twiddle_set_create(leaf_N, n_luts, NULL, n_threads);
+#endif
+
+    return set ? FFTS_TWIDDLE_LEVELS(set) : NULL;
+}
+
+void
+ffts_twiddle_release(ffts_cpx_32f *ws)
+{
+    ffts_twiddle_set_release(FFTS_TWIDDLE_SET(ws));
+}
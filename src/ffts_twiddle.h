@@ -0,0 +1,76 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef FFTS_TWIDDLE_H
+#define FFTS_TWIDDLE_H
+
+#if defined (_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "ffts_internal.h"
+
+/* Process wide store of the twiddle factor tables of the x86 kernels.
+
+   The table of a pass depends only on its size and the kernels apply the
+   sign of the transform, so every plan with the same leaf size can read
+   the tables of its passes from one shared set of levels. The store keeps
+   the largest set built so far, a plan needing more levels builds a new
+   set reusing the existing ones, and each set is freed with the last plan
+   referencing it. Sets are built outside of the lock of the store, so
+   other plans are created and freed meanwhile. */
+
+/* smallest number of points the store builds tables for */
+#ifndef FFTS_TWIDDLE_STORE_MIN_N
+#define FFTS_TWIDDLE_STORE_MIN_N 4096
+#endif
+
+/* returns a table holding at least the first n_luts levels, the missing
+   levels are generated on up to n_threads threads */
+ffts_cpx_32f*
+ffts_twiddle_acquire(size_t leaf_N, size_t n_luts, size_t n_threads);
+
+void
+ffts_twiddle_release(ffts_cpx_32f *ws);
+
+/* offset of the level in complex numbers, also the size of the levels
+   before it */
+static FFTS_INLINE size_t
+ffts_twiddle_offset(size_t leaf_N, size_t level)
+{
+    /* leaf_N/2 factors for the first level, 3 * (leaf_N << level) / 4 for
+       each of the others */
+    return level ? leaf_N/2 + 3 * leaf_N/4 * (((size_t) 1 << level) - 2) : 0;
+}
+
+#endif /* FFTS_TWIDDLE_H */
@@ -0,0 +1,414 @@
+/*
+
+ This file is part of FFTS -- The Fastest Fourier Transform in the South
+
+ Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+ Copyright (c) 2012, The University of Waikato
+
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#if defined(HAVE_MEMFD_CREATE) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "ffts_vmem.h"
+
+#if _WIN32
+#include <windows.h>
+#else
+#if __APPLE__
+#include <libkern/OSCacheControl.h>
+#endif
+
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#endif
+
+#if defined(HAVE_MEMFD_CREATE) && defined(HAVE_SYS_MMAN_H)
+#define FFTS_VMEM_DUAL_MAPPING
+#endif
+
+static int
+ffts_allow_execute(void *start, size_t len)
+{
+    int result;
+
+#ifdef _WIN32
+    DWORD old_protect;
+    result = !VirtualProtect(start, len, PAGE_EXECUTE_READ, &old_protect);
+#else
+    result = mprotect(start, len, PROT_READ | PROT_EXEC);
+#endif
+
+    return result;
+}
+
+static int
+ffts_deny_execute(void *start, size_t len)
+{
+    int result;
+
+#ifdef _WIN32
+    DWORD old_protect;
+    result = (int) VirtualProtect(start, len, PAGE_READWRITE, &old_protect);
+#else
+    result = mprotect(start, len, PROT_READ | PROT_WRITE);
+#endif
+
+    return result;
+}
+
+static int
+ffts_flush_instruction_cache(void *start, size_t length)
+{
+#ifdef _WIN32
+    return !FlushInstructionCache(GetCurrentProcess(), start, length);
+#else
+#ifdef __APPLE__
+    sys_icache_invalidate(start, length);
+#elif __ANDROID__
+    cacheflush((long) start, (long) start + length, 0);
+#elif __linux__
+#if GCC_VERSION_AT_LEAST(4,3)
+    __builtin___clear_cache(start, (char*) start + length);
+#elif __GNUC__
+    __clear_cache((long) start, (long) start + length);
+#endif
+#endif
+    return 0;
+#endif
+}
+
+static void*
+ffts_vmem_alloc(size_t length)
+{
+#if __APPLE__
+    void *p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED, -1, 0);
+    return (p == MAP_FAILED) ? NULL : p;
+#elif _WIN32
+    return VirtualAlloc(NULL, length, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS 0x20
+#endif
+
+    void *p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_SHARED, -1, 0);
+    return (p == MAP_FAILED) ? NULL : p;
+#endif
+}
+
+static void
+ffts_vmem_free(void *addr, size_t length)
+{
+#ifdef _WIN32
+    (void) length;
+    VirtualFree(addr, 0, MEM_RELEASE);
+#else
+    munmap(addr, length);
+#endif
+}
+
+#ifdef FFTS_VMEM_DUAL_MAPPING
+/* slabs are split into blocks tracked by a 64-bit map */
+#define FFTS_VMEM_BLOCK_SIZE 16384
+#define FFTS_VMEM_SLAB_BLOCKS 64
+#define FFTS_VMEM_SLAB_SIZE (FFTS_VMEM_BLOCK_SIZE * FFTS_VMEM_SLAB_BLOCKS)
+
+typedef struct _ffts_vmem_slab_t ffts_vmem_slab_t;
+
+struct _ffts_vmem_slab_t {
+    ffts_vmem_slab_t *next;
+    char *rw;
+    char *rx;
+    size_t size;
+
+    /* used blocks, allocations larger than a slab get a slab of their own */
+    uint64_t used;
+};
+
+static ffts_vmem_slab_t *ffts_vmem_slabs;
+static void *volatile ffts_vmem_lock;
+
+/* set once creating a dual mapped slab has failed */
+static volatile int ffts_vmem_no_slabs;
+
+static void
+ffts_vmem_acquire(void)
+{
+    while (!ffts_atomic_cas_ptr(&ffts_vmem_lock, NULL, (void*) &ffts_vmem_lock));
+}
+
+static void
+ffts_vmem_release(void)
+{
+    ffts_atomic_cas_ptr(&ffts_vmem_lock, (void*) &ffts_vmem_lock, NULL);
+}
+
+static ffts_vmem_slab_t*
+ffts_vmem_slab_create(size_t size)
+{
+    ffts_vmem_slab_t *slab;
+    void *rw, *rx;
+    int fd;
+
+    slab = (ffts_vmem_slab_t*) calloc(1, sizeof(*slab));
+    if (!slab) {
+        return NULL;
+    }
+
+    fd = memfd_create("ffts", MFD_CLOEXEC);
+    if (fd < 0) {
+        goto cleanup;
+    }
+
+    if (ftruncate(fd, (off_t) size)) {
+        goto close_fd;
+    }
+
+    rw = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (rw == MAP_FAILED) {
+        goto close_fd;
+    }
+
+    rx = mmap(NULL, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+    if (rx == MAP_FAILED) {
+        munmap(rw, size);
+        goto close_fd;
+    }
+
+    /* the mappings keep the memory alive */
+    close(fd);
+
+    slab->rw   = (char*) rw;
+    slab->rx   = (char*) rx;
+    slab->size = size;
+    return slab;
+
+close_fd:
+    close(fd);
+cleanup:
+    free(slab);
+    return NULL;
+}
+
+static void
+ffts_vmem_slab_destroy(ffts_vmem_slab_t *slab)
+{
+    munmap(slab->rx, slab->size);
+    munmap(slab->rw, slab->size);
+    free(slab);
+}
+
+/* called with the lock held */
+static ffts_vmem_slab_t*
+ffts_vmem_slab_find(const void *code)
+{
+    ffts_vmem_slab_t *slab;
+
+    for (slab = ffts_vmem_slabs; slab; slab = slab->next) {
+        if ((const char*) code >= slab->rx &&
+            (const char*) code < slab->rx + slab->size) {
+            return slab;
+        }
+    }
+
+    return NULL;
+}
+
+static void*
+ffts_vmem_pool_alloc(size_t size)
+{
+    ffts_vmem_slab_t *slab;
+    size_t n_blocks;
+    uint64_t mask;
+    void *code = NULL;
+    int i;
+
+    n_blocks = (size + FFTS_VMEM_BLOCK_SIZE - 1) / FFTS_VMEM_BLOCK_SIZE;
+    if (n_blocks > FFTS_VMEM_SLAB_BLOCKS) {
+        slab = ffts_vmem_slab_create(n_blocks * FFTS_VMEM_BLOCK_SIZE);
+        if (!slab) {
+            return NULL;
+        }
+
+        ffts_vmem_acquire();
+        slab->next = ffts_vmem_slabs;
+        ffts_vmem_slabs = slab;
+        ffts_vmem_release();
+        return slab->rx;
+    }
+
+    if (n_blocks == FFTS_VMEM_SLAB_BLOCKS) {
+        mask = ~UINT64_C(0);
+    } else {
+        mask = (UINT64_C(1) << n_blocks) - 1;
+    }
+
+    ffts_vmem_acquire();
+
+    for (slab = ffts_vmem_slabs; slab && !code; slab = slab->next) {
+        if (slab->size != FFTS_VMEM_SLAB_SIZE) {
+            continue;
+        }
+
+        for (i = 0; i <= FFTS_VMEM_SLAB_BLOCKS - (int) n_blocks; i++) {
+            if (!(slab->used & (mask << i))) {
+                slab->used |= mask << i;
+                code = slab->rx + (size_t) i * FFTS_VMEM_BLOCK_SIZE;
+                break;
+            }
+        }
+    }
+
+    if (!code) {
+        slab = ffts_vmem_slab_create(FFTS_VMEM_SLAB_SIZE);
+        if (slab) {
+            slab->used = mask;
+            slab->next = ffts_vmem_slabs;
+            ffts_vmem_slabs = slab;
+            code = slab->rx;
+        } else {
+            ffts_vmem_no_slabs = 1;
+        }
+    }
+
+    ffts_vmem_release();
+    return code;
+}
+
+/* returns non-zero if the block belonged to the pool */
+static int
+ffts_vmem_pool_free(void *code, size_t size)
+{
+    ffts_vmem_slab_t **link, *slab;
+    size_t first, n_blocks;
+    uint64_t mask;
+
+    ffts_vmem_acquire();
+
+    for (link = &ffts_vmem_slabs; (slab = *link) != NULL; link = &slab->next) {
+        if ((char*) code >= slab->rx && (char*) code < slab->rx + slab->size) {
+            break;
+        }
+    }
+
+    if (!slab) {
+        ffts_vmem_release();
+        return 0;
+    }
+
+    if (slab->size != FFTS_VMEM_SLAB_SIZE) {
+        *link = slab->next;
+        ffts_vmem_release();
+        ffts_vmem_slab_destroy(slab);
+        return 1;
+    }
+
+    first = ((char*) code - slab->rx) / FFTS_VMEM_BLOCK_SIZE;
+    n_blocks = (size + FFTS_VMEM_BLOCK_SIZE - 1) / FFTS_VMEM_BLOCK_SIZE;
+    if (n_blocks == FFTS_VMEM_SLAB_BLOCKS) {
+        mask = ~UINT64_C(0);
+    } else {
+        mask = (UINT64_C(1) << n_blocks) - 1;
+    }
+
+    slab->used &= ~(mask << first);
+    ffts_vmem_release();
+    return 1;
+}
+#endif
+
+void*
+ffts_vmem_code_alloc(size_t size)
+{
+#ifdef FFTS_VMEM_DUAL_MAPPING
+    if (!ffts_vmem_no_slabs) {
+        void *code = ffts_vmem_pool_alloc(size);
+        if (code) {
+            return code;
+        }
+    }
+#endif
+
+    return ffts_vmem_alloc(size);
+}
+
+void*
+ffts_vmem_code_writable(void *code)
+{
+#ifdef FFTS_VMEM_DUAL_MAPPING
+    ffts_vmem_slab_t *slab;
+    void *rw = code;
+
+    ffts_vmem_acquire();
+    slab = ffts_vmem_slab_find(code);
+    if (slab) {
+        rw = slab->rw + ((char*) code - slab->rx);
+    }
+    ffts_vmem_release();
+
+    return rw;
+#else
+    return code;
+#endif
+}
+
+int
+ffts_vmem_code_commit(void *code, size_t size)
+{
+#ifdef FFTS_VMEM_DUAL_MAPPING
+    if (ffts_vmem_code_writable(code) != code) {
+        return ffts_flush_instruction_cache(code, size);
+    }
+#endif
+
+    /* enable execution with read access for the block */
+    if (ffts_allow_execute(code, size)) {
+        return -1;
+    }
+
+    /* flush from the instruction cache */
+    return ffts_flush_instruction_cache(code, size);
+}
+
+void
+ffts_vmem_code_free(void *code, size_t size)
+{
+#ifdef FFTS_VMEM_DUAL_MAPPING
+    if (ffts_vmem_pool_free(code, size)) {
+        return;
+    }
+#endif
+
+    ffts_deny_execute(code, size);
+    ffts_vmem_free(code, size);
+}
@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+#
+# This file is part of FFTS -- The Fastest Fourier Transform in the South
+#
+# Copyright (c) 2012, Anthony M. Blake <amb@anthonix.com>
+# Copyright (c) 2012, The University of Waikato
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in the
+#     documentation and/or other materials provided with the distribution.
+#   * Neither the name of the organization nor the
+#     names of its contributors may be used to endorse or promote products
+#     derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Writes ffts_small_kernels.h, the straight-line transforms of the sizes
+# FFTS_SMALL_MIN_N to FFTS_SMALL_MAX_N. They run the same leaves and passes
+# as the static engine, but the leaf offsets, the pass recursion and the
+# twiddle factors are resolved here, so a plan of these sizes needs no
+# tables of its own.
+#
+#   python3 generate_small_kernels.py [output]
+
+import math
+import struct
+import sys
+
+MIN_LOG_N = 5
+MAX_LOG_N = 9
+LEAF_N = 8
+
+# passes up to this size have their butterflies unrolled, the larger
+# ones keep the loop of V4SF_X_8 to bound the code size
+UNROLL_MAX_N = 64
+
+
+def f32(x):
+    """x rounded to single precision, printed so it reads back exactly"""
+    x = struct.unpack('f', struct.pack('f', x))[0]
+    if x == 0.0:
+        return '-0.0f' if math.copysign(1.0, x) < 0 else '0.0f'
+    s = '%.9g' % x
+    if '.' not in s and 'e' not in s:
+        s += '.0'
+    return s + 'f'
+
+
+def twiddle(k, n):
+    """exp(-2 * pi * i * k / n), exact on the axes and the diagonals"""
+    k %= n
+    if 8 * k % n == 0:
+        c = [1.0, math.sqrt(0.5), 0.0, -math.sqrt(0.5),
+             -1.0, -math.sqrt(0.5), 0.0, math.sqrt(0.5)][8 * k // n]
+        s = [0.0, math.sqrt(0.5), 1.0, math.sqrt(0.5),
+             0.0, -math.sqrt(0.5), -1.0, -math.sqrt(0.5)][8 * k // n]
+    else:
+        c = math.cos(2.0 * math.pi * k / n)
+        s = math.sin(2.0 * math.pi * k / n)
+    return (c, -s)
+
+
+def twiddle_levels():
+    """the levels of ffts_generate_luts for passes of 16 up to 2^MAX_LOG_N,
+    returns the floats and the offset of each level"""
+    table = []
+    offsets = []
+
+    for level in range(MAX_LOG_N - 3):
+        n = 16 << level
+        offsets.append(len(table))
+
+        if level == 0:
+            for j in range(n // 4):
+                table += twiddle(j, n)
+        else:
+            for j in range(0, n // 8, 2):
+                for k in (2 * j, 2 * j + 2, j, j + 1, j + n // 8, j + 1 + n // 8):
+                    table += twiddle(k, n)
+
+    return table, offsets
+
+
+def leaf_offsets(log_n):
+    """port of ffts_elaborate_offsets_even8 of patterns.h"""
+    n_leaves = 1 << (log_n - 3)
+    offsets = [0] * n_leaves
+
+    def store(input_offset, output_offset):
+        if input_offset < 0:
+            input_offset += n_leaves
+        offsets[input_offset] = 2 * output_offset
+
+    def odd8(log_n, input_offset, output_offset, stride):
+        if log_n <= 4:
+            store(input_offset, output_offset)
+            if log_n == 4:
+                store(input_offset + stride, output_offset + 8)
+        else:
+            odd8(log_n - 1, input_offset, output_offset, stride * 2)
+            odd8(log_n - 2, input_offset + stride,
+                 output_offset + (1 << (log_n - 1)), stride * 4)
+            odd8(log_n - 2, input_offset - stride,
+                 output_offset + 3 * (1 << (log_n - 2)), stride * 4)
+
+    offset = 1 << (log_n - 4)
+    store(0, 0)
+    store(offset, 8)
+    store(offset // 2, 16)
+    store(-offset // 2, 24)
+
+    stride = 1
+    while log_n > 5:
+        odd8(log_n - 2, stride, 1 << (log_n - 1), stride * 4)
+        odd8(log_n - 2, -stride, 3 * (1 << (log_n - 2)), stride * 4)
+        log_n -= 1
+        stride *= 2
+
+    return offsets
+
+
+def leaf_inputs(n):
+    """the input indexes of the first leaf, as ffts_init_is"""
+    s = (n // LEAF_N).bit_length() - 1
+    index = [0, 1 << (s + 2), 1 << (s + 1), 3 << (s + 1),
+             1 << s, (1 << s) + (1 << (s + 2)), n - (1 << s), 3 << s]
+    return [2 * i for i in index]
+
+
+def leaves(log_n):
+    """the leaf kernels in execution order"""
+    n = 1 << log_n
+    i0 = (n // LEAF_N // 3 + 1) // 2
+    i1 = n // LEAF_N // 3
+    if (n // LEAF_N) % 3 > 1:
+        i1 += 1
+    i1 //= 2
+
+    if log_n & 1:
+        return ['EE'] * i0 + ['OO'] * i1 + ['OE'] + ['EE2'] * i1
+    return ['EE'] * i0 + ['EO'] + ['OO'] * i1 + ['EE2'] * i1
+
+
+def passes(offset, n, out):
+    """the pass recursion of ffts_static_rec_f_32f as (kind, offset, size)"""
+    if n > 128:
+        passes(offset, n // 4, out)
+        passes(offset + n // 2, n // 8, out)
+        passes(offset + n // 2 + n // 4, n // 8, out)
+        passes(offset + n, n // 4, out)
+        passes(offset + n + n // 2, n // 4, out)
+        out.append(('X_8', offset, n))
+    elif n == 128:
+        out.append(('X_8', offset, 32))
+        out.append(('X_4', offset + 64, 16))
+        out.append(('X_4', offset + 96, 16))
+        out.append(('X_8', offset + 128, 32))
+        out.append(('X_8', offset + 192, 32))
+        out.append(('X_8', offset, 128))
+    elif n == 64:
+        out.append(('X_4', offset, 16))
+        out.append(('X_4', offset + 64, 16))
+        out.append(('X_4', offset + 96, 16))
+        out.append(('X_8', offset, 64))
+    else:
+        out.append(('X_8', offset, 32))
+    return out
+
+
+def int_table(values, indent='    ', per_line=8):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ', '.join('%d' % v for v in values[i:i + per_line]))
+    return ',\n'.join(lines)
+
+
+def float_table(values, indent='    '):
+    lines = []
+    for i in range(0, len(values), 4):
+        lines.append(indent + ', '.join(f32(v) for v in values[i:i + 4]))
+    return ',\n'.join(lines)
+
+
+def split_table(table, sign):
+    """the factors duplicated and signed for V4SF_K_N, each pair of
+    [re0, im0, re1, im1] becomes [re0, re0, re1, re1, im0, -im0, im1, -im1]
+    with the imaginary parts negated for the inverse"""
+    split = []
+    for i in range(0, len(table), 4):
+        re0, im0, re1, im1 = table[i:i + 4]
+        im0 *= sign
+        im1 *= sign
+        split += [re0, re0, re1, re1, im0, -im0, im1, -im1]
+    return split
+
+
+def generate(f):
+    table, level_offsets = twiddle_levels()
+
+    f.write('/* generated by generate_small_kernels.py, do not edit */\n\n')
+    f.write('#ifndef FFTS_SMALL_KERNELS_H\n')
+    f.write('#define FFTS_SMALL_KERNELS_H\n\n')
+    f.write('#if defined (_MSC_VER) && (_MSC_VER >= 1020)\n')
+    f.write('#pragma once\n')
+    f.write('#endif\n\n')
+
+    f.write('/* twiddle factors of the passes of 16 up to %d, one level per size\n'
+            '   in the order of ffts_generate_luts */\n' % (1 << MAX_LOG_N))
+    for name, sign in (('ffts_small_lut_32f', 1), ('ffts_small_lut_inv_32f', -1)):
+        split = split_table(table, sign)
+        f.write('static const FFTS_ALIGN(16) float %s[%d] = {\n' % (name, len(split)))
+        f.write(float_table(split))
+        f.write('\n};\n\n')
+
+    for log_n in range(MIN_LOG_N, MAX_LOG_N + 1):
+        n = 1 << log_n
+        f.write('static const int32_t ffts_small_is%d[8] = {\n' % n)
+        f.write(int_table(leaf_inputs(n)))
+        f.write('\n};\n\n')
+        f.write('static const int32_t ffts_small_os%d[%d] = {\n' % (n, n // LEAF_N))
+        f.write(int_table(leaf_offsets(log_n)))
+        f.write('\n};\n\n')
+
+    for log_n in range(MIN_LOG_N, MAX_LOG_N + 1):
+        n = 1 << log_n
+
+        f.write('static FFTS_ALWAYS_INLINE void\n')
+        f.write('ffts_small_transform%d_32f(const float *FFTS_RESTRICT din,\n' % n)
+        f.write('                          float *FFTS_RESTRICT dout,\n')
+        f.write('                          int inv,\n')
+        f.write('                          const float *FFTS_RESTRICT scale)\n')
+        f.write('{\n')
+        f.write('    const float *FFTS_RESTRICT lut = inv ?\n')
+        f.write('        ffts_small_lut_inv_32f : ffts_small_lut_32f;\n\n')
+
+        for i, kind in enumerate(leaves(log_n)):
+            f.write('    V4SF_LEAF_%s(dout, ffts_small_os%d + %d, din + %d, ffts_small_is%d, inv);\n'
+                    % (kind, n, 2 * i, 4 * i, n))
+        f.write('\n')
+
+        for kind, offset, size in passes(0, n, []):
+            lut = 2 * level_offsets[size.bit_length() - 5]
+            # the last pass multiplies by the factor of ffts_set_scale
+            scale = 'scale' if size == n else 'NULL'
+            if kind == 'X_4':
+                f.write('    V4SF_X_4_SPLIT(inv, dout + %d, %d, lut + %d);\n'
+                        % (offset, size, lut))
+            elif size <= UNROLL_MAX_N:
+                for j in range(size // 16):
+                    f.write('    V4SF_X_8_SPLIT(inv, %s, dout + %d, %d, 1, lut + %d);\n'
+                            % (scale, offset + 4 * j, size, lut + 24 * j))
+            else:
+                f.write('    V4SF_X_8_SPLIT(inv, %s, dout + %d, %d, %d, lut + %d);\n'
+                        % (scale, offset, size, size // 16, lut))
+
+        f.write('}\n\n')
+
+    f.write('#endif /* FFTS_SMALL_KERNELS_H */\n')
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else 'ffts_small_kernels.h'
+    with open(path, 'w', newline='\n') as f:
+        generate(f)
+
+
+if __name__ == '__main__':
+    main()
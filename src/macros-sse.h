@@ -40,6 +40,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <xmmintrin.h>
 
+#ifdef HAVE_PMMINTRIN_H
+#include <pmmintrin.h>
+#elif HAVE_INTRIN_H
+#include <intrin.h>
+#endif
+
 typedef __m128 V4SF;
 
 #define V4SF_ADD  _mm_add_ps
@@ -50,6 +56,10 @@ typedef __m128 V4SF;
 #define V4SF_ST   _mm_store_ps
 #define V4SF_LD   _mm_load_ps
 
+/* non-temporal store, ordered by V4SF_FENCE */
+#define V4SF_STREAM _mm_stream_ps
+#define V4SF_FENCE  _mm_sfence
+
 #define V4SF_SWAP_PAIRS(x) \
     (_mm_shuffle_ps(x, x, _MM_SHUFFLE(2,3,0,1)))
 
@@ -63,11 +73,19 @@ typedef __m128 V4SF;
 #define V4SF_BLEND(x, y) \
     (_mm_shuffle_ps(x, y, _MM_SHUFFLE(3,2,1,0)))
 
+#ifdef HAVE_SSE3
+#define V4SF_DUPLICATE_RE(r) \
+    (_mm_moveldup_ps(r))
+
+#define V4SF_DUPLICATE_IM(r) \
+    (_mm_movehdup_ps(r))
+#else
 #define V4SF_DUPLICATE_RE(r) \
     (_mm_shuffle_ps(r, r, _MM_SHUFFLE(2,2,0,0)))
 
 #define V4SF_DUPLICATE_IM(r) \
     (_mm_shuffle_ps(r, r, _MM_SHUFFLE(3,3,1,1)))
+#endif
 
 static FFTS_ALWAYS_INLINE V4SF
 V4SF_IMULI(int inv, V4SF a)
@@ -49,6 +49,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "macros-alpha.h"
 #endif
 
+/* without non-temporal stores write through the cache */
+#ifndef V4SF_STREAM
+#define V4SF_STREAM V4SF_ST
+#define V4SF_FENCE()
+#endif
+
 static FFTS_INLINE void
 V4SF_TX2(V4SF *a, V4SF *b)
 {
@@ -39,8 +39,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 #endif
 
+#include "ffts_thread.h"
+
 #include <stddef.h>
 
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
 #ifdef HAVE_STDLIB_H
 #include <stdlib.h>
 #endif
@@ -51,32 +57,34 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #if LEAF_N == 8
 static void
-ffts_elaborate_offsets_even8(ptrdiff_t *const offsets,
+ffts_elaborate_offsets_even8(int32_t *const offsets,
                              int log_N);
 
 static void
-ffts_elaborate_offsets_odd8(ptrdiff_t *const offsets,
+ffts_elaborate_offsets_odd8(int32_t *const offsets,
+                            int n_leaves,
                             int log_N,
                             int input_offset,
                             int output_offset,
                             int stride);
 
 static void
-ffts_hardcodedleaf_is_rec_even4(ptrdiff_t **is,
+ffts_hardcodedleaf_is_rec_even4(int32_t **is,
                                 int big_N,
                                 int offset,
                                 int stride,
                                 int VL);
 
 static void
-ffts_hardcodedleaf_is_rec_even8(ptrdiff_t **is,
+ffts_hardcodedleaf_is_rec_even8(int32_t **is,
                                 int big_N,
                                 int offset,
                                 int stride,
                                 int VL);
 #else
 static void
-ffts_elaborate_offsets_even(ptrdiff_t *const offsets,
+ffts_elaborate_offsets_even(int32_t *const offsets,
+                            int n_leaves,
                             int leaf_N,
                             int N,
                             int input_offset,
@@ -84,7 +92,8 @@ ffts_elaborate_offsets_even(ptrdiff_t *const offsets,
                             int stride);
 
 static void
-ffts_elaborate_offsets_odd(ptrdiff_t *const offsets,
+ffts_elaborate_offsets_odd(int32_t *const offsets,
+                           int n_leaves,
                            int leaf_N,
                            int N,
                            int input_offset,
@@ -92,7 +101,7 @@ ffts_elaborate_offsets_odd(ptrdiff_t *const offsets,
                            int stride);
 
 static void
-ffts_hardcodedleaf_is_rec_even(ptrdiff_t **is,
+ffts_hardcodedleaf_is_rec_even(int32_t **is,
                                int big_N,
                                int N,
                                int offset,
@@ -100,7 +109,7 @@ ffts_hardcodedleaf_is_rec_even(ptrdiff_t **is,
                                int VL);
 
 static void
-ffts_hardcodedleaf_is_rec_odd(ptrdiff_t **is,
+ffts_hardcodedleaf_is_rec_odd(int32_t **is,
                               int big_N,
                               int N,
                               int offset,
@@ -108,12 +117,18 @@ ffts_hardcodedleaf_is_rec_odd(ptrdiff_t **is,
                               int VL);
 #endif
 
-static int
-ffts_compare_offsets(const void *pa, const void *pb)
+/* The leaves are executed in the order of their first input, which is
+   also the order of ffts_init_is. The inputs of the leaves are 0 up to
+   n_leaves - i2 - 1 followed by -i2 up to -1 (modulo N), so the output
+   offset of a leaf is stored directly at its position. */
+static void
+ffts_store_offset(int32_t *const offsets,
+                  int n_leaves,
+                  int input_offset,
+                  int output_offset)
 {
-    const ptrdiff_t a = *(const ptrdiff_t*) pa;
-    const ptrdiff_t b = *(const ptrdiff_t*) pb;
-    return (a > b) - (a < b);
+    offsets[(input_offset < 0) ? input_offset + n_leaves : input_offset] =
+        2 * output_offset;
 }
 
 static void
@@ -132,58 +147,55 @@ ffts_permute_addr(int N, int offset, int stride, int *const d)
 
 #if LEAF_N == 8
 static void
-ffts_elaborate_offsets_even8(ptrdiff_t *const offsets, int log_N)
+ffts_elaborate_offsets_even8(int32_t *const offsets, int log_N)
 {
+    int n_leaves = 1 << (log_N - 3);
     int offset = 1 << (log_N - 4);
     int stride = 1;
 
-    offsets[0] = 0;
-    offsets[1] = 0;
-    offsets[2] = offset * 2;
-    offsets[3] = 8;
-    offsets[4] = offset;
-    offsets[5] = 16;
-    offsets[6] = -offset;
-    offsets[7] = 24;
+    ffts_store_offset(offsets, n_leaves, 0, 0);
+    ffts_store_offset(offsets, n_leaves, offset, 8);
+    ffts_store_offset(offsets, n_leaves, offset / 2, 16);
+    ffts_store_offset(offsets, n_leaves, -offset / 2, 24);
 
     for(; log_N > 5; --log_N, stride *= 2) {
-        ffts_elaborate_offsets_odd8(offsets, log_N - 2,
+        ffts_elaborate_offsets_odd8(offsets, n_leaves, log_N - 2,
             stride, 1 << (log_N - 1), stride * 4);
 
-        ffts_elaborate_offsets_odd8(offsets, log_N - 2,
+        ffts_elaborate_offsets_odd8(offsets, n_leaves, log_N - 2,
             -stride, 3 * (1 << (log_N - 2)), stride * 4);
     }
 }
 
 static void
-ffts_elaborate_offsets_odd8(ptrdiff_t *const offsets,
+ffts_elaborate_offsets_odd8(int32_t *const offsets,
+                            int n_leaves,
                             int log_N,
                             int input_offset,
                             int output_offset,
                             int stride)
 {
     if (log_N <= 4) {
-        offsets[(output_offset / 4) + 0] = input_offset * 2;
-        offsets[(output_offset / 4) + 1] = output_offset;
+        ffts_store_offset(offsets, n_leaves, input_offset, output_offset);
 
         if (log_N == 4) {
-            offsets[(output_offset / 4) + 2] = (input_offset + stride) * 2;
-            offsets[(output_offset / 4) + 3] = output_offset + 8;
+            ffts_store_offset(offsets, n_leaves,
+                input_offset + stride, output_offset + 8);
         }
     } else {
-        ffts_elaborate_offsets_odd8(offsets, log_N - 1, input_offset,
-            output_offset, stride * 2);
+        ffts_elaborate_offsets_odd8(offsets, n_leaves, log_N - 1,
+            input_offset, output_offset, stride * 2);
 
-        ffts_elaborate_offsets_odd8(offsets, log_N - 2, input_offset + stride,
-            output_offset + (1 << (log_N - 1)), stride * 4);
+        ffts_elaborate_offsets_odd8(offsets, n_leaves, log_N - 2,
+            input_offset + stride, output_offset + (1 << (log_N - 1)), stride * 4);
 
-        ffts_elaborate_offsets_odd8(offsets, log_N - 2, input_offset - stride,
-            output_offset + 3 * (1 << (log_N - 2)), stride * 4);
+        ffts_elaborate_offsets_odd8(offsets, n_leaves, log_N - 2,
+            input_offset - stride, output_offset + 3 * (1 << (log_N - 2)), stride * 4);
     }
 }
 
 static void
-ffts_hardcodedleaf_is_rec_even4(ptrdiff_t **is,
+ffts_hardcodedleaf_is_rec_even4(int32_t **is,
                                 int big_N,
                                 int offset,
                                 int stride,
@@ -203,7 +215,7 @@ ffts_hardcodedleaf_is_rec_even4(ptrdiff_t **is,
 }
 
 static void
-ffts_hardcodedleaf_is_rec_even8(ptrdiff_t **is,
+ffts_hardcodedleaf_is_rec_even8(int32_t **is,
                                 int big_N,
                                 int offset,
                                 int stride,
@@ -243,7 +255,8 @@ ffts_hardcodedleaf_is_rec_even8(ptrdiff_t **is,
 }
 #else
 static void
-ffts_elaborate_offsets_even(ptrdiff_t *const offsets,
+ffts_elaborate_offsets_even(int32_t *const offsets,
+                            int n_leaves,
                             int leaf_N,
                             int N,
                             int input_offset,
@@ -251,24 +264,24 @@ ffts_elaborate_offsets_even(ptrdiff_t *const offsets,
                             int stride)
 {
     if (N == leaf_N) {
-        offsets[2 * (output_offset / leaf_N) + 0] = input_offset * 2;
-        offsets[2 * (output_offset / leaf_N) + 1] = output_offset;
+        ffts_store_offset(offsets, n_leaves, input_offset, output_offset);
     } else if (N > 4) {
-        ffts_elaborate_offsets_even(offsets, leaf_N,
+        ffts_elaborate_offsets_even(offsets, n_leaves, leaf_N,
             N/2, input_offset, output_offset, stride * 2);
 
-        ffts_elaborate_offsets_odd(offsets, leaf_N,
+        ffts_elaborate_offsets_odd(offsets, n_leaves, leaf_N,
             N/4, input_offset + stride, output_offset + N/2, stride * 4);
 
         if (N/4 >= leaf_N) {
-            ffts_elaborate_offsets_odd(offsets, leaf_N,
+            ffts_elaborate_offsets_odd(offsets, n_leaves, leaf_N,
                 N/4, input_offset - stride, output_offset + 3*N/4, stride * 4);
         }
     }
 }
 
 static void
-ffts_elaborate_offsets_odd(ptrdiff_t *const offsets,
+ffts_elaborate_offsets_odd(int32_t *const offsets,
+                           int n_leaves,
                            int leaf_N,
                            int N,
                            int input_offset,
@@ -276,24 +289,23 @@ ffts_elaborate_offsets_odd(ptrdiff_t *const offsets,
                            int stride)
 {
     if (N <= leaf_N) {
-        offsets[2 * (output_offset / leaf_N) + 0] = input_offset * 2;
-        offsets[2 * (output_offset / leaf_N) + 1] = output_offset;
+        ffts_store_offset(offsets, n_leaves, input_offset, output_offset);
     } else if (N > 4) {
-        ffts_elaborate_offsets_odd(offsets, leaf_N, N/2,
+        ffts_elaborate_offsets_odd(offsets, n_leaves, leaf_N, N/2,
             input_offset, output_offset, stride * 2);
 
-        ffts_elaborate_offsets_odd(offsets, leaf_N, N/4,
+        ffts_elaborate_offsets_odd(offsets, n_leaves, leaf_N, N/4,
             input_offset + stride, output_offset + N/2, stride * 4);
 
         if (N/4 >= leaf_N) {
-            ffts_elaborate_offsets_odd(offsets, leaf_N, N/4,
+            ffts_elaborate_offsets_odd(offsets, n_leaves, leaf_N, N/4,
                 input_offset - stride, output_offset + 3*N/4, stride * 4);
         }
     }
 }
 
 static void
-ffts_hardcodedleaf_is_rec_even(ptrdiff_t **is,
+ffts_hardcodedleaf_is_rec_even(int32_t **is,
                                int big_N,
                                int N,
                                int offset,
@@ -356,7 +368,7 @@ ffts_hardcodedleaf_is_rec_even(ptrdiff_t **is,
 }
 
 static void
-ffts_hardcodedleaf_is_rec_odd(ptrdiff_t **is,
+ffts_hardcodedleaf_is_rec_odd(int32_t **is,
                               int big_N,
                               int N,
                               int offset,
@@ -419,101 +431,106 @@ ffts_hardcodedleaf_is_rec_odd(ptrdiff_t **is,
 }
 #endif
 
-static ptrdiff_t*
-ffts_init_is(size_t N, size_t leaf_N, int VL)
+typedef struct _ffts_is_range_t {
+    int32_t *is;
+    size_t N;
+    size_t leaf_N;
+    int VL;
+} ffts_is_range_t;
+
+/* Input indexes of the leaves at positions begin up to end. Leaves
+   0 to i0 - 1 and -i2 to -1 are a full leaf, i0 to i0 + i1 - 1 a pair of
+   half leaves. With VL == 1 each position has leaf_N indexes, so a range
+   is written at its own place of the table. */
+static void
+ffts_init_is_range(void *arg, size_t begin, size_t end)
 {
-    int i, i0, i1, i2;
+    const ffts_is_range_t *range = (const ffts_is_range_t*) arg;
+    size_t N = range->N, leaf_N = range->leaf_N;
+    int VL = range->VL;
     int stride = ffts_ctzl(N/leaf_N);
-    ptrdiff_t *is, *pis;
-
-    is = malloc(N / VL * sizeof(*is));
-    if (!is) {
-        return NULL;
-    }
+    int i, i0, i1, n_leaves = (int) (N/leaf_N);
+    int32_t *pis;
 
-    i0 = N/leaf_N/3 + 1;
-    i1 = i2 = N/leaf_N/3;
-    if ((N/leaf_N) % 3 > 1) {
+    i0 = n_leaves/3 + 1;
+    i1 = n_leaves/3;
+    if (n_leaves % 3 > 1) {
         i1++;
     }
 
-    pis = is;
+    pis = range->is + begin * leaf_N / VL;
 
+    for (i = (int) begin; i < (int) end; i++) {
 #if LEAF_N == 8
-    for (i = 0; i < i0; i++) {
-        ffts_hardcodedleaf_is_rec_even8(
-            &pis, N, i, stride, VL);
+        if (i < i0) {
+            ffts_hardcodedleaf_is_rec_even8(
+                &pis, N, i, stride, VL);
+        } else if (i < i0 + i1) {
+            ffts_hardcodedleaf_is_rec_even4(
+                &pis, N, i, stride + 1, VL);
+            ffts_hardcodedleaf_is_rec_even4(
+                &pis, N, i - (1 << stride), stride + 1, VL);
+        } else {
+            ffts_hardcodedleaf_is_rec_even8(
+                &pis, N, i - n_leaves, stride, VL);
+        }
+#else
+        if (i < i0) {
+            ffts_hardcodedleaf_is_rec_even(
+                &pis, N, leaf_N, i, stride, VL);
+        } else if (i < i0 + i1) {
+            ffts_hardcodedleaf_is_rec_even(
+                &pis, N, leaf_N / 2, i, stride + 1, VL);
+            ffts_hardcodedleaf_is_rec_even(
+                &pis, N, leaf_N / 2, i - (1 << stride), stride + 1, VL);
+        } else {
+            ffts_hardcodedleaf_is_rec_even(
+                &pis, N, leaf_N, i - n_leaves, stride, VL);
+        }
+#endif
     }
+}
 
-    for (i = i0; i < i0 + i1; i++) {
-        ffts_hardcodedleaf_is_rec_even4(
-            &pis, N, i, stride + 1, VL);
-        ffts_hardcodedleaf_is_rec_even4(
-            &pis, N, i - (1 << stride), stride + 1, VL);
-    }
+static int32_t*
+ffts_init_is(size_t N, size_t leaf_N, int VL, size_t n_threads)
+{
+    ffts_is_range_t range;
 
-    for (i = 0 - i2; i < 0; i++) {
-        ffts_hardcodedleaf_is_rec_even8(
-            &pis, N, i, stride, VL);
-    }
-#else
-    for (i = 0; i < i0; i++) {
-        ffts_hardcodedleaf_is_rec_even(
-            &pis, N, leaf_N, i, stride, VL);
+    range.is = malloc(N / VL * sizeof(*range.is));
+    if (!range.is) {
+        return NULL;
     }
 
-    for (i = i0; i < i0 + i1; i++) {
-        ffts_hardcodedleaf_is_rec_even(
-            &pis, N, leaf_N / 2, i, stride + 1, VL);
-        ffts_hardcodedleaf_is_rec_even(
-            &pis, N, leaf_N / 2, i - (1 << stride), stride + 1, VL);
-    }
+    range.N = N;
+    range.leaf_N = leaf_N;
+    range.VL = VL;
 
-    for (i = 0 - i2; i < 0; i++) {
-        ffts_hardcodedleaf_is_rec_even(
-            &pis, N, leaf_N, i, stride, VL);
+    /* with wider vectors the leaves skip some of their indexes */
+    if (VL != 1) {
+        n_threads = 1;
     }
-#endif
 
-    return is;
+    ffts_parallel_for(N/leaf_N, n_threads, ffts_init_is_range, &range);
+    return range.is;
 }
 
-static ptrdiff_t*
+static int32_t*
 ffts_init_offsets(size_t N, size_t leaf_N)
 {
-    ptrdiff_t *offsets, *tmp;
-    size_t i;
+    int32_t *offsets;
 
     offsets = malloc(N/leaf_N * sizeof(*offsets));
     if (!offsets) {
         return NULL;
     }
 
-    tmp = malloc(2 * N/leaf_N * sizeof(*tmp));
-    if (!tmp) {
-        free(offsets);
-        return NULL;
-    }
-
 #if LEAF_N == 8
-    ffts_elaborate_offsets_even8(tmp, ffts_ctzl(N));
+    (void) leaf_N;
+    ffts_elaborate_offsets_even8(offsets, ffts_ctzl(N));
 #else
-    ffts_elaborate_offsets_even(tmp, leaf_N, N, 0, 0, 1);
+    ffts_elaborate_offsets_even(offsets, (int) (N/leaf_N), leaf_N, N, 0, 0, 1);
 #endif
 
-    for (i = 0; i < 2*N/leaf_N; i += 2) {
-        if (tmp[i] < 0) {
-            tmp[i] += N;
-        }
-    }
-
-    qsort(tmp, N/leaf_N, 2 * sizeof(*tmp), ffts_compare_offsets);
-
-    for (i = 0; i < N/leaf_N; i++) {
-        offsets[i] = 2 * tmp[2*i + 1];
-    }
-
-    free(tmp);
     return offsets;
 }
 
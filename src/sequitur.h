@@ -31,11 +31,45 @@
 
 */
 
+#ifndef FFTS_SEQUITUR_H
+#define FFTS_SEQUITUR_H
+
+#if defined (_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stddef.h>
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+/* Sequitur grammar inference of a sequence of symbols placed at offsets.
+
+   Two symbols form the same digram when their values and the distance
+   between their offsets are equal, so repeats of a sequence at another
+   place of the output are found. Every repeated digram is replaced by a
+   rule, and rules used only once are expanded again. The offsets of the
+   symbols of a rule are relative to its first symbol, a nonterminal has
+   the offset where its rule is applied.
+
+   C. G. Nevill-Manning, I. H. Witten, Identifying Hierarchical Structure
+   in Sequences: A linear-time algorithm, JAIR 7 (1997), pp. 67-82. */
+
 typedef struct _sym_t {
     int c;
     struct _sym_t *pPrev, *pNext;
     struct _seq_rule_t *r;
     int offset;
+
+    /* rule holding the symbol and the next digram of the same bucket,
+       valid while the grammar is built */
+    struct _seq_rule_t *owner;
+    struct _sym_t *pHash;
 } sym_t;
 
 typedef struct _seq_rule_t {
@@ -43,143 +77,133 @@ typedef struct _seq_rule_t {
     sym_t *ss;
     struct _seq_rule_t *pPrev, *pNext;
     int count;
-    int length;
-} seq_rule_t;
 
-void sym_tail_insert(sym_t **ss, sym_t *s)
-{
-    if (!*ss) {
-        *ss = s;
-        s->pPrev = s->pNext = NULL;
-    } else {
-        while (*ss) {
-            s->pPrev = *ss;
-            ss = &(*ss)->pNext;
-        }
+    /* free for the user of the grammar */
+    void *data;
+} seq_rule_t;
 
-        *ss = s;
-    }
-}
+/* symbols and rules are carved from blocks freed together */
+#define SEQ_ARENA_BLOCK_SIZE 4096
 
-sym_t* sym_init(int c)
-{
-    sym_t *s;
+/* buckets of the digram index */
+#define SEQ_DIGRAM_BUCKETS 256
 
-    s = (sym_t*) malloc(sizeof(*s));
-    if (!s) {
-        return NULL;
-    }
+typedef struct _seq_arena_block_t {
+    struct _seq_arena_block_t *next;
+    size_t used;
+} seq_arena_block_t;
 
-    s->c = c;
-    s->pPrev = s->pNext = NULL;
-    s->r = NULL;
+#define SEQ_ARENA_HEADER_SIZE \
+    ((sizeof(seq_arena_block_t) + sizeof(void*) - 1) & ~(sizeof(void*) - 1))
 
-    return s;
-}
+typedef struct _seq_grammar_t {
+    seq_arena_block_t *blocks;
+    sym_t *free_syms;
+    sym_t *tail;
+    int next_rule;
+    int error;
 
-sym_t* sym_init_from_sym(sym_t *s2)
-{
-    sym_t *s;
+    /* the first symbol of one occurrence of each digram */
+    sym_t *digrams[SEQ_DIGRAM_BUCKETS];
 
-    s = (sym_t*) malloc(sizeof(*s));
-    if (!s) {
-        return NULL;
-    }
+    /* the sequence itself, the other rules follow it */
+    seq_rule_t G;
+} seq_grammar_t;
 
-    s->c = s2->c;
-    s->pPrev = s->pNext = NULL;
-    s->r = s2->r;
-    s->offset = s2->offset;
+static void*
+seq_arena_alloc(seq_grammar_t *g, size_t size)
+{
+    seq_arena_block_t *block = g->blocks;
+    void *ptr;
 
-    return s;
-}
+    size = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
 
-seq_rule_t* seq_init_rule(int c)
-{
-    seq_rule_t *G;
+    if (!block || block->used + size > SEQ_ARENA_BLOCK_SIZE) {
+        block = (seq_arena_block_t*) malloc(SEQ_ARENA_BLOCK_SIZE);
+        if (!block) {
+            g->error = 1;
+            return NULL;
+        }
 
-    G = (seq_rule_t *)malloc(sizeof(*G));
-    if (!G) {
-        return NULL;
+        block->next = g->blocks;
+        block->used = SEQ_ARENA_HEADER_SIZE;
+        g->blocks = block;
     }
 
-    G->c = c;
-    G->count = 2;
-    G->ss = NULL;
-    G->pPrev = NULL;
-    G->pNext = NULL;
-
-    return G;
+    ptr = (char*) block + block->used;
+    block->used += size;
+    return ptr;
 }
 
-seq_rule_t* seq_grammer_insert_new_rule(seq_rule_t *G, char r, sym_t *a, sym_t *b)
+static void
+seq_grammar_init(seq_grammar_t *g)
 {
-    sym_t *sa, *sb;
-
-    while (G->pNext) {
-        G = G->pNext;
-    }
-
-    G->pNext = seq_init_rule(r);
-    if (!G->pNext) {
-        return NULL;
-    }
-
-    sa = sym_init_from_sym(a);
-    if (!sa) {
-        goto cleanup_pnext;
-    }
+    g->blocks = NULL;
+    g->free_syms = NULL;
+    g->tail = NULL;
+    g->next_rule = -1;
+    g->error = 0;
+
+    memset(g->digrams, 0, sizeof(g->digrams));
+
+    g->G.c = 0;
+    g->G.ss = NULL;
+    g->G.pPrev = g->G.pNext = NULL;
+    g->G.count = 1;
+    g->G.data = NULL;
+}
 
-    sb = sym_init_from_sym(b);
-    if (!sb) {
-        goto cleanup_sa;
+static void
+seq_grammar_free(seq_grammar_t *g)
+{
+    while (g->blocks) {
+        seq_arena_block_t *next = g->blocks->next;
+        free(g->blocks);
+        g->blocks = next;
     }
-
-    sb->offset = sb->offset - sa->offset;
-    sa->offset = 0;
-    sym_tail_insert(&G->pNext->ss, sa);
-    sym_tail_insert(&G->pNext->ss, sb);
-    return G->pNext;
-
-cleanup_sa:
-    free(sa);
-
-cleanup_pnext:
-    free(G->pNext);
-    G->pNext = NULL;
-
-    return NULL;
 }
 
-sym_t* sym_match_digram(sym_t *s, sym_t *term, sym_t *a, sym_t *b)
+static sym_t*
+sym_init(seq_grammar_t *g, int c, int offset, seq_rule_t *r)
 {
-    while (s != term) {
-        if (s->c == a->c && s->pNext->c == b->c &&
-                s->pNext->offset - s->offset == b->offset-a->offset) {
-            return s;
+    sym_t *s = g->free_syms;
+
+    if (s) {
+        g->free_syms = s->pNext;
+    } else {
+        s = (sym_t*) seq_arena_alloc(g, sizeof(*s));
+        if (!s) {
+            return NULL;
         }
+    }
 
-        s = s->pNext;
+    s->c = c;
+    s->pPrev = s->pNext = NULL;
+    s->r = r;
+    s->offset = offset;
+    s->owner = NULL;
+    s->pHash = NULL;
+
+    if (r) {
+        r->count++;
     }
 
-    return NULL;
+    return s;
 }
 
-seq_rule_t* seq_match_digram(seq_rule_t *R, sym_t *a, sym_t *b)
+static void
+sym_free(seq_grammar_t *g, sym_t *s)
 {
-    while (R) {
-        if (R->ss->c == a->c && R->ss->pNext->c == b->c &&
-                R->ss->pNext->offset - R->ss->offset == b->offset - a->offset) {
-            return R;
-        }
-
-        R = R->pNext;
+    if (s->r) {
+        s->r->count--;
     }
 
-    return NULL;
+    s->pNext = g->free_syms;
+    g->free_syms = s;
 }
 
-sym_t* sym_tail(sym_t *s)
+static sym_t*
+sym_tail(sym_t *s)
 {
     while (s->pNext) {
         s = s->pNext;
@@ -188,7 +212,8 @@ sym_t* sym_tail(sym_t *s)
     return s;
 }
 
-int sym_count(sym_t *s)
+static int
+sym_count(const sym_t *s)
 {
     int count = 0;
 
@@ -200,13 +225,15 @@ int sym_count(sym_t *s)
     return count;
 }
 
-sym_t* sym_copylist(sym_t *s)
+/* copy of the list with the offsets moved by delta */
+static sym_t*
+sym_copylist(seq_grammar_t *g, const sym_t *s, int delta)
 {
     sym_t *head = NULL;
-    sym_t *prev = head;
+    sym_t *prev = NULL;
 
     while (s) {
-        sym_t *copy = sym_init_from_sym(s);
+        sym_t *copy = sym_init(g, s->c, s->offset + delta, s->r);
         if (!copy) {
             return NULL;
         }
@@ -215,9 +242,7 @@ sym_t* sym_copylist(sym_t *s)
 
         if (prev) {
             prev->pNext = copy;
-        }
-
-        if (!head) {
+        } else {
             head = copy;
         }
 
@@ -228,221 +253,338 @@ sym_t* sym_copylist(sym_t *s)
     return head;
 }
 
-void seq_enforce_uniqueness(seq_rule_t *G)
+/* replace s by the list from head, s is freed by the caller */
+static void
+sym_replace(seq_rule_t *owner, sym_t *s, sym_t *head)
 {
-    seq_rule_t *R = G;//->pNext;
-    seq_rule_t **ppr = &G->pNext;
+    sym_t *tail = sym_tail(head);
 
-    while (R) {
-        if (R == G || R->count > 1) {
-            sym_t *s = R->ss;
-            sym_t **pp = &R->ss;
+    head->pPrev = s->pPrev;
+    tail->pNext = s->pNext;
 
-            while (s) {
-                if (s->r && s->r->count == 1) {
-                    sym_t *temp_itr;
+    if (s->pPrev) {
+        s->pPrev->pNext = head;
+    } else {
+        owner->ss = head;
+    }
 
-                    *pp = s->r->ss;
+    if (s->pNext) {
+        s->pNext->pPrev = tail;
+    }
+}
 
-                    temp_itr = s->r->ss;
-                    while (temp_itr) {
-                        temp_itr->offset += s->offset;
-                        temp_itr = temp_itr->pNext;
-                    }
+static seq_rule_t*
+seq_init_rule(seq_grammar_t *g)
+{
+    seq_rule_t *R;
 
-                    s->r->ss->pPrev = s->pPrev;
-                    if (s->pNext) {
-                        s->pNext->pPrev = sym_tail(s->r->ss);
-                    }
+    R = (seq_rule_t*) seq_arena_alloc(g, sizeof(*R));
+    if (!R) {
+        return NULL;
+    }
 
-                    sym_tail(s->r->ss)->pNext = s->pNext;
-                    s = s->r->ss;
-                    continue;
-                }
+    R->c = g->next_rule--;
+    R->ss = NULL;
+    R->count = 0;
+    R->data = NULL;
 
-                pp = &s->pNext;
-                s = s->pNext;
-            }
+    /* after the sequence */
+    R->pPrev = &g->G;
+    R->pNext = g->G.pNext;
+    if (R->pNext) {
+        R->pNext->pPrev = R;
+    }
 
-            ppr = &R->pNext;
-        } else {
-            *ppr = R->pNext;
-        }
+    g->G.pNext = R;
+    return R;
+}
 
-        R = R->pNext;
+static void
+seq_remove_rule(seq_rule_t *R)
+{
+    R->pPrev->pNext = R->pNext;
+    if (R->pNext) {
+        R->pNext->pPrev = R->pPrev;
     }
 }
 
-void seq_merge_small_rules(seq_rule_t *G, int thresh)
+/* new rule holding the digram a, b with offsets relative to a */
+static seq_rule_t*
+seq_grammer_insert_new_rule(seq_grammar_t *g, const sym_t *a, const sym_t *b)
 {
-    seq_rule_t *R = G;
+    seq_rule_t *R;
+    sym_t *sa, *sb;
+
+    R = seq_init_rule(g);
+    if (!R) {
+        return NULL;
+    }
 
-    while (R) {
-        if (sym_count(R->ss) <= thresh) {
-            //printf("count %d > %d for %d\n", sym_count(R->ss), thresh, R->c);
-            sym_t *s = R->ss;
-            sym_t **pp = &R->ss;
+    sa = sym_init(g, a->c, 0, a->r);
+    sb = sym_init(g, b->c, b->offset - a->offset, b->r);
+    if (!sa || !sb) {
+        return NULL;
+    }
 
-            while (s) {
-                if (s->r) {
-                    sym_t *copylist;
-                    sym_t *copylist_itr;
+    sa->pNext = sb;
+    sb->pPrev = sa;
+    sa->owner = sb->owner = R;
+    R->ss = sa;
 
-                    s->r->count--;
+    return R;
+}
 
-                    copylist = sym_copylist(s->r->ss);
-                    if (!copylist) {
-                        return;
-                    }
+static int
+sym_match_digram(const sym_t *s, const sym_t *a)
+{
+    return s->c == a->c && s->pNext->c == a->pNext->c &&
+        s->pNext->offset - s->offset == a->pNext->offset - a->offset;
+}
 
-                    copylist_itr = copylist;
-                    while (copylist_itr) {
-                        copylist_itr->offset += s->offset;
-                        copylist_itr = copylist_itr->pNext;
-                    }
+static sym_t**
+seq_digram_bucket(seq_grammar_t *g, const sym_t *a)
+{
+    unsigned int h;
 
-                    *pp = copylist;
-                    copylist->pPrev = s->pPrev;
-                    if (s->pNext) {
-                        s->pNext->pPrev = sym_tail(copylist);
-                    }
+    h = (unsigned int) a->c * 31u + (unsigned int) a->pNext->c;
+    h = h * 31u + (unsigned int) (a->pNext->offset - a->offset);
+    h ^= h >> 15;
 
-                    sym_tail(copylist)->pNext = s->pNext;
-                    pp = &(sym_tail(copylist)->pNext);
-                    s = sym_tail(copylist)->pNext;
-                    continue;
-                }
+    return &g->digrams[(h * 2654435761u >> 16) & (SEQ_DIGRAM_BUCKETS - 1)];
+}
 
-                pp = &s->pNext;
-                s = s->pNext;
-            }
+/* the occurrence of the digram starting at a in the index, if any */
+static sym_t*
+seq_match_digram(seq_grammar_t *g, const sym_t *a)
+{
+    sym_t *s;
+
+    for (s = *seq_digram_bucket(g, a); s; s = s->pHash) {
+        if (sym_match_digram(s, a)) {
+            return s;
         }
+    }
 
-        R = R->pNext;
+    return NULL;
+}
+
+/* drop the digram starting at a from the index, before it is changed */
+static void
+seq_digram_delete(seq_grammar_t *g, sym_t *a)
+{
+    sym_t **ps;
+
+    if (!a || !a->pNext) {
+        return;
     }
 
-    seq_enforce_uniqueness(G);
+    for (ps = seq_digram_bucket(g, a); *ps; ps = &(*ps)->pHash) {
+        if (*ps == a) {
+            *ps = a->pHash;
+            return;
+        }
+    }
 }
 
-void seq_extract_hierarchy(seq_rule_t *G)
+static int
+seq_check_digram(seq_grammar_t *g, sym_t *a);
+
+/* replace the digram starting at a by a nonterminal of R */
+static void
+seq_substitute(seq_grammar_t *g, sym_t *a, seq_rule_t *R)
 {
-    int next_rule = -2;
-    sym_t *cursym = G->ss;
-
-    while (cursym) {
-        sym_t *m = NULL;
-        seq_rule_t *mr = NULL;
-
-        if (cursym->pPrev && cursym->pPrev->pPrev) {
-            mr = seq_match_digram(G->pNext, cursym->pPrev, cursym);
-            if (mr) {
-                if (cursym->pPrev->r) {
-                    cursym->pPrev->r->count--;
-                }
+    seq_rule_t *owner = a->owner;
+    sym_t *b = a->pNext;
+    sym_t *n;
 
-                if(cursym->r) {
-                    cursym->r->count--;
-                }
+    n = sym_init(g, R->c, a->offset, R);
+    if (!n) {
+        return;
+    }
 
-                mr->count++;
+    seq_digram_delete(g, a->pPrev);
+    seq_digram_delete(g, a);
+    seq_digram_delete(g, b);
 
-                cursym->pPrev->r = mr;
-                cursym->pPrev->c = mr->c;
-                cursym->pPrev->pNext = cursym->pNext;
-                cursym->pNext->pPrev = cursym->pPrev;
-                cursym = cursym->pPrev;
-            }
+    n->owner = owner;
+    n->pPrev = a->pPrev;
+    n->pNext = b->pNext;
 
-            m = sym_match_digram(G->ss, cursym->pPrev->pPrev, cursym->pPrev, cursym);
-            if (m) {
-                seq_rule_t *newr;
+    if (a->pPrev) {
+        a->pPrev->pNext = n;
+    } else {
+        owner->ss = n;
+    }
 
-                if (cursym->pPrev->r) {
-                    cursym->pPrev->r->count--;
-                }
+    if (b->pNext) {
+        b->pNext->pPrev = n;
+    } else if (g->tail == b) {
+        g->tail = n;
+    }
 
-                if (cursym->r) {
-                    cursym->r->count--;
-                }
+    sym_free(g, a);
+    sym_free(g, b);
 
-                newr = seq_grammer_insert_new_rule(G, next_rule, m, m->pNext);
-                if (!newr) {
-                    return;
-                }
+    /* the nonterminal forms new digrams with its neighbours */
+    if (!n->pPrev || !seq_check_digram(g, n->pPrev)) {
+        seq_check_digram(g, n);
+    }
+}
 
-                m->r = newr;
-                m->c = next_rule;
-                m->pNext = m->pNext->pNext;
-                m->pNext->pPrev = m;
+/* keep every digram unique, returns non-zero when a was replaced */
+static int
+seq_check_digram(seq_grammar_t *g, sym_t *a)
+{
+    seq_rule_t *R;
+    sym_t *m;
 
-                cursym->pPrev->r = newr;
-                cursym->pPrev->c = next_rule;
-                cursym->pPrev->pNext = cursym->pNext;
-                cursym->pNext->pPrev = cursym->pPrev;
-                cursym = cursym->pPrev;
+    if (g->error || !a->pNext) {
+        return 0;
+    }
 
-                next_rule--;
-            }
-        }
+    m = seq_match_digram(g, a);
+    if (!m) {
+        sym_t **bucket = seq_digram_bucket(g, a);
+
+        a->pHash = *bucket;
+        *bucket = a;
+        return 0;
+    }
+
+    /* the same or an overlapping occurrence */
+    if (m == a || m->pNext == a || a->pNext == m) {
+        return 0;
+    }
 
-        if (!m && !mr) {
-            cursym = cursym->pNext;
+    R = m->owner;
+    if (R != &g->G && m == R->ss && !m->pNext->pNext) {
+        /* the digram is a complete rule */
+        seq_substitute(g, a, R);
+    } else {
+        R = seq_grammer_insert_new_rule(g, m, m->pNext);
+        if (!R) {
+            return 0;
         }
+
+        seq_substitute(g, m, R);
+        seq_substitute(g, a, R);
+
+        /* the rule is the only occurrence left */
+        seq_check_digram(g, R->ss);
     }
 
-    seq_enforce_uniqueness(G);
-    seq_merge_small_rules(G, 2);
-//	seq_enforce_uniqueness(G);
+    return 1;
 }
 
-void seq_compute_lengths(seq_rule_t *G)
+/* append a symbol to the sequence */
+static int
+seq_append(seq_grammar_t *g, int c, int offset)
 {
-    seq_rule_t *R = G->pNext;
     sym_t *s;
-    int sum;
 
-    while (R) {
-        sum = 0;
+    s = sym_init(g, c, offset, NULL);
+    if (!s) {
+        return -1;
+    }
+
+    s->owner = &g->G;
+
+    if (g->tail) {
+        g->tail->pNext = s;
+        s->pPrev = g->tail;
+        g->tail = s;
+        seq_check_digram(g, s->pPrev);
+    } else {
+        g->G.ss = g->tail = s;
+    }
+
+    return g->error ? -1 : 0;
+}
+
+/* expand the rules used only once */
+static void
+seq_enforce_uniqueness(seq_grammar_t *g)
+{
+    seq_rule_t *R;
+    sym_t *s;
+
+    for (R = &g->G; R; R = R->pNext) {
         s = R->ss;
 
         while (s) {
-            if (s->c >= 0) {
-                if (s->offset + s->c > sum) {
-                    sum = s->offset + s->c;
-                }
-            }
+            seq_rule_t *r = s->r;
+
+            if (r && r->count == 1) {
+                sym_t *t, *head = r->ss;
 
-            if (s->c < 0) {
-                if (s->offset + s->r->length > sum) {
-                    sum = s->offset + s->r->length;
+                for (t = head; t; t = t->pNext) {
+                    t->offset += s->offset;
                 }
+
+                sym_replace(R, s, head);
+                sym_free(g, s);
+                seq_remove_rule(r);
+
+                /* the expanded symbols may use such rules as well */
+                s = head;
+                continue;
             }
 
             s = s->pNext;
         }
+    }
+}
 
-        R->length = sum;
-        R = R->pNext;
+/* expand the rules of at most thresh symbols everywhere they are used */
+static void
+seq_merge_small_rules(seq_grammar_t *g, int thresh)
+{
+    seq_rule_t *R;
+    sym_t *s;
+
+    /* every rule has at least two symbols */
+    if (thresh < 2) {
+        return;
     }
 
-    sum = 0;
-    s = G->ss;
+    for (R = &g->G; R; R = R->pNext) {
+        s = R->ss;
 
-    while (s) {
-        if (s->c >= 0) {
-            if (s->offset + s->c > sum) {
-                sum = s->offset + s->c;
-            }
-        }
+        while (s) {
+            seq_rule_t *r = s->r;
+
+            if (r && sym_count(r->ss) <= thresh) {
+                sym_t *head = sym_copylist(g, r->ss, s->offset);
+                if (!head) {
+                    return;
+                }
+
+                sym_replace(R, s, head);
+                sym_free(g, s);
 
-        if (s->c < 0) {
-            if (s->offset + s->r->length > sum) {
-                sum = s->offset + s->r->length;
+                /* the last use is gone, so are the uses of its symbols */
+                if (!r->count) {
+                    sym_t *t = r->ss;
+
+                    while (t) {
+                        sym_t *next = t->pNext;
+                        sym_free(g, t);
+                        t = next;
+                    }
+
+                    seq_remove_rule(r);
+                }
+
+                s = head;
+                continue;
             }
-        }
 
-        s = s->pNext;
+            s = s->pNext;
+        }
     }
 
-    G->length = sum;
-}
\ No newline at end of file
+    /* rules used by the small ones may be left with a single use */
+    seq_enforce_uniqueness(g);
+}
+
+#endif /* FFTS_SEQUITUR_H */
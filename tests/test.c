@@ -41,7 +41,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
 
 #ifndef M_PI
 #define M_PI 3.1415926535897932384626433832795028841971693993751058209
@@ -96,9 +98,670 @@ static float impulse_error(int N, int sign, float *data)
 #endif
 }
 
+/* relative error of a transform against the reference above which a check
+   fails, a few times that of the largest sizes tested */
+#define TEST_TOLERANCE 1e-5
+
+static int checks, failures;
+
+static void check(const char *name, size_t n, double error)
+{
+    checks++;
+
+    if (!(error <= TEST_TOLERANCE)) {
+        printf("FAILED %s, size %lu: error %E\n", name, (unsigned long) n, error);
+        failures++;
+    }
+}
+
+static float *test_malloc(size_t n)
+{
+#ifdef HAVE_SSE
+    return (float*) _mm_malloc(n * sizeof(float), 32);
+#else
+    return (float*) valloc(n * sizeof(float));
+#endif
+}
+
+static void test_free(float *data)
+{
+#ifdef HAVE_SSE
+    _mm_free(data);
+#else
+    free(data);
+#endif
+}
+
+/* n floats in [-1, 1) without symmetries, the same for a seed */
+static void test_signal(float *data, size_t n, unsigned int seed)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (float) ((seed >> 16) & 0x7fff) / 16384.0f - 1.0f;
+    }
+}
+
+/* the transform of n complex values a stride apart by its definition,
+   in place */
+static void reference_dft(double *data, size_t n, size_t stride, int sign)
+{
+    double *w = (double*) malloc(4 * n * sizeof(double));
+    double *x = w + 2 * n;
+    size_t j, k;
+
+    for (j = 0; j < n; j++) {
+        w[2 * j + 0] = cos(2 * M_PI * (double) j / (double) n);
+        w[2 * j + 1] = sign * sin(2 * M_PI * (double) j / (double) n);
+        x[2 * j + 0] = data[2 * j * stride + 0];
+        x[2 * j + 1] = data[2 * j * stride + 1];
+    }
+
+    for (k = 0; k < n; k++) {
+        double re = 0.0, im = 0.0;
+
+        for (j = 0; j < n; j++) {
+            const double *wjk = w + 2 * ((j * k) % n);
+
+            re += x[2 * j] * wjk[0] - x[2 * j + 1] * wjk[1];
+            im += x[2 * j] * wjk[1] + x[2 * j + 1] * wjk[0];
+        }
+
+        data[2 * k * stride + 0] = re;
+        data[2 * k * stride + 1] = im;
+    }
+
+    free(w);
+}
+
+/* the transform of a row-major array of complex values, in place */
+static void reference_dft_nd(double *data, int rank, const size_t *Ns, int sign)
+{
+    size_t vol = 1, stride, i, j;
+    int d;
+
+    for (d = 0; d < rank; d++) {
+        vol *= Ns[d];
+    }
+
+    for (d = 0, stride = vol; d < rank; d++) {
+        stride /= Ns[d];
+
+        for (i = 0; i < vol; i += stride * Ns[d]) {
+            for (j = 0; j < stride; j++) {
+                reference_dft(data + 2 * (i + j), Ns[d], stride, sign);
+            }
+        }
+    }
+}
+
+/* relative L2 error of n floats against the reference */
+static double relative_error(const float *data, const double *ref, size_t n)
+{
+    double delta_sum = 0.0, sum = 0.0;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        delta_sum += (ref[i] - data[i]) * (ref[i] - data[i]);
+        sum += ref[i] * ref[i];
+    }
+
+    return sqrt(delta_sum) / sqrt(sum);
+}
+
+/* n complex values and their transform, a random signal checked against
+   the reference up to 4096 points and an impulse above */
+static void test_input(float *input, double *ref, size_t n, int sign)
+{
+    size_t i;
+
+    if (n <= 4096) {
+        test_signal(input, 2 * n, (unsigned int) n);
+
+        for (i = 0; i < 2 * n; i++) {
+            ref[i] = input[i];
+        }
+
+        reference_dft(ref, n, 1, sign);
+    } else {
+        memset(input, 0, 2 * n * sizeof(float));
+        input[2] = 1.0f;
+
+        for (i = 0; i < n; i++) {
+            ref[2 * i + 0] = cos(2 * M_PI * (double) i / (double) n);
+            ref[2 * i + 1] = sign * sin(2 * M_PI * (double) i / (double) n);
+        }
+    }
+}
+
+/* the error of one execution of a complex plan on the input of test_input,
+   1 if there is no plan */
+static double plan_error(ffts_plan_t *p, size_t n, int sign)
+{
+    float *input, *output;
+    double *ref, error;
+
+    if (!p) {
+        return 1.0;
+    }
+
+    input = test_malloc(2 * n);
+    output = test_malloc(2 * n);
+    ref = (double*) malloc(2 * n * sizeof(double));
+
+    test_input(input, ref, n, sign);
+    ffts_execute(p, input, output);
+    error = relative_error(output, ref, 2 * n);
+
+    free(ref);
+    test_free(output);
+    test_free(input);
+    return error;
+}
+
+/* a plan of ffts_init_1d_flags against the reference */
+static void test_flags(const char *name, size_t n, int sign, unsigned int flags)
+{
+    ffts_plan_t *p = ffts_init_1d_flags(n, sign, flags);
+
+    check(name, n, plan_error(p, n, sign));
+    ffts_free(p);
+}
+
+/* the plan scaled by ffts_set_scale against the reference, then unscaled
+   again */
+static void test_scale(const char *name, ffts_plan_t *p, int rank,
+                       const size_t *Ns, int sign)
+{
+    float *input, *output;
+    double *ref, error = 1.0;
+    size_t n = 1, i;
+    int d;
+
+    for (d = 0; d < rank; d++) {
+        n *= Ns[d];
+    }
+
+    if (!p || ffts_set_scale(p, 0.25f)) {
+        check(name, n, error);
+        ffts_free(p);
+        return;
+    }
+
+    input = test_malloc(2 * n);
+    output = test_malloc(2 * n);
+    ref = (double*) malloc(2 * n * sizeof(double));
+
+    test_signal(input, 2 * n, (unsigned int) n);
+
+    for (i = 0; i < 2 * n; i++) {
+        ref[i] = input[i];
+    }
+
+    reference_dft_nd(ref, rank, Ns, sign);
+
+    for (i = 0; i < 2 * n; i++) {
+        ref[i] *= 0.25;
+    }
+
+    ffts_execute(p, input, output);
+    error = relative_error(output, ref, 2 * n);
+
+    if (!ffts_set_scale(p, 1.0f)) {
+        for (i = 0; i < 2 * n; i++) {
+            ref[i] *= 4.0;
+        }
+
+        ffts_execute(p, input, output);
+        if (relative_error(output, ref, 2 * n) > error) {
+            error = relative_error(output, ref, 2 * n);
+        }
+    } else {
+        error = 1.0;
+    }
+
+    check(name, n, error);
+
+    free(ref);
+    test_free(output);
+    test_free(input);
+    ffts_free(p);
+}
+
+/* a plan for both directions executed forward, backward and by
+   ffts_execute, which runs it forward */
+static void test_both(const char *name, size_t n, unsigned int flags)
+{
+    ffts_plan_t *p = ffts_init_1d_flags(n, 0, flags);
+    float *input, *output;
+    double *ref, dir_error, error = 1.0;
+    int sign;
+
+    input = test_malloc(2 * n);
+    output = test_malloc(2 * n);
+    ref = (double*) malloc(2 * n * sizeof(double));
+
+    if (p) {
+        error = plan_error(p, n, -1);
+
+        for (sign = -1; sign <= 1; sign += 2) {
+            dir_error = 1.0;
+            test_input(input, ref, n, sign);
+
+            if (!ffts_execute_dir(p, input, output, sign)) {
+                dir_error = relative_error(output, ref, 2 * n);
+            }
+
+            if (dir_error > error) {
+                error = dir_error;
+            }
+        }
+    }
+
+    check(name, n, error);
+
+    free(ref);
+    test_free(output);
+    test_free(input);
+    ffts_free(p);
+}
+
+/* the straight-line code of ffts_execute_small against the reference */
+static void test_small(size_t n, int sign)
+{
+    float *input = test_malloc(2 * n);
+    float *output = test_malloc(2 * n);
+    double *ref = (double*) malloc(2 * n * sizeof(double));
+    double error = 1.0;
+
+    test_input(input, ref, n, sign);
+
+    if (!ffts_execute_small(n, sign, input, output)) {
+        error = relative_error(output, ref, 2 * n);
+    }
+
+    check("small", n, error);
+
+    free(ref);
+    test_free(output);
+    test_free(input);
+}
+
+/* runs a plan for one direction, or a plan for both in the direction of
+   sign */
+static int test_execute(ffts_plan_t *p, int both, int sign,
+                        const float *input, float *output)
+{
+    if (both) {
+        return ffts_execute_dir(p, input, output, sign);
+    }
+
+    ffts_execute(p, input, output);
+    return 0;
+}
+
+/* the circular convolution of two signals by the forward transforms of
+   both, their pointwise product and the inverse transform, with plans
+   created with FFTS_FLAG_SCRAMBLED, against its definition times n. Large
+   sizes convolve with an impulse at 1, which shifts the signal by one. */
+static void test_scrambled(const char *name, size_t n, int both, unsigned int flags)
+{
+    ffts_plan_t *forward, *inverse;
+    float *x, *y, *X, *Y;
+    double *ref, error = 1.0;
+    size_t i, j;
+
+    flags |= FFTS_FLAG_SCRAMBLED;
+
+    if (both) {
+        forward = inverse = ffts_init_1d_flags(n, 0, flags);
+    } else {
+        forward = ffts_init_1d_flags(n, -1, flags);
+        inverse = ffts_init_1d_flags(n, 1, flags);
+    }
+
+    x = test_malloc(2 * n);
+    y = test_malloc(2 * n);
+    X = test_malloc(2 * n);
+    Y = test_malloc(2 * n);
+    ref = (double*) malloc(2 * n * sizeof(double));
+
+    if (!forward || !inverse) {
+        goto cleanup;
+    }
+
+    test_signal(x, 2 * n, (unsigned int) n);
+
+    if (n <= 4096) {
+        test_signal(y, 2 * n, (unsigned int) n + 1);
+
+        for (i = 0; i < n; i++) {
+            double re = 0.0, im = 0.0;
+
+            for (j = 0; j < n; j++) {
+                const float *a = x + 2 * j;
+                const float *b = y + 2 * ((i + n - j) % n);
+
+                re += (double) a[0] * b[0] - (double) a[1] * b[1];
+                im += (double) a[0] * b[1] + (double) a[1] * b[0];
+            }
+
+            ref[2 * i + 0] = (double) n * re;
+            ref[2 * i + 1] = (double) n * im;
+        }
+    } else {
+        memset(y, 0, 2 * n * sizeof(float));
+        y[2] = 1.0f;
+
+        for (i = 0; i < n; i++) {
+            ref[2 * i + 0] = (double) n * x[2 * ((i + n - 1) % n) + 0];
+            ref[2 * i + 1] = (double) n * x[2 * ((i + n - 1) % n) + 1];
+        }
+    }
+
+    if (test_execute(forward, both, -1, x, X) ||
+            test_execute(forward, both, -1, y, Y)) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < n; i++) {
+        float re = X[2 * i] * Y[2 * i] - X[2 * i + 1] * Y[2 * i + 1];
+        float im = X[2 * i] * Y[2 * i + 1] + X[2 * i + 1] * Y[2 * i];
+
+        X[2 * i + 0] = re;
+        X[2 * i + 1] = im;
+    }
+
+    if (!test_execute(inverse, both, 1, X, x)) {
+        error = relative_error(x, ref, 2 * n);
+    }
+
+cleanup:
+    check(name, n, error);
+
+    free(ref);
+    test_free(Y);
+    test_free(X);
+    test_free(y);
+    test_free(x);
+
+    if (inverse != forward) {
+        ffts_free(inverse);
+    }
+
+    ffts_free(forward);
+}
+
+/* plans of a size share their twiddle tables, which must outlive the
+   first plan freed and be rebuilt after the last */
+static void test_shared_tables(size_t n)
+{
+    ffts_plan_t *p, *q, *r;
+    double error;
+
+    p = ffts_init_1d(n, -1);
+    q = ffts_init_1d(n, -1);
+    r = ffts_init_1d_flags(n, 1, FFTS_FLAG_ENGINE_STATIC);
+    ffts_free(p);
+
+    error = plan_error(q, n, -1);
+    if (plan_error(r, n, 1) > error) {
+        error = plan_error(r, n, 1);
+    }
+
+    ffts_free(r);
+    ffts_free(q);
+
+    p = ffts_init_1d(n, -1);
+    if (plan_error(p, n, -1) > error) {
+        error = plan_error(p, n, -1);
+    }
+
+    ffts_free(p);
+    check("shared tables", n, error);
+}
+
+/* a plan generating its code in the background runs the static transform
+   until the code is ready, each execution must give the transform */
+static void test_background_jit(size_t n, int sign)
+{
+    ffts_plan_t *p;
+    double error, max_error = 0.0;
+    int i;
+
+    p = ffts_init_1d_flags(n, sign, FFTS_FLAG_BACKGROUND_JIT);
+
+    for (i = 0; i < 16; i++) {
+        error = plan_error(p, n, sign);
+        if (error > max_error) {
+            max_error = error;
+        }
+    }
+
+    check("background code generation", n, max_error);
+    ffts_free(p);
+}
+
+/* the load callback reads complex doubles at half gain, the store callback
+   conjugates, and both count the elements they are given */
+typedef struct _test_callbacks_t {
+    size_t loaded;
+    size_t stored;
+} test_callbacks_t;
+
+static void test_load(float *dst, const void *input, size_t index,
+                      size_t count, void *userdata)
+{
+    const double *src = (const double*) input + 2 * index;
+    size_t i;
+
+    for (i = 0; i < 2 * count; i++) {
+        dst[i] = (float) (0.5 * src[i]);
+    }
+
+    ((test_callbacks_t*) userdata)->loaded += count;
+}
+
+static void test_store(float *data, size_t index, size_t count, void *userdata)
+{
+    size_t i;
+
+    (void) index;
+
+    for (i = 0; i < count; i++) {
+        data[2 * i + 1] = -data[2 * i + 1];
+    }
+
+    ((test_callbacks_t*) userdata)->stored += count;
+}
+
+/* a plan of ffts_init_1d_flags with the callbacks above against the
+   reference, each element must be loaded and stored once */
+static void test_callbacks(const char *name, size_t n, int sign, unsigned int flags)
+{
+    test_callbacks_t counts = { 0, 0 };
+    ffts_plan_t *p;
+    float *input, *output;
+    double *ref, *samples;
+    double error = 1.0;
+    size_t i;
+
+    p = ffts_init_1d_flags(n, sign, flags);
+    if (!p || ffts_set_callbacks(p, test_load, test_store, &counts)) {
+        check(name, n, error);
+        ffts_free(p);
+        return;
+    }
+
+    input = test_malloc(2 * n);
+    output = test_malloc(2 * n);
+    ref = (double*) malloc(2 * n * sizeof(double));
+    samples = (double*) malloc(2 * n * sizeof(double));
+
+    test_input(input, ref, n, sign);
+
+    for (i = 0; i < n; i++) {
+        samples[2 * i + 0] = 2.0 * input[2 * i + 0];
+        samples[2 * i + 1] = 2.0 * input[2 * i + 1];
+        ref[2 * i + 1] = -ref[2 * i + 1];
+    }
+
+    ffts_execute(p, samples, output);
+
+    if (counts.loaded == n && counts.stored == n) {
+        error = relative_error(output, ref, 2 * n);
+    }
+
+    check(name, n, error);
+
+    free(samples);
+    free(ref);
+    test_free(output);
+    test_free(input);
+    ffts_free(p);
+}
+
+/* the forward real transform against the reference and the inverse back
+   to the input scaled by n, both plans scaled by scale with
+   ffts_set_scale. Large sizes transform an impulse, whose transform is
+   known without the reference. */
+static void test_real(size_t n, float scale)
+{
+    ffts_plan_t *p;
+    size_t half = n / 2 + 1, i;
+    float *input, *output, *back;
+    double *ref, error;
+
+    input = test_malloc(n);
+    output = test_malloc(2 * half);
+    back = test_malloc(n);
+    ref = (double*) malloc(2 * n * sizeof(double));
+
+    if (n <= 4096) {
+        test_signal(input, n, (unsigned int) n);
+
+        for (i = 0; i < n; i++) {
+            ref[2 * i + 0] = input[i];
+            ref[2 * i + 1] = 0.0;
+        }
+
+        reference_dft(ref, n, 1, -1);
+    } else {
+        memset(input, 0, n * sizeof(float));
+        input[1] = 1.0f;
+
+        for (i = 0; i < half; i++) {
+            ref[2 * i + 0] = cos(2 * M_PI * (double) i / (double) n);
+            ref[2 * i + 1] = -sin(2 * M_PI * (double) i / (double) n);
+        }
+    }
+
+    for (i = 0; i < 2 * half; i++) {
+        ref[i] *= scale;
+    }
+
+    error = 1.0;
+    p = ffts_init_1d_real(n, -1);
+    if (p && (scale == 1.0f || !ffts_set_scale(p, scale))) {
+        ffts_execute(p, input, output);
+        error = relative_error(output, ref, 2 * half);
+    }
+
+    ffts_free(p);
+    check(scale == 1.0f ? "real forward" : "scaled real forward", n, error);
+
+    for (i = 0; i < n; i++) {
+        ref[i] = (double) n * scale * scale * input[i];
+    }
+
+    error = 1.0;
+    p = ffts_init_1d_real(n, 1);
+    if (p && (scale == 1.0f || !ffts_set_scale(p, scale))) {
+        ffts_execute(p, output, back);
+        error = relative_error(back, ref, n);
+    }
+
+    ffts_free(p);
+    check(scale == 1.0f ? "real inverse" : "scaled real inverse", n, error);
+
+    free(ref);
+    test_free(back);
+    test_free(output);
+    test_free(input);
+}
+
+/* the forward 2D real transform against the reference, which is the
+   non-redundant half of the complex transform, and the inverse back to
+   the input scaled by its size, both plans scaled like in test_real */
+static void test_2d_real(size_t N1, size_t N2, float scale)
+{
+    ffts_plan_t *p;
+    size_t Ns[2], vol = N1 * N2, half = N2 / 2 + 1, i, k;
+    double *ref, *half_ref;
+    float *input, *output, *back;
+    double error;
+
+    input = test_malloc(vol);
+    output = test_malloc(2 * N1 * half);
+    back = test_malloc(vol);
+    ref = (double*) malloc(2 * vol * sizeof(double));
+    half_ref = (double*) malloc(2 * N1 * half * sizeof(double));
+
+    test_signal(input, vol, (unsigned int) vol);
+
+    for (i = 0; i < vol; i++) {
+        ref[2 * i + 0] = input[i];
+        ref[2 * i + 1] = 0.0;
+    }
+
+    Ns[0] = N1;
+    Ns[1] = N2;
+    reference_dft_nd(ref, 2, Ns, -1);
+
+    for (i = 0; i < N1; i++) {
+        for (k = 0; k < 2 * half; k++) {
+            half_ref[2 * i * half + k] = scale * ref[2 * i * N2 + k];
+        }
+    }
+
+    error = 1.0;
+    p = ffts_init_2d_real(N1, N2, -1);
+    if (p && (scale == 1.0f || !ffts_set_scale(p, scale))) {
+        ffts_execute(p, input, output);
+        error = relative_error(output, half_ref, 2 * N1 * half);
+    }
+
+    ffts_free(p);
+    check(scale == 1.0f ? "2d real forward" : "scaled 2d real forward",
+        vol, error);
+
+    for (i = 0; i < vol; i++) {
+        ref[i] = (double) vol * scale * scale * input[i];
+    }
+
+    error = 1.0;
+    p = ffts_init_2d_real(N1, N2, 1);
+    if (p && (scale == 1.0f || !ffts_set_scale(p, scale))) {
+        ffts_execute(p, output, back);
+        error = relative_error(back, ref, vol);
+    }
+
+    ffts_free(p);
+    check(scale == 1.0f ? "2d real inverse" : "scaled 2d real inverse",
+        vol, error);
+
+    free(half_ref);
+    free(ref);
+    test_free(back);
+    test_free(output);
+    test_free(input);
+}
+
 int test_transform(int n, int sign)
 {
     ffts_plan_t *p;
+    float error;
 
 #ifdef HAVE_SSE
     float FFTS_ALIGN(32) *input = _mm_malloc(2 * n * sizeof(float), 32);
@@ -123,14 +786,411 @@ int test_transform(int n, int sign)
     }
 
     ffts_execute(p, input, output);
-    printf(" %3d  | %9d | %10E\n", sign, n, impulse_error(n, sign, output));
+    error = impulse_error(n, sign, output);
+    printf(" %3d  | %9d | %10E\n", sign, n, error);
+    check("impulse", n, error);
     ffts_free(p);
+
+#ifdef HAVE_SSE
+    _mm_free(input);
+    _mm_free(output);
+#else
+    free(input);
+    free(output);
+#endif
     return 1;
 }
 
+/* the choices of an engine that was asked for use that engine */
+static int wisdom_engines_kept(const char *wisdom)
+{
+    char engine[16], names[64];
+    unsigned long n;
+    int sign, length;
+
+    wisdom = strchr(wisdom, '\n') + 1;
+    while (sscanf(wisdom, "%lu %d %15s %63s\n%n",
+            &n, &sign, engine, names, &length) == 4) {
+        if ((!strcmp(engine, "jit") && strstr(names, "static")) ||
+                (!strcmp(engine, "static") && strstr(names, "jit"))) {
+            return 0;
+        }
+
+        wisdom += length;
+    }
+
+    return *wisdom == '\0';
+}
+
+static void test_wisdom(void)
+{
+    size_t header, length, size, part;
+    char *wisdom, *buffer;
+    size_t n;
+
+    ffts_forget_wisdom();
+    header = ffts_export_wisdom(NULL, 0);
+
+    for (n = 64; n <= 4096; n *= 4) {
+        test_flags("measure", n, -1, FFTS_FLAG_MEASURE);
+        test_flags("measure", n, 1, FFTS_FLAG_MEASURE);
+        test_flags("measure code generator", n, -1,
+            FFTS_FLAG_MEASURE | FFTS_FLAG_ENGINE_JIT);
+        test_flags("measure static engine", n, 1,
+            FFTS_FLAG_MEASURE | FFTS_FLAG_ENGINE_STATIC);
+    }
+
+    /* the candidates are built with the other flags while timed */
+    test_flags("measure stream", 16384, -1, FFTS_FLAG_MEASURE |
+        FFTS_FLAG_STREAM | FFTS_FLAG_PREFETCH(4) | FFTS_FLAG_BACKGROUND_JIT);
+
+    /* measured again from the wisdom */
+    test_flags("measure", 4096, -1, FFTS_FLAG_MEASURE);
+
+    length = ffts_export_wisdom(NULL, 0);
+    wisdom = (char*) malloc(length + 1);
+    buffer = (char*) malloc(length + 1);
+
+    check("wisdom export", length,
+        ffts_export_wisdom(wisdom, length + 1) == length &&
+        strlen(wisdom) == length && length > header ? 0.0 : 1.0);
+    check("wisdom engines", length, wisdom_engines_kept(wisdom) ? 0.0 : 1.0);
+
+    /* a short buffer holds the lines that fit */
+    for (size = 1; size <= length; size++) {
+        memset(buffer, 'x', length);
+        buffer[length] = '\0';
+
+        n = ffts_export_wisdom(buffer, size);
+        part = strlen(buffer);
+
+        if (n != length || part >= size || strncmp(buffer, wisdom, part) ||
+                (part && (part < header || buffer[part - 1] != '\n'))) {
+            check("wisdom truncated", size, 1.0);
+            break;
+        }
+    }
+
+    ffts_forget_wisdom();
+    check("wisdom forget", 0, ffts_export_wisdom(NULL, 0) == header ? 0.0 : 1.0);
+
+    check("wisdom import", length, !ffts_import_wisdom(wisdom) &&
+        ffts_export_wisdom(buffer, length + 1) == length &&
+        !strcmp(buffer, wisdom) ? 0.0 : 1.0);
+
+    /* measured from the imported wisdom */
+    test_flags("measure", 1024, 1, FFTS_FLAG_MEASURE);
+
+    check("wisdom import version", 0,
+        ffts_import_wisdom("ffts-wisdom-1\n64 -1 2\n") ? 0.0 : 1.0);
+    check("wisdom import name", 0,
+        ffts_import_wisdom("ffts-wisdom-2\n64 -1 any fast\n") ? 0.0 : 1.0);
+    check("wisdom import engine", 0,
+        ffts_import_wisdom("ffts-wisdom-2\n64 -1 jit static\n") ? 0.0 : 1.0);
+
+    free(buffer);
+    free(wisdom);
+    ffts_forget_wisdom();
+}
+
+static void test_features(void)
+{
+    static const char six_step_wisdom[] =
+        "ffts-wisdom-2\n"
+        "1024 -1 any six-step\n1024 1 any six-step\n"
+        "16384 -1 any six-step\n16384 1 any six-step\n"
+        "65536 -1 any six-step\n65536 1 any six-step\n";
+    /* the complex nd plans transpose blocks of 8, smaller or other sizes
+       are not supported */
+    static const size_t nd_sizes[][3] = {
+        {8, 8, 8}, {16, 8, 32}, {8, 32, 16}, {64, 8, 8}
+    };
+    static const size_t real_2d_sizes[][2] = {
+        {8, 8}, {16, 32}, {64, 4}, {5, 8}, {7, 16}, {128, 64},
+        {6, 12}, {3, 20}, {24, 48}
+    };
+    size_t i, n;
+
+    /* the split step of the forward transform is fused into the
+       generated code of its complex sub-plan */
+    for (n = 4; n <= ((size_t) 1 << 22); n *= 2) {
+        test_real(n, 1.0f);
+    }
+
+    /* and not into that of the chirp-z plan of other sizes */
+    for (n = 12; n <= 100; n += 4) {
+        if (n & (n - 1)) {
+            test_real(n, 1.0f);
+        }
+    }
+
+    test_real(1000, 1.0f);
+    test_real(3000, 1.0f);
+
+    for (i = 0; i < sizeof(real_2d_sizes) / sizeof(real_2d_sizes[0]); i++) {
+        test_2d_real(real_2d_sizes[i][0], real_2d_sizes[i][1], 1.0f);
+    }
+
+    for (n = 32; n <= ((size_t) 1 << 20); n *= 4) {
+        test_background_jit(n, -1);
+        test_background_jit(n, 1);
+    }
+
+    for (n = 2; n <= ((size_t) 1 << 18); n *= 2) {
+        test_flags("code generator", n, -1, FFTS_FLAG_ENGINE_JIT);
+        test_flags("code generator", n, 1, FFTS_FLAG_ENGINE_JIT);
+        test_flags("static engine", n, -1, FFTS_FLAG_ENGINE_STATIC);
+        test_flags("static engine", n, 1, FFTS_FLAG_ENGINE_STATIC);
+    }
+
+    /* the prefetch distance must not change the results, nor read past
+       the input of the last leaves */
+    for (n = 32; n <= ((size_t) 1 << 20); n *= 8) {
+        test_flags("no prefetch", n, -1, FFTS_FLAG_NO_PREFETCH);
+        test_flags("prefetch 1", n, 1, FFTS_FLAG_PREFETCH(1));
+        test_flags("prefetch 255", n, -1, FFTS_FLAG_PREFETCH(255));
+        test_flags("prefetch 255 static engine", n, 1,
+            FFTS_FLAG_PREFETCH(255) | FFTS_FLAG_ENGINE_STATIC);
+    }
+
+    /* non-temporal stores of the last pass, forced on for sizes in cache */
+    for (n = 32; n <= ((size_t) 1 << 20); n *= 8) {
+        test_flags("stream", n, -1, FFTS_FLAG_STREAM);
+        test_flags("stream", n, 1, FFTS_FLAG_STREAM);
+        test_flags("stream static engine", n, -1,
+            FFTS_FLAG_STREAM | FFTS_FLAG_ENGINE_STATIC);
+        test_flags("no stream", n, 1, FFTS_FLAG_NO_STREAM);
+    }
+
+    /* the twiddle factors of the largest passes computed from two small
+       tables, which the flag forces for plans above 65536 points even if
+       their table would fit in the cache */
+    for (n = 32; n <= ((size_t) 1 << 20); n *= 4) {
+        test_flags("computed twiddles", n, -1, FFTS_FLAG_TWIDDLES_COMPUTED);
+        test_flags("computed twiddles", n, 1, FFTS_FLAG_TWIDDLES_COMPUTED);
+        test_flags("twiddle table", n, -1, FFTS_FLAG_TWIDDLES_TABLE);
+    }
+
+    for (n = 64; n <= ((size_t) 1 << 16); n *= 16) {
+        test_shared_tables(n);
+    }
+
+    /* plans for both directions are never split, the largest computes
+       its twiddle factors by default in the build of ffts_test_small_cache */
+    for (n = 2; n <= ((size_t) 1 << 18); n *= 2) {
+        test_both("both directions", n, 0);
+        test_both("both directions static engine", n, FFTS_FLAG_ENGINE_STATIC);
+    }
+
+    /* other plans only run in the direction they were created with */
+    for (n = 16; n <= 4096; n *= 16) {
+        ffts_plan_t *p = ffts_init_1d(n, -1);
+        float *data = test_malloc(2 * n);
+
+        memset(data, 0, 2 * n * sizeof(float));
+        check("one direction", n, p && ffts_execute_dir(p, data, data, 1) ? 0.0 : 1.0);
+
+        test_free(data);
+        ffts_free(p);
+    }
+
+    /* the tables of plans from 2^20 points built on several threads */
+    for (n = (size_t) 1 << 20; n <= ((size_t) 1 << 21); n *= 2) {
+        test_flags("parallel plan", n, -1, FFTS_FLAG_PARALLEL_PLAN);
+        test_flags("parallel plan", n, 1, FFTS_FLAG_PARALLEL_PLAN);
+        test_flags("parallel plan static engine", n, -1,
+            FFTS_FLAG_PARALLEL_PLAN | FFTS_FLAG_ENGINE_STATIC);
+    }
+
+    test_flags("parallel plan chirp-z", 600000, -1, FFTS_FLAG_PARALLEL_PLAN);
+
+    /* plans from 65536 points executed on several threads */
+    for (n = (size_t) 1 << 16; n <= ((size_t) 1 << 20); n *= 4) {
+        test_flags("parallel execute", n, -1, FFTS_FLAG_PARALLEL_EXECUTE);
+        test_flags("parallel execute", n, 1, FFTS_FLAG_PARALLEL_EXECUTE);
+        test_flags("parallel execute computed twiddles", n, -1,
+            FFTS_FLAG_PARALLEL_EXECUTE | FFTS_FLAG_TWIDDLES_COMPUTED);
+        test_both("parallel execute both directions", n,
+            FFTS_FLAG_PARALLEL_EXECUTE);
+    }
+
+    for (n = 2; n <= FFTS_SMALL_MAX_N; n *= 2) {
+        test_small(n, -1);
+        test_small(n, 1);
+    }
+
+    /* other sizes have no straight-line code */
+    check("small", 24, ffts_execute_small(24, -1, NULL, NULL) ? 0.0 : 1.0);
+    check("small", 2 * FFTS_SMALL_MAX_N, ffts_execute_small(
+        2 * FFTS_SMALL_MAX_N, -1, NULL, NULL) ? 0.0 : 1.0);
+
+    /* spectra in the order of the plans, natural unless they are split
+       by the six-step algorithm, as the largest size is on machines with
+       up to 16 MB of cache and from 131072 points in the build of
+       ffts_test_small_cache */
+    for (n = 2; n <= ((size_t) 1 << 22); n *= 2) {
+        test_scrambled("scrambled", n, 0, 0);
+    }
+
+    for (n = 64; n <= ((size_t) 1 << 18); n *= 16) {
+        test_scrambled("scrambled static engine", n, 0, FFTS_FLAG_ENGINE_STATIC);
+        test_scrambled("scrambled both directions", n, 1, 0);
+    }
+
+    test_scrambled("scrambled chirp-z", 12, 0, 0);
+    test_scrambled("scrambled chirp-z", 1000, 0, 0);
+
+    test_wisdom();
+
+    for (n = 2; n <= ((size_t) 1 << 16); n *= 2) {
+        test_callbacks("callbacks", n, -1, 0);
+        test_callbacks("callbacks", n, 1, 0);
+        test_callbacks("callbacks code generator", n, -1, FFTS_FLAG_ENGINE_JIT);
+    }
+
+    /* the scale is folded into the tables, the last pass or the loop
+       over the output of straight-line transforms */
+    for (n = 2; n <= 4096; n *= 2) {
+        test_scale("scale", ffts_init_1d(n, -1), 1, &n, -1);
+        test_scale("scale", ffts_init_1d(n, 1), 1, &n, 1);
+        test_scale("scale code generator",
+            ffts_init_1d_flags(n, -1, FFTS_FLAG_ENGINE_JIT), 1, &n, -1);
+    }
+
+    for (n = 12; n <= 1000; n = 10 * n + 4) {
+        test_scale("scale chirp-z", ffts_init_1d(n, -1), 1, &n, -1);
+        test_scale("scale chirp-z", ffts_init_1d(n, 1), 1, &n, 1);
+    }
+
+    for (i = 0; i < sizeof(nd_sizes) / sizeof(nd_sizes[0]); i++) {
+        test_scale("scale nd", ffts_init_nd(3, (size_t*) nd_sizes[i], -1),
+            3, nd_sizes[i], -1);
+        test_scale("scale nd", ffts_init_nd(3, (size_t*) nd_sizes[i], 1),
+            3, nd_sizes[i], 1);
+    }
+
+    for (n = 4; n <= ((size_t) 1 << 16); n *= 4) {
+        test_real(n, 0.5f);
+    }
+
+    test_real(24, 0.5f);
+    test_real(1000, 0.5f);
+
+    for (i = 0; i < sizeof(real_2d_sizes) / sizeof(real_2d_sizes[0]); i++) {
+        test_2d_real(real_2d_sizes[i][0], real_2d_sizes[i][1], 0.5f);
+    }
+
+    /* six-step plans, which are chosen above the cache size, from wisdom */
+    ffts_import_wisdom(six_step_wisdom);
+
+    for (n = 1024; n <= ((size_t) 1 << 16); n *= 4) {
+        test_flags("six-step", n, -1, FFTS_FLAG_MEASURE);
+        test_flags("six-step", n, 1, FFTS_FLAG_MEASURE);
+        test_callbacks("six-step callbacks", n, -1, FFTS_FLAG_MEASURE);
+        test_callbacks("six-step callbacks", n, 1, FFTS_FLAG_MEASURE);
+    }
+
+    /* the final transpose streamed, the sub-plans never */
+    test_flags("six-step stream", (size_t) 1 << 16, -1,
+        FFTS_FLAG_MEASURE | FFTS_FLAG_STREAM | FFTS_FLAG_PREFETCH(4));
+    test_flags("six-step stream", (size_t) 1 << 16, 1,
+        FFTS_FLAG_MEASURE | FFTS_FLAG_STREAM);
+
+    /* their passes shared by the threads of the pool, which are several
+       in the build of ffts_test_threads */
+    test_flags("six-step parallel execute", (size_t) 1 << 16, -1,
+        FFTS_FLAG_MEASURE | FFTS_FLAG_PARALLEL_EXECUTE);
+    test_flags("six-step parallel execute", (size_t) 1 << 16, 1,
+        FFTS_FLAG_MEASURE | FFTS_FLAG_PARALLEL_EXECUTE);
+
+    for (n = 1024; n <= 4096; n *= 4) {
+        test_scale("six-step scale",
+            ffts_init_1d_flags(n, -1, FFTS_FLAG_MEASURE), 1, &n, -1);
+        test_scale("six-step scale",
+            ffts_init_1d_flags(n, 1, FFTS_FLAG_MEASURE), 1, &n, 1);
+    }
+
+    ffts_forget_wisdom();
+}
+
+/* time the construction of a plan against one execution of it */
+int benchmark_plan(int n)
+{
+    ffts_plan_t *p;
+    clock_t start;
+    double plan_time, execute_time;
+    int i, runs, result = 0;
+
+#ifdef HAVE_SSE
+    float FFTS_ALIGN(32) *input = _mm_malloc(2 * n * sizeof(float), 32);
+    float FFTS_ALIGN(32) *output = _mm_malloc(2 * n * sizeof(float), 32);
+#else
+    float FFTS_ALIGN(32) *input = valloc(2 * n * sizeof(float));
+    float FFTS_ALIGN(32) *output = valloc(2 * n * sizeof(float));
+#endif
+
+    for (i = 0; i < 2 * n; i++) {
+        input[i] = (float) (i % 7) - 3.0f;
+    }
+
+    /* repeat small sizes to get above the clock resolution */
+    runs = (n < (1 << 16)) ? (1 << 16) / n : 1;
+
+    start = clock();
+    for (i = 0; i < runs; i++) {
+        p = ffts_init_1d(n, -1);
+        if (!p) {
+            printf("Plan unsupported\n");
+            goto cleanup;
+        }
+
+        ffts_free(p);
+    }
+    plan_time = 1000.0 * (clock() - start) / CLOCKS_PER_SEC / runs;
+
+    p = ffts_init_1d(n, -1);
+    if (!p) {
+        printf("Plan unsupported\n");
+        goto cleanup;
+    }
+
+    ffts_execute(p, input, output);
+
+    start = clock();
+    for (i = 0; i < runs; i++) {
+        ffts_execute(p, input, output);
+    }
+    execute_time = 1000.0 * (clock() - start) / CLOCKS_PER_SEC / runs;
+
+    ffts_free(p);
+
+    printf(" %9d | %10.4f | %10.4f\n", n, plan_time, execute_time);
+    result = 1;
+
+cleanup:
+#ifdef HAVE_SSE
+    _mm_free(input);
+    _mm_free(output);
+#else
+    free(input);
+    free(output);
+#endif
+    return result;
+}
+
 int main(int argc, char *argv[])
 {
-    if (argc == 3) {
+    if (argc == 2 && !strcmp(argv[1], "plan")) {
+        int n, power2;
+
+        /* plan construction time in milliseconds against the size */
+        printf("      Size |  Plan (ms) | Execute (ms)\n");
+        printf("-----------+------------+-------------\n");
+
+        for (n = 5, power2 = 32; n <= 24; n++, power2 <<= 1) {
+            benchmark_plan(power2);
+        }
+    } else if (argc == 3) {
         ffts_plan_t *p;
         int i;
 
@@ -186,6 +1246,12 @@ int main(int argc, char *argv[])
         for (n = 1, power2 = 2; n <= 18; n++, power2 <<= 1) {
             test_transform(power2, 1);
         }
+
+        /* the features against the reference transforms */
+        test_features();
+
+        printf("\n%d checks, %d failed\n", checks, failures);
+        return failures ? 1 : 0;
     }
 
     return 0;
@@ -0,0 +1,201 @@
+/*
+
+ This file is part of FFTS.
+
+ Copyright (c) 2012, Anthony M. Blake
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 	* Redistributions of source code must retain the above copyright
+ 		notice, this list of conditions and the following disclaimer.
+ 	* Redistributions in binary form must reproduce the above copyright
+ 		notice, this list of conditions and the following disclaimer in the
+ 		documentation and/or other materials provided with the distribution.
+ 	* Neither the name of the organization nor the
+	  names of its contributors may be used to endorse or promote products
+ 		derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL ANTHONY M. BLAKE BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "../include/ffts.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795028841971693993751058209
+#endif
+
+/* relative error of a transform against the reference above which a check
+   fails, as in test.c */
+#define TEST_TOLERANCE 1e-5
+
+static int checks, failures;
+
+static void check(const char *name, std::size_t n, double error)
+{
+    checks++;
+
+    if (!(error <= TEST_TOLERANCE)) {
+        std::printf("FAILED %s, size %lu: error %E\n", name, (unsigned long) n, error);
+        failures++;
+    }
+}
+
+/* n complex values without symmetries, the same for a seed */
+template<std::size_t N>
+static void test_signal(std::array<std::complex<float>, N> &data, unsigned int seed)
+{
+    for (auto &x : data) {
+        float v[2];
+
+        for (auto &r : v) {
+            seed = seed * 1103515245u + 12345u;
+            r = (float) ((seed >> 16) & 0x7fff) / 16384.0f - 1.0f;
+        }
+
+        x = std::complex<float>(v[0], v[1]);
+    }
+}
+
+/* relative L2 error against the transform by its definition */
+template<std::size_t N>
+static double dft_error(const std::array<std::complex<float>, N> &input,
+                        const std::array<std::complex<float>, N> &output,
+                        int sign)
+{
+    double delta_sum = 0.0, sum = 0.0;
+
+    for (std::size_t k = 0; k < N; k++) {
+        std::complex<double> y;
+
+        for (std::size_t j = 0; j < N; j++) {
+            double a = sign * 2 * M_PI * (double) ((j * k) % N) / (double) N;
+
+            y += std::complex<double>(input[j]) *
+                std::complex<double>(std::cos(a), std::sin(a));
+        }
+
+        delta_sum += std::norm(y - std::complex<double>(output[k]));
+        sum += std::norm(y);
+    }
+
+    return std::sqrt(delta_sum) / std::sqrt(sum);
+}
+
+/* a plan of compile-time size against the reference, through each of its
+   execute overloads */
+template<std::size_t N, ffts::direction Direction>
+static void test_plan(const char *name)
+{
+    alignas(32) std::array<std::complex<float>, N> input, output;
+    const int sign = static_cast<int>(Direction);
+    ffts::plan<N, Direction> p;
+    double error;
+
+    test_signal(input, (unsigned int) N);
+
+    p.execute(input, output);
+    error = dft_error(input, output, sign);
+
+    output.fill(0.0f);
+    p(input.data(), output.data());
+    error = std::fmax(error, dft_error(input, output, sign));
+
+#ifdef __cpp_lib_span
+    output.fill(0.0f);
+    p.execute(std::span<const std::complex<float>, N>(input),
+              std::span<std::complex<float>, N>(output));
+    error = std::fmax(error, dft_error(input, output, sign));
+#endif
+
+    check(name, N, error);
+}
+
+/* the plan of an instantiation is created on each thread that uses it */
+static void test_threads()
+{
+    std::vector<std::thread> threads;
+    double errors[4];
+
+    for (std::size_t i = 0; i < 4; i++) {
+        threads.emplace_back([&errors, i] {
+            alignas(32) std::array<std::complex<float>, 1024> input, output;
+
+            test_signal(input, (unsigned int) i);
+            ffts::plan<1024>()(input.data(), output.data());
+            errors[i] = dft_error(input, output, FFTS_FORWARD);
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (double error : errors) {
+        check("threads", 1024, error);
+    }
+}
+
+/* the owner frees its plan once, moving leaves the source empty */
+static void test_unique_plan()
+{
+    alignas(32) std::array<std::complex<float>, 64> input, output;
+    ffts::unique_plan a(ffts_init_1d(64, FFTS_FORWARD));
+    ffts::unique_plan b(std::move(a));
+    double error = 1.0;
+
+    test_signal(input, 64);
+
+    if (!a && b) {
+        b.execute(input.data(), output.data());
+        error = dft_error(input, output, FFTS_FORWARD);
+    }
+
+    a = std::move(b);
+    if (!a || b) {
+        error = 1.0;
+    }
+
+    a.reset();
+    if (a) {
+        error = 1.0;
+    }
+
+    check("unique_plan", 64, error);
+}
+
+int main()
+{
+    /* straight-line code without a plan */
+    test_plan<2, ffts::direction::forward>("small");
+    test_plan<8, ffts::direction::backward>("small");
+    test_plan<64, ffts::direction::forward>("small");
+    test_plan<FFTS_SMALL_MAX_N, ffts::direction::backward>("small");
+
+    /* a shared plan, of a power of two and of another size */
+    test_plan<2 * FFTS_SMALL_MAX_N, ffts::direction::forward>("plan");
+    test_plan<4096, ffts::direction::backward>("plan");
+    test_plan<1000, ffts::direction::forward>("plan chirp-z");
+    test_plan<12, ffts::direction::backward>("plan chirp-z");
+
+    test_threads();
+    test_unique_plan();
+
+    std::printf("%d checks, %d failed\n", checks, failures);
+    return failures ? 1 : 0;
+}